@@ -0,0 +1,211 @@
+// HaloMCC_AsyncLog.cpp
+#include "HaloMCC_AsyncLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+AsyncLogger& AsyncLogger::Get() {
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger() {
+    for (size_t i = 0; i < Capacity; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+AsyncLogger::~AsyncLogger() {
+    // Al descargarse el proceso no se puede esperar al hilo (loader lock): se suelta. Lo
+    // normal es que antes se haya llamado a Stop (Cleanup del mod)
+    if (writer.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        writer.detach();
+    }
+}
+
+uint16_t AsyncLogger::OpenChannel(const char* path, const char* debugPrefix) {
+    std::lock_guard<std::mutex> lock(channelMutex);
+
+    const size_t count = channelCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        if (channels[i].path == path) return static_cast<uint16_t>(i);
+    }
+    if (count >= MaxChannels) return InvalidChannel;
+
+    Channel& channel = channels[count];
+    channel.path = path;
+    channel.debug = debugPrefix != nullptr;
+    if (debugPrefix) channel.debugPrefix = debugPrefix;
+    channelCount.store(count + 1, std::memory_order_release);
+    return static_cast<uint16_t>(count);
+}
+
+void AsyncLogger::SetDebugSink(DebugSink sink, void* context) {
+    std::lock_guard<std::mutex> lock(channelMutex);
+    debugSink = sink;
+    debugContext = context;
+}
+
+uint64_t AsyncLogger::GetDroppedCount() const {
+    uint64_t dropped = 0;
+    for (const Channel& channel : channels) dropped += channel.dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
+
+// ============================================================================
+// Camino caliente
+// ============================================================================
+
+bool AsyncLogger::Log(uint16_t channel, const char* text, size_t length) {
+    if (channel >= channelCount.load(std::memory_order_acquire)) return false;
+    EnsureWriter();
+
+    // Cola acotada de varios productores: cada celda lleva su número de secuencia, así que
+    // reservar un hueco es un CAS sobre enqueuePos y publicarlo una store
+    uint64_t position = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;) {
+        cell = &cells[position & (Capacity - 1)];
+        const uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const int64_t difference = static_cast<int64_t>(sequence - position);
+        if (difference == 0) {
+            if (enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        }
+        else if (difference < 0) {
+            // Llena: el escritor va por detrás una vuelta entera
+            channels[channel].dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else {
+            position = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    Record& record = cell->record;
+    record.time = static_cast<int64_t>(std::time(nullptr));
+    record.channel = channel;
+    record.length = static_cast<uint16_t>(std::min(length, MaxText));
+    memcpy(record.text, text, record.length);
+    if (length > MaxText) memcpy(record.text + MaxText - 3, "...", 3);
+
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+// ============================================================================
+// Hilo escritor
+// ============================================================================
+
+void AsyncLogger::EnsureWriter() {
+    if (running.load(std::memory_order_acquire)) return;
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    if (running.load(std::memory_order_relaxed)) return;
+
+    stopping.store(false, std::memory_order_relaxed);
+    writer = std::thread([this]() { WriterLoop(); });
+    running.store(true, std::memory_order_release);
+}
+
+void AsyncLogger::Stop() {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    if (!running.load(std::memory_order_relaxed)) return;
+
+    stopping.store(true, std::memory_order_release);
+    if (writer.joinable()) writer.join();
+    running.store(false, std::memory_order_release);
+}
+
+void AsyncLogger::WriterLoop() {
+    for (;;) {
+        // Se mira antes de vaciar: lo encolado antes de Stop siempre se escribe
+        const bool last = stopping.load(std::memory_order_acquire);
+        const size_t count = Drain();
+        WriteBatches();
+
+        if (!count) {
+            if (last) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+const char* AsyncLogger::FormatTime(int64_t time) {
+    if (time != formattedTime) {
+        const time_t value = static_cast<time_t>(time);
+        struct tm timeInfo = {};
+#ifdef _WIN32
+        localtime_s(&timeInfo, &value);
+#else
+        localtime_r(&value, &timeInfo);
+#endif
+        strftime(formatted, sizeof(formatted), "%Y-%m-%d %H:%M:%S", &timeInfo);
+        formattedTime = time;
+    }
+    return formatted;
+}
+
+size_t AsyncLogger::Drain() {
+    DebugSink sink = nullptr;
+    void* sinkContext = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(channelMutex);
+        sink = debugSink;
+        sinkContext = debugContext;
+    }
+
+    std::string debugLine;
+    size_t count = 0;
+    // Como mucho una vuelta por lote, para que con productores sin parar también se escriba
+    while (count < Capacity) {
+        Cell& cell = cells[dequeuePos & (Capacity - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) break;
+
+        const Record& record = cell.record;
+        Channel& channel = channels[record.channel];
+        channel.batch += '[';
+        channel.batch += FormatTime(record.time);
+        channel.batch += "] ";
+        channel.batch.append(record.text, record.length);
+        channel.batch += '\n';
+
+        if (channel.debug && sink) {
+            debugLine.assign(channel.debugPrefix);
+            debugLine.append(record.text, record.length);
+            debugLine += '\n';
+            sink(sinkContext, debugLine.c_str());
+        }
+
+        cell.sequence.store(dequeuePos + Capacity, std::memory_order_release);
+        ++dequeuePos;
+        ++count;
+    }
+    return count;
+}
+
+void AsyncLogger::WriteBatches() {
+    const size_t count = channelCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        Channel& channel = channels[i];
+
+        const uint64_t dropped = channel.dropped.load(std::memory_order_relaxed);
+        if (dropped != channel.reported) {
+            channel.batch += '[';
+            channel.batch += FormatTime(static_cast<int64_t>(std::time(nullptr)));
+            channel.batch += "] ⚠ Log: " + std::to_string(dropped - channel.reported) + " mensajes descartados (cola llena)\n";
+            channel.reported = dropped;
+        }
+        if (channel.batch.empty()) continue;
+
+        if (!channel.file.is_open()) {
+            channel.file.open(channel.path, std::ios::out | std::ios::app);
+        }
+        if (channel.file.is_open()) {
+            channel.file.write(channel.batch.data(), static_cast<std::streamsize>(channel.batch.size()));
+            channel.file.flush();
+        }
+        channel.batch.clear();
+    }
+}
@@ -0,0 +1,101 @@
+// HaloMCC_AsyncLog.h
+// Log asíncrono: quien loguea (Present incluido) solo copia el mensaje a una cola circular de
+// registros fijos y avanza un índice; un hilo aparte pone la fecha, escribe por lotes (una
+// escritura y un flush por fichero y lote) y llama al sink de depuración (OutputDebugString en
+// el DLL). Si la cola está llena el mensaje se descarta y se cuenta; el hilo escritor deja una
+// línea con los descartados en el mismo fichero.
+// Sin windows.h.
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class AsyncLogger {
+public:
+    static constexpr size_t Capacity = 1024;            // registros en la cola (potencia de 2)
+    static constexpr size_t MaxText = 480;              // más largo se corta
+    static constexpr size_t MaxChannels = 4;
+    static constexpr uint16_t InvalidChannel = 0xFFFF;
+
+    // Llamado desde el hilo escritor con la línea ya formateada (prefijo + mensaje + \n)
+    typedef void (*DebugSink)(void* context, const char* line);
+
+    // Un logger para todo el proceso (el mod y el scanner comparten cola e hilo)
+    static AsyncLogger& Get();
+
+    ~AsyncLogger();
+
+    // Fichero de log (en modo append). La misma ruta devuelve el mismo canal; InvalidChannel si
+    // no quedan. 'debugPrefix' != nullptr => cada línea va también al sink
+    uint16_t OpenChannel(const char* path, const char* debugPrefix = nullptr);
+    void SetDebugSink(DebugSink sink, void* context);
+
+    // Camino caliente: copia y avanza. false si se descartó (cola llena o canal no válido).
+    // El hilo escritor arranca con el primer mensaje
+    bool Log(uint16_t channel, const char* text, size_t length);
+    bool Log(uint16_t channel, const std::string& message) { return Log(channel, message.data(), message.size()); }
+
+    // Escribe todo lo encolado y para el hilo (el siguiente Log lo vuelve a arrancar)
+    void Stop();
+
+    uint64_t GetDroppedCount() const;
+
+private:
+    struct Record {
+        int64_t time;               // time_t
+        uint16_t channel;
+        uint16_t length;
+        char text[MaxText];
+    };
+
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> sequence;
+        Record record;
+    };
+
+    struct Channel {
+        std::string path;
+        std::string debugPrefix;
+        bool debug = false;
+        std::ofstream file;                         // solo el hilo escritor
+        std::string batch;                          // solo el hilo escritor
+        std::atomic<uint64_t> dropped{ 0 };
+        uint64_t reported = 0;                      // solo el hilo escritor
+    };
+
+    AsyncLogger();
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    void EnsureWriter();
+    void WriterLoop();
+    // Pasa a los lotes todo lo que haya en la cola; devuelve los registros leídos
+    size_t Drain();
+    void WriteBatches();
+    // Fecha de 'time'; se rehace solo cuando cambia el segundo
+    const char* FormatTime(int64_t time);
+
+    std::array<Cell, Capacity> cells;
+    alignas(64) std::atomic<uint64_t> enqueuePos{ 0 };
+    alignas(64) uint64_t dequeuePos = 0;            // solo el hilo escritor
+
+    std::array<Channel, MaxChannels> channels;
+    std::atomic<size_t> channelCount{ 0 };
+    std::mutex channelMutex;                        // alta de canales y sink
+
+    DebugSink debugSink = nullptr;
+    void* debugContext = nullptr;
+
+    std::mutex writerMutex;                         // arranque/parada del hilo
+    std::thread writer;
+    std::atomic<bool> running{ false };
+    std::atomic<bool> stopping{ false };
+
+    int64_t formattedTime = -1;                     // caché de la fecha (cambia una vez por segundo)
+    char formatted[32] = {};
+};
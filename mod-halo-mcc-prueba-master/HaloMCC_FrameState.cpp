@@ -0,0 +1,53 @@
+// HaloMCC_FrameState.cpp
+#include "HaloMCC_FrameState.h"
+#include <chrono>
+
+void FrameStateSampler::SetReader(ProcessReadFunction function, void* context) {
+    read = function;
+    readContext = context;
+}
+
+FrameState FrameStateSampler::Sample(uint64_t frame, const FrameStateAddresses& addresses) {
+    FrameState state = Read(frame, addresses);
+    state.sequence = published.GetVersion() + 1;
+    if (!published.TryStore(state)) state.sequence = 0;
+    return state;
+}
+
+FrameState FrameStateSampler::Read(uint64_t frame, const FrameStateAddresses& addresses) const {
+    FrameState state;
+    state.frame = frame;
+    state.valid = addresses.valid;
+    state.cameraBase = addresses.cameraBase;
+
+    if (read) {
+        for (uint32_t field = 0; field < FRAME_FIELD_COUNT; ++field) {
+            if (!addresses.fields[field]) continue;
+
+            int32_t value = 0;
+            if (read(readContext, addresses.fields[field], &value, sizeof(value))) {
+                state.values[field] = value;
+                state.readMask |= 1u << field;
+            }
+        }
+    }
+
+    state.sampledAt = Now();
+    return state;
+}
+
+FrameState FrameStateSampler::Get() const {
+    FrameState state;
+    published.Load(state);
+    return state;
+}
+
+int64_t FrameStateSampler::Now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t FrameStateSampler::GetAgeMs(const FrameState& state) {
+    if (!state.sampledAt) return INT64_MAX;
+    return (Now() - state.sampledAt) / 1000;
+}
@@ -0,0 +1,69 @@
+// HaloMCC_FrameState.h
+// Estado del juego leído una vez por frame (Present) y publicado con número de secuencia.
+// El render, los hotkeys y los exports leen esta copia en vez de ir a la memoria del juego
+// cada uno por su cuenta.
+// Sin windows.h: la lectura la pone quien llama (bajo SEH en el DLL).
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "HaloMCC_ProcessMemory.h"
+#include "HaloMCC_SeqLock.h"
+
+// Campos enteros de GameOffsets que se muestrean (los de cámara son relativos a cameraBase
+// y son destino de escrituras, no estado)
+enum FrameField : uint32_t {
+    FRAME_PLAYER_COUNT = 0,
+    FRAME_MAX_PLAYERS,
+    FRAME_LOCAL_PLAYERS,
+    FRAME_SPLIT_SCREEN_ENABLED,
+    FRAME_COOP_MODE,
+    FRAME_MENU_STATE,
+    FRAME_GAME_STATE,
+    FRAME_FIELD_COUNT
+};
+
+struct alignas(64) FrameState {
+    uint64_t sequence = 0;              // publicación de la que viene (0 = no publicada)
+    uint64_t frame = 0;                 // frameCounter del Present que la tomó
+    int64_t sampledAt = 0;              // FrameStateSampler::Now() (0 = nunca se muestreó)
+    uintptr_t cameraBase = 0;           // dirección ya resuelta (0 = no hay)
+    uint32_t readMask = 0;              // bit FrameField => valor leído
+    int32_t values[FRAME_FIELD_COUNT] = {};
+    bool valid = false;                 // gameOffsets.valid al muestrear
+
+    bool Has(FrameField field) const { return (readMask >> field) & 1; }
+    int32_t Get(FrameField field, int32_t fallback) const { return Has(field) ? values[field] : fallback; }
+};
+
+// Direcciones absolutas de cada campo para un muestreo (0 = el campo no está)
+struct FrameStateAddresses {
+    uintptr_t fields[FRAME_FIELD_COUNT] = {};
+    uintptr_t cameraBase = 0;
+    bool valid = false;
+};
+
+class FrameStateSampler {
+public:
+    // Antes del primer Sample/Read (no se cambia con Present en marcha)
+    void SetReader(ProcessReadFunction function, void* context);
+
+    // Lee todos los campos y publica. Solo desde Present: no toma locks, y si otro Sample
+    // estuviera publicando a la vez este valor se devuelve pero no se publica
+    FrameState Sample(uint64_t frame, const FrameStateAddresses& addresses);
+    // Lectura privada para quien no puede esperar al siguiente Present (no hay Present, o
+    // acaba de escribir): mismos campos, sin publicar ni tocar lo de Present
+    FrameState Read(uint64_t frame, const FrameStateAddresses& addresses) const;
+
+    // Última publicación; sin bloqueo desde cualquier hilo
+    FrameState Get() const;
+    uint64_t GetSequence() const { return published.GetVersion(); }
+
+    // Reloj monótono en microsegundos para sampledAt
+    static int64_t Now();
+    static int64_t GetAgeMs(const FrameState& state);
+
+private:
+    SeqLock<FrameState> published;
+    ProcessReadFunction read = nullptr;
+    void* readContext = nullptr;
+};
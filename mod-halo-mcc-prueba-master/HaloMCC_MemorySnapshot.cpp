@@ -0,0 +1,424 @@
+// HaloMCC_MemorySnapshot.cpp
+#include "HaloMCC_MemorySnapshot.h"
+#include "HaloMCC_ThreadPool.h"
+#include <atomic>
+#include <bitset>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define HALO_SNAPSHOT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Lecturas de candidatos dispersos: los cercanos se agrupan en una sola lectura
+const size_t SparseReadWindow = 64 * 1024;
+
+uint32_t LoadValue(const uint8_t* data, SnapshotValueType type) {
+    if (type == SnapshotValueType::U8) return data[0];
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+float BitsToFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Un slot. CHANGED/UNCHANGED comparan bits (un NaN que no cambia no "cambia")
+bool TestSlot(SnapshotValueType type, SnapshotPredicate predicate, uint32_t previous, uint32_t current, uint32_t value) {
+    switch (predicate) {
+    case SnapshotPredicate::CHANGED: return current != previous;
+    case SnapshotPredicate::UNCHANGED: return current == previous;
+    case SnapshotPredicate::EQUALS:
+        return type == SnapshotValueType::F32 ? BitsToFloat(current) == BitsToFloat(value) : current == value;
+    case SnapshotPredicate::INCREASED:
+    case SnapshotPredicate::DECREASED: {
+        bool increased = false;
+        bool decreased = false;
+        if (type == SnapshotValueType::F32) {
+            increased = BitsToFloat(current) > BitsToFloat(previous);
+            decreased = BitsToFloat(current) < BitsToFloat(previous);
+        }
+        else if (type == SnapshotValueType::I32) {
+            increased = static_cast<int32_t>(current) > static_cast<int32_t>(previous);
+            decreased = static_cast<int32_t>(current) < static_cast<int32_t>(previous);
+        }
+        else {
+            increased = current > previous;
+            decreased = current < previous;
+        }
+        return predicate == SnapshotPredicate::INCREASED ? increased : decreased;
+    }
+    }
+    return false;
+}
+
+uint64_t CompareSlotsScalar(const uint8_t* previous, const uint8_t* current, size_t slots, SnapshotValueType type,
+                            SnapshotPredicate predicate, uint32_t value) {
+    const size_t valueSize = MemorySnapshot::GetValueSize(type);
+    uint64_t mask = 0;
+    for (size_t slot = 0; slot < slots; ++slot) {
+        const uint32_t before = LoadValue(previous + slot * valueSize, type);
+        const uint32_t now = LoadValue(current + slot * valueSize, type);
+        if (TestSlot(type, predicate, before, now, value)) mask |= 1ull << slot;
+    }
+    return mask;
+}
+
+#if defined(HALO_SNAPSHOT_SSE2)
+// 64 slots por llamada = una palabra del bitmap. Cada kernel devuelve el bit de cada slot
+// que cumple el predicado; las versiones "no cumple" se invierten al final
+inline __m128i Load(const uint8_t* data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+uint64_t CompareI32x64(const uint8_t* previous, const uint8_t* current, SnapshotPredicate predicate, uint32_t value) {
+    const __m128i constant = _mm_set1_epi32(static_cast<int>(value));
+    uint64_t mask = 0;
+    for (unsigned v = 0; v < 16; ++v) {
+        const __m128i before = Load(previous + v * 16);
+        const __m128i now = Load(current + v * 16);
+        __m128i hit;
+        switch (predicate) {
+        case SnapshotPredicate::CHANGED:
+        case SnapshotPredicate::UNCHANGED: hit = _mm_cmpeq_epi32(now, before); break;
+        case SnapshotPredicate::INCREASED: hit = _mm_cmpgt_epi32(now, before); break;
+        case SnapshotPredicate::DECREASED: hit = _mm_cmpgt_epi32(before, now); break;
+        default:                           hit = _mm_cmpeq_epi32(now, constant); break;
+        }
+        mask |= static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(hit))) << (v * 4);
+    }
+    return predicate == SnapshotPredicate::CHANGED ? ~mask : mask;
+}
+
+uint64_t CompareF32x64(const uint8_t* previous, const uint8_t* current, SnapshotPredicate predicate, uint32_t value) {
+    const __m128 constant = _mm_set1_ps(BitsToFloat(value));
+    uint64_t mask = 0;
+    for (unsigned v = 0; v < 16; ++v) {
+        const __m128i beforeBits = Load(previous + v * 16);
+        const __m128i nowBits = Load(current + v * 16);
+        const __m128 before = _mm_castsi128_ps(beforeBits);
+        const __m128 now = _mm_castsi128_ps(nowBits);
+        __m128 hit;
+        switch (predicate) {
+        case SnapshotPredicate::CHANGED:
+        case SnapshotPredicate::UNCHANGED: hit = _mm_castsi128_ps(_mm_cmpeq_epi32(nowBits, beforeBits)); break;
+        case SnapshotPredicate::INCREASED: hit = _mm_cmpgt_ps(now, before); break;
+        case SnapshotPredicate::DECREASED: hit = _mm_cmplt_ps(now, before); break;
+        default:                           hit = _mm_cmpeq_ps(now, constant); break;
+        }
+        mask |= static_cast<uint64_t>(_mm_movemask_ps(hit)) << (v * 4);
+    }
+    return predicate == SnapshotPredicate::CHANGED ? ~mask : mask;
+}
+
+uint64_t CompareU8x64(const uint8_t* previous, const uint8_t* current, SnapshotPredicate predicate, uint32_t value) {
+    const __m128i constant = _mm_set1_epi8(static_cast<char>(value));
+    uint64_t mask = 0;
+    for (unsigned v = 0; v < 4; ++v) {
+        const __m128i before = Load(previous + v * 16);
+        const __m128i now = Load(current + v * 16);
+        __m128i hit;
+        switch (predicate) {
+        case SnapshotPredicate::CHANGED:
+        case SnapshotPredicate::UNCHANGED: hit = _mm_cmpeq_epi8(now, before); break;
+        // Sin comparación unsigned en SSE2: max(a, b) == a <=> a >= b (se invierte abajo)
+        case SnapshotPredicate::INCREASED: hit = _mm_cmpeq_epi8(_mm_max_epu8(now, before), before); break;
+        case SnapshotPredicate::DECREASED: hit = _mm_cmpeq_epi8(_mm_max_epu8(now, before), now); break;
+        default:                           hit = _mm_cmpeq_epi8(now, constant); break;
+        }
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hit))) << (v * 16);
+    }
+    const bool inverted = predicate == SnapshotPredicate::CHANGED || predicate == SnapshotPredicate::INCREASED ||
+        predicate == SnapshotPredicate::DECREASED;
+    return inverted ? ~mask : mask;
+}
+#endif
+
+uint64_t CompareSlots(const uint8_t* previous, const uint8_t* current, size_t slots, SnapshotValueType type,
+                      SnapshotPredicate predicate, uint32_t value) {
+#if defined(HALO_SNAPSHOT_SSE2)
+    if (slots == 64) {
+        switch (type) {
+        case SnapshotValueType::I32: return CompareI32x64(previous, current, predicate, value);
+        case SnapshotValueType::F32: return CompareF32x64(previous, current, predicate, value);
+        default:                     return CompareU8x64(previous, current, predicate, value);
+        }
+    }
+#endif
+    return CompareSlotsScalar(previous, current, slots, type, predicate, value);
+}
+
+size_t CountBits(uint64_t word) {
+    return std::bitset<64>(word).count();
+}
+
+} // namespace
+
+// ============================================================================
+// Estado
+// ============================================================================
+
+size_t MemorySnapshot::GetValueSize(SnapshotValueType type) {
+    return type == SnapshotValueType::U8 ? 1 : 4;
+}
+
+const char* MemorySnapshot::PredicateToString(SnapshotPredicate predicate) {
+    switch (predicate) {
+    case SnapshotPredicate::CHANGED: return "cambió";
+    case SnapshotPredicate::UNCHANGED: return "no cambió";
+    case SnapshotPredicate::INCREASED: return "aumentó";
+    case SnapshotPredicate::DECREASED: return "disminuyó";
+    case SnapshotPredicate::EQUALS: return "igual a";
+    }
+    return "?";
+}
+
+size_t MemorySnapshot::Block::GetMemoryUsage() const {
+    return bitmap.capacity() * sizeof(uint64_t) + values.capacity() + offsets.capacity() * sizeof(uint32_t);
+}
+
+void MemorySnapshot::Clear() {
+    blocks.clear();
+    blocks.shrink_to_fit();
+    read = nullptr;
+    context = nullptr;
+    active = false;
+}
+
+size_t MemorySnapshot::GetCandidateCount() const {
+    size_t count = 0;
+    for (const Block& block : blocks) count += block.count;
+    return count;
+}
+
+size_t MemorySnapshot::GetMemoryUsage() const {
+    size_t usage = blocks.capacity() * sizeof(Block);
+    for (const Block& block : blocks) usage += block.GetMemoryUsage();
+    return usage;
+}
+
+void MemorySnapshot::GetCandidates(size_t maxResults, std::vector<SnapshotCandidate>& results) const {
+    results.clear();
+    const size_t valueSize = GetValueSize(valueType);
+
+    for (const Block& block : blocks) {
+        if (block.sparse) {
+            for (size_t i = 0; i < block.offsets.size() && results.size() < maxResults; ++i) {
+                SnapshotCandidate candidate;
+                candidate.address = block.base + block.offsets[i];
+                candidate.value = LoadValue(block.values.data() + i * valueSize, valueType);
+                results.push_back(candidate);
+            }
+        }
+        else {
+            for (size_t word = 0; word < block.bitmap.size() && results.size() < maxResults; ++word) {
+                for (uint64_t bits = block.bitmap[word]; bits && results.size() < maxResults; bits &= bits - 1) {
+                    const size_t slot = word * 64 + CountBits((bits & (0 - bits)) - 1);
+                    SnapshotCandidate candidate;
+                    candidate.address = block.base + slot * valueSize;
+                    candidate.value = LoadValue(block.values.data() + slot * valueSize, valueType);
+                    results.push_back(candidate);
+                }
+            }
+        }
+        if (results.size() >= maxResults) return;
+    }
+}
+
+// ============================================================================
+// Búsquedas
+// ============================================================================
+
+bool MemorySnapshot::Start(const std::vector<SnapshotRange>& ranges, SnapshotValueType type, SnapshotReadFunction readFunction,
+                           void* readContext, ScanThreadPool* pool) {
+    Clear();
+    if (!readFunction) return false;
+
+    // Valor desconocido = copia de todo: se comprueba antes de leer nada
+    const size_t valueSize = GetValueSize(type);
+    size_t required = 0;
+    for (const SnapshotRange& range : ranges) required += range.size + range.size / (8 * valueSize);
+    if (required > memoryBudget) return false;
+
+    valueType = type;
+    read = readFunction;
+    context = readContext;
+    return Run(&ranges, SnapshotPredicate::UNCHANGED, true, 0, pool);
+}
+
+bool MemorySnapshot::StartEquals(const std::vector<SnapshotRange>& ranges, SnapshotValueType type, uint32_t value,
+                                 SnapshotReadFunction readFunction, void* readContext, ScanThreadPool* pool) {
+    Clear();
+    if (!readFunction) return false;
+
+    valueType = type;
+    read = readFunction;
+    context = readContext;
+    return Run(&ranges, SnapshotPredicate::EQUALS, false, value, pool);
+}
+
+bool MemorySnapshot::Filter(SnapshotPredicate predicate, uint32_t value, ScanThreadPool* pool) {
+    if (!active) return false;
+    return Run(nullptr, predicate, false, value, pool);
+}
+
+bool MemorySnapshot::Run(const std::vector<SnapshotRange>* ranges, SnapshotPredicate predicate, bool keepAll, uint32_t value,
+                         ScanThreadPool* pool) {
+    if (ranges) {
+        const size_t valueSize = GetValueSize(valueType);
+        for (const SnapshotRange& range : *ranges) {
+            for (size_t offset = 0; offset < range.size; offset += BlockSize) {
+                Block block;
+                block.base = range.base + offset;
+                block.size = range.size - offset < BlockSize ? range.size - offset : BlockSize;
+                block.size -= block.size % valueSize;
+                if (block.size) blocks.push_back(block);
+            }
+        }
+    }
+
+    // Cada bloque es independiente; la memoria se cuenta según acaban y al pasarse del
+    // presupuesto el resto ni se lee
+    std::atomic<size_t> usage{ 0 };
+    std::atomic<bool> overBudget{ false };
+    auto processBlock = [&](size_t index) {
+        if (overBudget.load(std::memory_order_relaxed)) return;
+
+        Block& block = blocks[index];
+        if (block.sparse) {
+            FilterSparse(block, predicate, value);
+        }
+        else {
+            FilterDense(block, predicate, keepAll, value);
+            Compact(block);
+        }
+
+        if (usage.fetch_add(block.GetMemoryUsage(), std::memory_order_relaxed) + block.GetMemoryUsage() > memoryBudget) {
+            overBudget.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    if (pool) {
+        pool->ParallelFor(blocks.size(), processBlock);
+    }
+    else {
+        for (size_t index = 0; index < blocks.size(); ++index) processBlock(index);
+    }
+
+    if (overBudget.load()) {
+        Clear();
+        return false;
+    }
+
+    active = true;
+    return true;
+}
+
+bool MemorySnapshot::FilterDense(Block& block, SnapshotPredicate predicate, bool keepAll, uint32_t value) const {
+    const size_t valueSize = GetValueSize(valueType);
+    const size_t slots = block.size / valueSize;
+    const size_t words = (slots + 63) / 64;
+
+    std::vector<uint8_t> current(block.size);
+    if (!read(context, block.base, current.data(), block.size)) {
+        // Región liberada o protegida desde la última lectura: sus candidatos se pierden
+        block.count = 0;
+        block.sparse = true;
+        std::vector<uint64_t>().swap(block.bitmap);
+        std::vector<uint8_t>().swap(block.values);
+        std::vector<uint32_t>().swap(block.offsets);
+        return false;
+    }
+
+    // Bloque recién creado: todos los slots vivos y sin lectura anterior (solo vale EQUALS)
+    const bool fresh = block.values.empty();
+    if (fresh) {
+        block.bitmap.assign(words, ~0ull);
+        if (slots % 64) block.bitmap.back() = (1ull << (slots % 64)) - 1;
+    }
+
+    const uint8_t* previous = fresh ? current.data() : block.values.data();
+    block.count = 0;
+    for (size_t word = 0; word < words; ++word) {
+        uint64_t& bits = block.bitmap[word];
+        if (bits && !keepAll) {
+            const size_t first = word * 64;
+            const size_t count = slots - first < 64 ? slots - first : 64;
+            bits &= CompareSlots(previous + first * valueSize, current.data() + first * valueSize, count, valueType,
+                predicate, value);
+        }
+        block.count += CountBits(bits);
+    }
+
+    block.values.swap(current);
+    return true;
+}
+
+bool MemorySnapshot::FilterSparse(Block& block, SnapshotPredicate predicate, uint32_t value) const {
+    const size_t valueSize = GetValueSize(valueType);
+    std::vector<uint8_t> window;
+
+    size_t kept = 0;
+    size_t i = 0;
+    while (i < block.offsets.size()) {
+        // Candidatos cercanos: una lectura para todos
+        const uint32_t windowStart = block.offsets[i];
+        size_t end = i + 1;
+        while (end < block.offsets.size() && block.offsets[end] + valueSize - windowStart <= SparseReadWindow) ++end;
+
+        const size_t windowSize = block.offsets[end - 1] + valueSize - windowStart;
+        window.resize(windowSize);
+        const bool readable = read(context, block.base + windowStart, window.data(), windowSize);
+
+        for (; i < end; ++i) {
+            if (!readable) continue;
+
+            const uint8_t* now = window.data() + (block.offsets[i] - windowStart);
+            const uint32_t before = LoadValue(block.values.data() + i * valueSize, valueType);
+            if (!TestSlot(valueType, predicate, before, LoadValue(now, valueType), value)) continue;
+
+            block.offsets[kept] = block.offsets[i];
+            std::memcpy(block.values.data() + kept * valueSize, now, valueSize);
+            kept++;
+        }
+    }
+
+    block.offsets.resize(kept);
+    block.values.resize(kept * valueSize);
+    block.count = kept;
+    // El presupuesto cuenta capacidad: devolverla cuando el filtro deja menos de la mitad
+    if (kept * 2 < block.offsets.capacity()) {
+        block.offsets.shrink_to_fit();
+        block.values.shrink_to_fit();
+    }
+    return true;
+}
+
+void MemorySnapshot::Compact(Block& block) const {
+    const size_t valueSize = GetValueSize(valueType);
+    if (block.sparse || block.count * (sizeof(uint32_t) + valueSize) >= block.GetMemoryUsage()) return;
+
+    std::vector<uint32_t> offsets;
+    std::vector<uint8_t> values;
+    offsets.reserve(block.count);
+    values.reserve(block.count * valueSize);
+
+    for (size_t word = 0; word < block.bitmap.size(); ++word) {
+        for (uint64_t bits = block.bitmap[word]; bits; bits &= bits - 1) {
+            const size_t slot = word * 64 + CountBits((bits & (0 - bits)) - 1);
+            offsets.push_back(static_cast<uint32_t>(slot * valueSize));
+            values.insert(values.end(), block.values.begin() + slot * valueSize,
+                block.values.begin() + (slot + 1) * valueSize);
+        }
+    }
+
+    block.sparse = true;
+    block.offsets.swap(offsets);
+    block.values.swap(values);
+    std::vector<uint64_t>().swap(block.bitmap);
+}
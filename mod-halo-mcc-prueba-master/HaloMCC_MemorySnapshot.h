@@ -0,0 +1,99 @@
+// HaloMCC_MemorySnapshot.h
+// Búsqueda de valores en memoria al estilo "first scan / next scan": una foto de las regiones
+// escribibles y filtros sucesivos (cambió, no cambió, igual a N...) hasta que quedan pocas
+// direcciones, p.ej. el número de jugadores o el flag de split-screen de un build sin firmas.
+// Sin windows.h: las regiones y la lectura las pone quien llama (bajo SEH en el DLL).
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class ScanThreadPool;
+
+enum class SnapshotValueType : uint32_t {
+    U8,
+    I32,
+    F32
+};
+
+enum class SnapshotPredicate : uint32_t {
+    CHANGED,
+    UNCHANGED,
+    INCREASED,
+    DECREASED,
+    EQUALS              // igual a 'value' (bits del valor; U8 en el byte bajo)
+};
+
+struct SnapshotRange {
+    uintptr_t base = 0;
+    size_t size = 0;
+};
+
+struct SnapshotCandidate {
+    uintptr_t address = 0;
+    uint32_t value = 0;                 // bits del último valor leído
+};
+
+// Copia [address, address + size) en buffer; false si no se puede leer entero
+typedef bool (*SnapshotReadFunction)(void* context, uintptr_t address, void* buffer, size_t size);
+
+class MemorySnapshot {
+public:
+    static const size_t DefaultMemoryBudget = 1024u * 1024u * 1024u;
+    // Las regiones se trocean en bloques de este tamaño: unidad de trabajo de los workers y
+    // de la elección entre bitmap y lista
+    static const size_t BlockSize = 1024 * 1024;
+
+    void Clear();
+    // Tope de memoria para los candidatos (bitmaps + valores guardados)
+    void SetMemoryBudget(size_t bytes) { memoryBudget = bytes; }
+
+    // Primera búsqueda con valor desconocido: guarda todos los valores alineados de las
+    // regiones. false si no caben en el presupuesto (empezar entonces con StartEquals)
+    bool Start(const std::vector<SnapshotRange>& ranges, SnapshotValueType type, SnapshotReadFunction read,
+               void* context, ScanThreadPool* pool = nullptr);
+    // Primera búsqueda con valor conocido: solo quedan las direcciones que valen 'value'
+    bool StartEquals(const std::vector<SnapshotRange>& ranges, SnapshotValueType type, uint32_t value,
+                     SnapshotReadFunction read, void* context, ScanThreadPool* pool = nullptr);
+    // Siguiente búsqueda: vuelve a leer los candidatos y se queda con los que cumplen el
+    // predicado respecto a la lectura anterior ('value' solo para EQUALS)
+    bool Filter(SnapshotPredicate predicate, uint32_t value, ScanThreadPool* pool = nullptr);
+
+    bool IsActive() const { return active; }
+    SnapshotValueType GetValueType() const { return valueType; }
+    size_t GetCandidateCount() const;
+    size_t GetMemoryUsage() const;
+    // Los primeros maxResults candidatos, en orden de dirección
+    void GetCandidates(size_t maxResults, std::vector<SnapshotCandidate>& results) const;
+
+    static size_t GetValueSize(SnapshotValueType type);
+    static const char* PredicateToString(SnapshotPredicate predicate);
+
+private:
+    // Un bloque de como mucho BlockSize bytes. Denso: un bit por slot alineado y copia de todo
+    // el bloque. Disperso (cuando ocupa menos): offsets de los slots vivos y solo sus valores
+    struct Block {
+        uintptr_t base = 0;
+        size_t size = 0;
+        size_t count = 0;
+        bool sparse = false;
+        std::vector<uint64_t> bitmap;
+        std::vector<uint8_t> values;
+        std::vector<uint32_t> offsets;
+
+        size_t GetMemoryUsage() const;
+    };
+
+    bool Run(const std::vector<SnapshotRange>* ranges, SnapshotPredicate predicate, bool keepAll, uint32_t value,
+             ScanThreadPool* pool);
+    bool FilterDense(Block& block, SnapshotPredicate predicate, bool keepAll, uint32_t value) const;
+    bool FilterSparse(Block& block, SnapshotPredicate predicate, uint32_t value) const;
+    void Compact(Block& block) const;
+
+    std::vector<Block> blocks;
+    SnapshotValueType valueType = SnapshotValueType::I32;
+    SnapshotReadFunction read = nullptr;
+    void* context = nullptr;
+    size_t memoryBudget = DefaultMemoryBudget;
+    bool active = false;
+};
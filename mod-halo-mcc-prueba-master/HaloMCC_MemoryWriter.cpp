@@ -0,0 +1,178 @@
+// HaloMCC_MemoryWriter.cpp
+#include "HaloMCC_MemoryWriter.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// PAGE_* de winnt.h
+const uint32_t PageNoAccess = 0x01;
+const uint32_t PageReadWrite = 0x04;
+const uint32_t PageExecuteReadWrite = 0x40;
+const uint32_t PageWritable = 0x04 | 0x08 | 0x40 | 0x80;        // READWRITE, WRITECOPY, EXECUTE_READWRITE/WRITECOPY
+const uint32_t PageExecutable = 0x10 | 0x20 | 0x40 | 0x80;
+const uint32_t PageGuard = 0x100;
+
+bool IsWritable(uint32_t protect) {
+    return (protect & PageWritable) && !(protect & PageGuard);
+}
+
+} // namespace
+
+void BatchedMemoryWriter::SetBackend(const MemoryWriterBackend& newBackend) {
+    std::lock_guard<std::mutex> lock(mutex);
+    backend = newBackend;
+    pages.fill(PageEntry());
+}
+
+void BatchedMemoryWriter::Queue(uintptr_t address, const void* buffer, size_t size) {
+    if (!size) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back(PendingWrite{ address, size, bytes.size() });
+    const uint8_t* source = static_cast<const uint8_t*>(buffer);
+    bytes.insert(bytes.end(), source, source + size);
+}
+
+bool BatchedMemoryWriter::Write(uintptr_t address, const void* buffer, size_t size) {
+    Queue(address, buffer, size);
+    return Flush() == 0;
+}
+
+void BatchedMemoryWriter::InvalidatePages() {
+    std::lock_guard<std::mutex> lock(mutex);
+    pages.fill(PageEntry());
+}
+
+size_t BatchedMemoryWriter::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size();
+}
+
+// ============================================================================
+// Caché de protección
+// ============================================================================
+
+bool BatchedMemoryWriter::GetProtect(uintptr_t page, uint32_t& protect) {
+    PageEntry& entry = pages[(page / PageSize) % PageCacheSize];
+    if (entry.valid && entry.page == page) {
+        protect = entry.protect;
+        return true;
+    }
+
+    if (!backend.query || !backend.query(backend.context, page, protect)) return false;
+    entry.page = page;
+    entry.protect = protect;
+    entry.valid = true;
+    return true;
+}
+
+void BatchedMemoryWriter::ForgetPage(uintptr_t page) {
+    PageEntry& entry = pages[(page / PageSize) % PageCacheSize];
+    if (entry.page == page) entry.valid = false;
+}
+
+bool BatchedMemoryWriter::Unprotect(uintptr_t begin, size_t size, uint32_t protect) {
+    if (!backend.protect || (protect & 0xFF) == PageNoAccess) return false;
+
+    // Se conserva la ejecución si la página la tenía (código parcheado)
+    const uint32_t newProtect = (protect & PageExecutable) ? PageExecuteReadWrite : PageReadWrite;
+    uint32_t oldProtect = 0;
+    if (!backend.protect(backend.context, begin, size, newProtect, oldProtect)) return false;
+
+    unprotected.push_back(ProtectedRange{ begin, size, oldProtect });
+    return true;
+}
+
+// ============================================================================
+// Escritura
+// ============================================================================
+
+bool BatchedMemoryWriter::WriteOne(const PendingWrite& write) {
+    const uint8_t* source = bytes.data() + write.offset;
+    if (backend.write(backend.context, write.address, source, write.size)) return true;
+
+    // La protección cacheada ya no vale (el juego la cambió o se liberó la memoria): se
+    // consulta de nuevo y, si ahora no es escribible, se desprotege solo para esta escritura
+    const uintptr_t first = write.address & ~static_cast<uintptr_t>(PageSize - 1);
+    const uintptr_t last = (write.address + write.size - 1) & ~static_cast<uintptr_t>(PageSize - 1);
+    for (uintptr_t page = first; page <= last; page += PageSize) {
+        ForgetPage(page);
+
+        uint32_t protect = 0;
+        if (!GetProtect(page, protect)) return false;
+        if (!IsWritable(protect) && !Unprotect(page, PageSize, protect)) return false;
+    }
+    return backend.write(backend.context, write.address, source, write.size);
+}
+
+size_t BatchedMemoryWriter::Flush(uintptr_t* firstFailed) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (firstFailed) *firstFailed = 0;
+    if (pending.empty()) return 0;
+
+    if (!backend.write) {
+        const size_t count = pending.size();
+        if (firstFailed) *firstFailed = pending.front().address;
+        pending.clear();
+        bytes.clear();
+        return count;
+    }
+
+    // Páginas distintas que toca el lote
+    std::vector<uintptr_t> touched;
+    for (const PendingWrite& write : pending) {
+        const uintptr_t first = write.address & ~static_cast<uintptr_t>(PageSize - 1);
+        const uintptr_t last = (write.address + write.size - 1) & ~static_cast<uintptr_t>(PageSize - 1);
+        for (uintptr_t page = first; page <= last; page += PageSize) touched.push_back(page);
+    }
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+    // Las que no son escribibles se desprotegen por tramos de páginas seguidas con la misma
+    // protección: una llamada por tramo. Las escribibles no cuestan nada
+    unprotected.clear();
+    uintptr_t runBegin = 0;
+    uintptr_t runEnd = 0;
+    uint32_t runProtect = 0;
+    for (uintptr_t page : touched) {
+        uint32_t protect = 0;
+        if (!GetProtect(page, protect) || IsWritable(protect)) continue;
+
+        if (runEnd != runBegin && page == runEnd && protect == runProtect) {
+            runEnd += PageSize;
+            continue;
+        }
+        if (runEnd != runBegin) Unprotect(runBegin, runEnd - runBegin, runProtect);
+        runBegin = page;
+        runEnd = page + PageSize;
+        runProtect = protect;
+    }
+    if (runEnd != runBegin) Unprotect(runBegin, runEnd - runBegin, runProtect);
+
+    // En orden de encolado: si dos escrituras se solapan gana la última
+    size_t failed = 0;
+    for (const PendingWrite& write : pending) {
+        if (WriteOne(write)) continue;
+        if (!failed && firstFailed) *firstFailed = write.address;
+        failed++;
+    }
+
+    // Se restaura lo desprotegido; la caché se queda con la protección original, no con la
+    // temporal que pudo leer un reintento
+    for (const ProtectedRange& range : unprotected) {
+        uint32_t temporary = 0;
+        backend.protect(backend.context, range.begin, range.size, range.oldProtect, temporary);
+        for (uintptr_t page = range.begin; page < range.begin + range.size; page += PageSize) {
+            PageEntry& entry = pages[(page / PageSize) % PageCacheSize];
+            entry.page = page;
+            entry.protect = range.oldProtect;
+            entry.valid = true;
+        }
+    }
+    unprotected.clear();
+
+    pending.clear();
+    bytes.clear();
+    return failed;
+}
@@ -0,0 +1,79 @@
+// HaloMCC_MemoryWriter.h
+// Escrituras en memoria del juego agrupadas por página. Las escrituras se encolan durante el
+// frame y se vuelcan juntas en Flush(): solo se llama a VirtualProtect para las páginas que
+// no son escribibles (una vez por tramo de páginas, no por escritura) y la protección de cada
+// página se recuerda en una caché pequeña, así que en el caso normal (cámaras y flags en
+// heap/.data, ya escribibles) un frame no hace ninguna syscall.
+// Sin windows.h: consultar/cambiar protección y escribir lo pone quien llama (bajo SEH en el
+// DLL, SEH_GetWriterBackend).
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+struct MemoryWriterBackend {
+    // Protección (PAGE_*) de la página; false si no está comprometida
+    bool (*query)(void* context, uintptr_t page, uint32_t& protect) = nullptr;
+    // Cambia la protección de [address, address + size); oldProtect = la que tenía
+    bool (*protect)(void* context, uintptr_t address, size_t size, uint32_t newProtect, uint32_t& oldProtect) = nullptr;
+    // Copia protegida (false si la escritura falla)
+    bool (*write)(void* context, uintptr_t address, const void* buffer, size_t size) = nullptr;
+    void* context = nullptr;
+};
+
+class BatchedMemoryWriter {
+public:
+    static const size_t PageSize = 0x1000;
+    static const size_t PageCacheSize = 64;
+
+    void SetBackend(const MemoryWriterBackend& backend);
+
+    // Copia 'buffer'; no se escribe nada hasta Flush. Si dos escrituras se solapan gana la
+    // última encolada
+    void Queue(uintptr_t address, const void* buffer, size_t size);
+    // Escribe todo lo pendiente y restaura las protecciones. Devuelve las escrituras que
+    // fallaron (firstFailed = la dirección de la primera)
+    size_t Flush(uintptr_t* firstFailed = nullptr);
+    // Queue + Flush, para las escrituras sueltas fuera del frame
+    bool Write(uintptr_t address, const void* buffer, size_t size);
+
+    // Olvida la protección cacheada (carga/descarga de módulos). Una escritura que falla en
+    // una página cacheada como escribible también la olvida y se reintenta
+    void InvalidatePages();
+
+    size_t GetPendingCount() const;
+
+private:
+    struct PendingWrite {
+        uintptr_t address;
+        size_t size;
+        size_t offset;              // en 'bytes'
+    };
+
+    struct PageEntry {
+        uintptr_t page = 0;
+        uint32_t protect = 0;
+        bool valid = false;
+    };
+
+    // Páginas desprotegidas durante un Flush, para restaurarlas al final
+    struct ProtectedRange {
+        uintptr_t begin;
+        size_t size;
+        uint32_t oldProtect;
+    };
+
+    bool GetProtect(uintptr_t page, uint32_t& protect);
+    void ForgetPage(uintptr_t page);
+    bool Unprotect(uintptr_t begin, size_t size, uint32_t protect);
+    bool WriteOne(const PendingWrite& write);
+
+    mutable std::mutex mutex;
+    MemoryWriterBackend backend;
+    std::vector<PendingWrite> pending;
+    std::vector<uint8_t> bytes;
+    std::vector<ProtectedRange> unprotected;
+    std::array<PageEntry, PageCacheSize> pages;
+};
@@ -0,0 +1,229 @@
+// HaloMCC_Minidump.cpp
+#include "HaloMCC_Minidump.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+// minidumpapiset.h
+const uint32_t ModuleListStream = 4;
+const uint32_t MemoryListStream = 5;
+const uint32_t Memory64ListStream = 9;
+const uint32_t MemoryInfoListStream = 16;
+
+const size_t HeaderSize = 32;
+const size_t DirectoryEntrySize = 12;
+const size_t ModuleEntrySize = 108;             // MINIDUMP_MODULE (pack 4)
+const size_t MemoryDescriptorSize = 16;
+const size_t Memory64DescriptorSize = 16;
+const size_t MemoryInfoMinSize = 48;
+const uint32_t MaxModuleNameBytes = 32 * 1024;
+
+// winnt.h
+const uint32_t PageWritable = 0x04 | 0x08 | 0x40 | 0x80;       // READWRITE, WRITECOPY, EXECUTE_READWRITE/WRITECOPY
+const uint32_t PageExecutable = 0x20 | 0x40 | 0x80;            // EXECUTE_READ, EXECUTE_READWRITE/WRITECOPY
+const uint32_t MemImage = 0x1000000;
+
+struct Stream {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    bool present = false;
+};
+
+struct MemoryInfo {
+    uint64_t base = 0;
+    uint64_t size = 0;
+    uint32_t protect = 0;
+    uint32_t type = 0;
+};
+
+uint32_t ReadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+        (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t ReadU64(const uint8_t* p) {
+    return static_cast<uint64_t>(ReadU32(p)) | (static_cast<uint64_t>(ReadU32(p + 4)) << 32);
+}
+
+bool Fits(size_t fileSize, uint64_t offset, uint64_t length) {
+    return offset <= fileSize && length <= fileSize - offset;
+}
+
+std::vector<MemoryInfo> ReadMemoryInfo(const uint8_t* data, const Stream& stream) {
+    std::vector<MemoryInfo> infos;
+    if (!stream.present || stream.size < 16) return infos;
+
+    const uint8_t* p = data + stream.offset;
+    const uint32_t headerSize = ReadU32(p);
+    const uint32_t entrySize = ReadU32(p + 4);
+    const uint64_t count = ReadU64(p + 8);
+    if (headerSize < 16 || entrySize < MemoryInfoMinSize || headerSize > stream.size) return infos;
+
+    const uint64_t available = (stream.size - headerSize) / entrySize;
+    const uint64_t total = std::min(count, available);
+    infos.reserve(static_cast<size_t>(total));
+    for (uint64_t i = 0; i < total; ++i) {
+        // BaseAddress, AllocationBase, AllocationProtect, pad, RegionSize, State, Protect, Type
+        const uint8_t* entry = p + headerSize + i * entrySize;
+        MemoryInfo info;
+        info.base = ReadU64(entry);
+        info.size = ReadU64(entry + 24);
+        info.protect = ReadU32(entry + 36);
+        info.type = ReadU32(entry + 40);
+        if (info.size) infos.push_back(info);
+    }
+
+    std::sort(infos.begin(), infos.end(), [](const MemoryInfo& a, const MemoryInfo& b) { return a.base < b.base; });
+    return infos;
+}
+
+// El nombre viene como ruta completa en UTF-16; el resto del código usa el nombre en minúsculas
+std::string ReadModuleName(const uint8_t* data, size_t size, uint32_t rva) {
+    std::string name;
+    if (!Fits(size, rva, 4)) return name;
+
+    const uint32_t bytes = ReadU32(data + rva);
+    if (bytes > MaxModuleNameBytes || !Fits(size, static_cast<uint64_t>(rva) + 4, bytes)) return name;
+
+    for (uint32_t i = 0; i + 1 < bytes; i += 2) {
+        const uint16_t c = static_cast<uint16_t>(data[rva + 4 + i] | (data[rva + 5 + i] << 8));
+        if (c == '\\' || c == '/') {
+            name.clear();
+        }
+        else if (c >= 'A' && c <= 'Z') {
+            name.push_back(static_cast<char>(c - 'A' + 'a'));
+        }
+        else {
+            name.push_back(c < 0x80 ? static_cast<char>(c) : '?');
+        }
+    }
+    return name;
+}
+
+void ReadModules(const uint8_t* data, size_t size, const Stream& stream, ProcessMemory& memory) {
+    if (!stream.present || stream.size < 4) return;
+
+    const uint8_t* p = data + stream.offset;
+    const uint64_t count = std::min<uint64_t>(ReadU32(p), (stream.size - 4) / ModuleEntrySize);
+    for (uint64_t i = 0; i < count; ++i) {
+        // BaseOfImage, SizeOfImage, CheckSum, TimeDateStamp, ModuleNameRva, ...
+        const uint8_t* entry = p + 4 + i * ModuleEntrySize;
+        ProcessModule module;
+        module.base = static_cast<uintptr_t>(ReadU64(entry));
+        module.sizeOfImage = ReadU32(entry + 8);
+        module.size = module.sizeOfImage;
+        module.checkSum = ReadU32(entry + 12);
+        module.timeDateStamp = ReadU32(entry + 16);
+        module.name = ReadModuleName(data, size, ReadU32(entry + 20));
+        if (module.size && !module.name.empty()) memory.AddModule(module);
+    }
+}
+
+// Un rango del volcado, partido donde cambia la protección según MemoryInfoListStream
+void AddRange(ProcessMemory& memory, const std::vector<MemoryInfo>& infos, uint64_t base, uint64_t length,
+    const uint8_t* bytes) {
+    while (length) {
+        ProcessRegion region;
+        region.base = static_cast<uintptr_t>(base);
+        region.data = bytes;
+        uint64_t chunk = length;
+
+        auto next = std::upper_bound(infos.begin(), infos.end(), base,
+            [](uint64_t value, const MemoryInfo& info) { return value < info.base; });
+        if (next != infos.begin() && base - (next - 1)->base < (next - 1)->size) {
+            const MemoryInfo& info = *(next - 1);
+            chunk = std::min(chunk, info.base + info.size - base);
+            region.protect = info.protect;
+            if (info.protect & PageWritable) region.flags |= REGION_WRITABLE;
+            if (info.protect & PageExecutable) region.flags |= REGION_EXECUTABLE;
+            if (info.type == MemImage) region.flags |= REGION_IMAGE;
+        }
+        else {
+            // Sin protección conocida se da por escribible: el mapa de punteros solo mira las
+            // regiones escribibles y es mejor que sobren candidatos a que falten
+            if (next != infos.end()) chunk = std::min(chunk, next->base - base);
+            region.flags = REGION_WRITABLE;
+            if (memory.FindModule(region.base)) region.flags |= REGION_IMAGE;
+        }
+
+        region.size = static_cast<size_t>(chunk);
+        memory.AddRegion(region);
+        base += chunk;
+        bytes += chunk;
+        length -= chunk;
+    }
+}
+
+} // namespace
+
+bool Minidump::IsMinidump(const uint8_t* data, size_t size) {
+    return data && size >= HeaderSize && ReadU32(data) == Signature;
+}
+
+bool Minidump::Open(const uint8_t* data, size_t size, ProcessMemory& memory) {
+    memory.Clear();
+    if (!IsMinidump(data, size)) return false;
+
+    const uint32_t streamCount = ReadU32(data + 8);
+    const uint32_t directoryRva = ReadU32(data + 12);
+    if (!Fits(size, directoryRva, static_cast<uint64_t>(streamCount) * DirectoryEntrySize)) return false;
+
+    Stream modules, memoryList, memory64List, memoryInfo;
+    for (uint32_t i = 0; i < streamCount; ++i) {
+        const uint8_t* entry = data + directoryRva + i * DirectoryEntrySize;
+        Stream stream;
+        stream.size = ReadU32(entry + 4);
+        stream.offset = ReadU32(entry + 8);
+        stream.present = Fits(size, stream.offset, stream.size);
+        if (!stream.present) continue;
+
+        switch (ReadU32(entry)) {
+        case ModuleListStream:      modules = stream; break;
+        case MemoryListStream:      memoryList = stream; break;
+        case Memory64ListStream:    memory64List = stream; break;
+        case MemoryInfoListStream:  memoryInfo = stream; break;
+        default: break;
+        }
+    }
+
+    // Módulos primero: sin MemoryInfoListStream se usan para marcar las regiones de imagen
+    ReadModules(data, size, modules, memory);
+    memory.Finalize();
+    const std::vector<MemoryInfo> infos = ReadMemoryInfo(data, memoryInfo);
+
+    if (memory64List.present && memory64List.size >= 16) {
+        // Los datos de todos los rangos van seguidos a partir de BaseRva
+        const uint8_t* p = data + memory64List.offset;
+        const uint64_t count = std::min(ReadU64(p), (memory64List.size - 16) / Memory64DescriptorSize);
+        uint64_t offset = ReadU64(p + 8);
+        for (uint64_t i = 0; i < count; ++i) {
+            const uint8_t* descriptor = p + 16 + i * Memory64DescriptorSize;
+            const uint64_t base = ReadU64(descriptor);
+            const uint64_t length = ReadU64(descriptor + 8);
+            // Volcado truncado (copia a medias): se queda con lo que haya entero
+            if (!Fits(size, offset, length)) break;
+
+            AddRange(memory, infos, base, length, data + offset);
+            offset += length;
+        }
+    }
+    else if (memoryList.present && memoryList.size >= 4) {
+        const uint8_t* p = data + memoryList.offset;
+        const uint64_t count = std::min<uint64_t>(ReadU32(p), (memoryList.size - 4) / MemoryDescriptorSize);
+        for (uint64_t i = 0; i < count; ++i) {
+            // StartOfMemoryRange, DataSize, Rva
+            const uint8_t* descriptor = p + 4 + i * MemoryDescriptorSize;
+            const uint64_t base = ReadU64(descriptor);
+            const uint32_t length = ReadU32(descriptor + 8);
+            const uint32_t rva = ReadU32(descriptor + 12);
+            if (!Fits(size, rva, length)) continue;
+
+            AddRange(memory, infos, base, length, data + rva);
+        }
+    }
+
+    memory.Finalize();
+    return !memory.GetRegions().empty();
+}
@@ -0,0 +1,23 @@
+// HaloMCC_Minidump.h
+// Lectura de minidumps de Windows (.dmp de MiniDumpWriteDump / Administrador de tareas) sobre
+// el fichero ya mapeado: las regiones de la ProcessMemory apuntan dentro del mapeo, así que un
+// volcado de 20 GB se recorre sin cargarlo (el sistema trae y suelta las páginas según se leen).
+// Mismo resultado que SEH_CollectProcessRegions en el proceso vivo: los scanners de patrones,
+// xrefs y punteros no distinguen de dónde viene la memoria.
+// Sin windows.h: las estructuras MINIDUMP_* se leen campo a campo.
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "HaloMCC_ProcessMemory.h"
+
+class Minidump {
+public:
+    static const uint32_t Signature = 0x504D444D;      // "MDMP"
+
+    static bool IsMinidump(const uint8_t* data, size_t size);
+
+    // Regiones de Memory64ListStream (volcado completo) y MemoryListStream (volcado mínimo),
+    // protección/tipo de MemoryInfoListStream y módulos de ModuleListStream. 'data' debe
+    // seguir mapeado mientras se use 'memory'
+    static bool Open(const uint8_t* data, size_t size, ProcessMemory& memory);
+};
@@ -0,0 +1,185 @@
+// HaloMCC_ModuleWatcher.cpp
+#include "pch.h"
+#include "HaloMCC_ModuleWatcher.h"
+#include <psapi.h>
+#include <vector>
+
+#pragma comment(lib, "psapi.lib")
+
+namespace {
+
+// Estructuras de ntdll (no están en los headers públicos salvo winternl.h parcial)
+struct LdrUnicodeString {
+    USHORT Length;              // bytes, sin terminador
+    USHORT MaximumLength;
+    PWSTR Buffer;
+};
+
+// Misma forma para carga y descarga
+struct LdrDllNotificationData {
+    ULONG Flags;
+    const LdrUnicodeString* FullDllName;
+    const LdrUnicodeString* BaseDllName;
+    PVOID DllBase;
+    ULONG SizeOfImage;
+};
+
+const ULONG LdrDllNotificationReasonLoaded = 1;
+const ULONG LdrDllNotificationReasonUnloaded = 2;
+
+typedef VOID (CALLBACK* LdrDllNotificationFunction)(ULONG reason, const void* data, PVOID context);
+typedef LONG (NTAPI* LdrRegisterDllNotification_t)(ULONG flags, LdrDllNotificationFunction callback,
+                                                    PVOID context, PVOID* cookie);
+typedef LONG (NTAPI* LdrUnregisterDllNotification_t)(PVOID cookie);
+
+char ToLowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Sin WideCharToMultiByte: bajo el loader lock, cuanto menos se llame mejor. Los nombres
+// que interesan son ASCII; el resto de caracteres no casará con ningún filtro
+std::string ToLowerName(const LdrUnicodeString* name) {
+    std::string result;
+    if (!name || !name->Buffer) return result;
+
+    const size_t length = name->Length / sizeof(WCHAR);
+    result.reserve(length);
+    for (size_t i = 0; i < length; ++i) {
+        const WCHAR c = name->Buffer[i];
+        result.push_back(c < 0x80 ? ToLowerAscii(static_cast<char>(c)) : '?');
+    }
+    return result;
+}
+
+} // namespace
+
+// ============================================================================
+// Registro
+// ============================================================================
+
+ModuleWatcher::~ModuleWatcher() {
+    Stop();
+}
+
+bool ModuleWatcher::Start(ModuleFilter moduleFilter, ModuleHandler moduleHandler) {
+    if (running || !moduleFilter || !moduleHandler) return false;
+
+    HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+    auto registerNotification = ntdll ? reinterpret_cast<LdrRegisterDllNotification_t>(
+        GetProcAddress(ntdll, "LdrRegisterDllNotification")) : nullptr;
+    if (!registerNotification) return false;
+
+    filter = moduleFilter;
+    handler = moduleHandler;
+    stopping = false;
+
+    // El aviso va primero: un módulo que se cargue mientras se enumeran los ya cargados puede
+    // llegar dos veces, pero no perderse. El handler descarta los duplicados
+    if (registerNotification(0, &ModuleWatcher::OnNotification, this, &cookie) < 0) {
+        cookie = nullptr;
+        return false;
+    }
+
+    running = true;
+    worker = std::thread([this]() {
+        EnqueueLoadedModules();
+        WorkerLoop();
+    });
+    return true;
+}
+
+void ModuleWatcher::Stop() {
+    if (!running) return;
+
+    HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+    auto unregisterNotification = ntdll ? reinterpret_cast<LdrUnregisterDllNotification_t>(
+        GetProcAddress(ntdll, "LdrUnregisterDllNotification")) : nullptr;
+    if (unregisterNotification && cookie) unregisterNotification(cookie);
+    cookie = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+        queue.clear();
+    }
+    queueSignal.notify_all();
+
+    if (worker.joinable()) worker.join();
+    running = false;
+}
+
+// ============================================================================
+// Eventos
+// ============================================================================
+
+VOID CALLBACK ModuleWatcher::OnNotification(ULONG reason, const void* data, PVOID context) {
+    if (reason != LdrDllNotificationReasonLoaded && reason != LdrDllNotificationReasonUnloaded) return;
+
+    ModuleWatcher* watcher = static_cast<ModuleWatcher*>(context);
+    const LdrDllNotificationData* notification = static_cast<const LdrDllNotificationData*>(data);
+    if (!watcher || !notification) return;
+
+    ModuleEvent event;
+    event.name = ToLowerName(notification->BaseDllName);
+    if (!watcher->filter(event.name)) return;
+
+    event.baseAddress = reinterpret_cast<uintptr_t>(notification->DllBase);
+    event.moduleSize = notification->SizeOfImage;
+    event.loaded = reason == LdrDllNotificationReasonLoaded;
+    watcher->Enqueue(event);
+}
+
+void ModuleWatcher::Enqueue(const ModuleEvent& event) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping) return;
+        queue.push_back(event);
+    }
+    queueSignal.notify_one();
+}
+
+void ModuleWatcher::EnqueueLoadedModules() {
+    HANDLE process = GetCurrentProcess();
+
+    std::vector<HMODULE> modules(256);
+    DWORD needed = 0;
+    while (EnumProcessModules(process, modules.data(), static_cast<DWORD>(modules.size() * sizeof(HMODULE)), &needed) &&
+           needed > modules.size() * sizeof(HMODULE)) {
+        modules.resize(needed / sizeof(HMODULE));
+    }
+    modules.resize(needed / sizeof(HMODULE));
+
+    for (HMODULE module : modules) {
+        char name[MAX_PATH] = {};
+        MODULEINFO info = {};
+        if (!GetModuleBaseNameA(process, module, name, MAX_PATH) ||
+            !GetModuleInformation(process, module, &info, sizeof(info))) {
+            continue;
+        }
+
+        ModuleEvent event;
+        for (const char* c = name; *c; ++c) event.name.push_back(ToLowerAscii(*c));
+        if (!filter(event.name)) continue;
+
+        event.baseAddress = reinterpret_cast<uintptr_t>(info.lpBaseOfDll);
+        event.moduleSize = info.SizeOfImage;
+        event.loaded = true;
+        Enqueue(event);
+    }
+}
+
+void ModuleWatcher::WorkerLoop() {
+    for (;;) {
+        ModuleEvent event;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueSignal.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (stopping) return;
+
+            event = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        handler(event);
+    }
+}
@@ -0,0 +1,60 @@
+// HaloMCC_ModuleWatcher.h
+// Avisos de carga/descarga de módulos (LdrRegisterDllNotification). MCC carga la DLL de cada
+// juego (halo1.dll, halo3.dll...) al entrar en el título y la descarga al salir. El callback
+// del loader corre con el loader lock tomado: solo filtra por nombre y encola; los eventos los
+// atiende un hilo propio, que es donde se puede escanear.
+#pragma once
+#include <windows.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct ModuleEvent {
+    std::string name;           // nombre sin ruta, en minúsculas
+    uintptr_t baseAddress = 0;
+    size_t moduleSize = 0;
+    bool loaded = false;        // false = descarga
+};
+
+class ModuleWatcher {
+public:
+    // Se llama bajo el loader lock: nada de cargar módulos ni tomar locks del juego
+    typedef bool (*ModuleFilter)(const std::string& name);
+    // Se llama en el hilo del watcher, un evento cada vez y en orden
+    typedef void (*ModuleHandler)(const ModuleEvent& event);
+
+    ModuleWatcher() = default;
+    ~ModuleWatcher();
+
+    ModuleWatcher(const ModuleWatcher&) = delete;
+    ModuleWatcher& operator=(const ModuleWatcher&) = delete;
+
+    // Registra el aviso y arranca el hilo, que empieza por los módulos ya cargados que pasen
+    // el filtro. false si ntdll no exporta LdrRegisterDllNotification
+    bool Start(ModuleFilter filter, ModuleHandler handler);
+    // Quita el aviso y espera al hilo; los eventos pendientes se descartan
+    void Stop();
+    bool IsRunning() const { return running; }
+
+private:
+    static VOID CALLBACK OnNotification(ULONG reason, const void* data, PVOID context);
+
+    void Enqueue(const ModuleEvent& event);
+    void EnqueueLoadedModules();
+    void WorkerLoop();
+
+    ModuleFilter filter = nullptr;
+    ModuleHandler handler = nullptr;
+    PVOID cookie = nullptr;
+    bool running = false;
+
+    std::mutex queueMutex;
+    std::condition_variable queueSignal;
+    std::deque<ModuleEvent> queue;
+    bool stopping = false;
+    std::thread worker;
+};
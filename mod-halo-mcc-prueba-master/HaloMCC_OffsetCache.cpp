@@ -0,0 +1,229 @@
+// HaloMCC_OffsetCache.cpp
+#include "HaloMCC_OffsetCache.h"
+#include <cstdio>
+#include <fstream>
+
+// ============================================================================
+// Serialización (little-endian, campo a campo para no depender del padding)
+// ============================================================================
+
+namespace {
+
+void WriteU32(std::ofstream& out, uint32_t value) {
+    uint8_t bytes[4] = {
+        static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+        static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24)
+    };
+    out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+bool ReadU32(std::ifstream& in, uint32_t& value) {
+    uint8_t bytes[4];
+    if (!in.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) return false;
+    value = static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+        (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    return true;
+}
+
+void WriteKey(std::ofstream& out, const OffsetCacheKey& key) {
+    WriteU32(out, key.timeDateStamp);
+    WriteU32(out, key.sizeOfImage);
+    WriteU32(out, key.checkSum);
+    WriteU32(out, key.gameVersion);
+    WriteU32(out, key.gamePlatform);
+}
+
+bool ReadKey(std::ifstream& in, OffsetCacheKey& key) {
+    return ReadU32(in, key.timeDateStamp) && ReadU32(in, key.sizeOfImage) &&
+        ReadU32(in, key.checkSum) && ReadU32(in, key.gameVersion) &&
+        ReadU32(in, key.gamePlatform);
+}
+
+} // namespace
+
+// ============================================================================
+// OffsetCacheRecord
+// ============================================================================
+
+const OffsetCacheEntry* OffsetCacheRecord::FindEntry(uint32_t field) const {
+    for (const OffsetCacheEntry& entry : entries) {
+        if (entry.field == field) return &entry;
+    }
+    return nullptr;
+}
+
+const OffsetCachePointerPath* OffsetCacheRecord::FindPointerPath(uint32_t field) const {
+    for (const OffsetCachePointerPath& path : pointerPaths) {
+        if (path.field == field) return &path;
+    }
+    return nullptr;
+}
+
+void OffsetCacheRecord::SetPointerPath(const OffsetCachePointerPath& path) {
+    for (OffsetCachePointerPath& existing : pointerPaths) {
+        if (existing.field == path.field) {
+            existing = path;
+            return;
+        }
+    }
+    pointerPaths.push_back(path);
+}
+
+// ============================================================================
+// OffsetCache
+// ============================================================================
+
+bool OffsetCache::Load(const std::string& path) {
+    records.clear();
+
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in.is_open()) return false;
+
+    uint32_t magic = 0, version = 0, recordCount = 0;
+    if (!ReadU32(in, magic) || magic != FileMagic) return false;
+    if (!ReadU32(in, version) || version != FileVersion) return false;
+    if (!ReadU32(in, recordCount) || recordCount > MaxRecords) return false;
+
+    std::vector<OffsetCacheRecord> loaded;
+    for (uint32_t r = 0; r < recordCount; ++r) {
+        OffsetCacheRecord record;
+        uint32_t entryCount = 0;
+        if (!ReadKey(in, record.key) || !ReadU32(in, entryCount) || entryCount > 64) return false;
+
+        for (uint32_t e = 0; e < entryCount; ++e) {
+            OffsetCacheEntry entry;
+            uint32_t verifyLength = 0, signatureRank = 0, confidence = 0;
+            if (!ReadU32(in, entry.field) || !ReadU32(in, entry.siteRva) ||
+                !ReadU32(in, entry.targetRva) || !ReadU32(in, verifyLength) ||
+                !ReadU32(in, signatureRank) || !ReadU32(in, confidence) ||
+                verifyLength > OffsetCacheEntry::MaxVerifyBytes || signatureRank > 0xFF || confidence > 100) {
+                return false;
+            }
+
+            entry.verifyLength = static_cast<uint8_t>(verifyLength);
+            entry.signatureRank = static_cast<uint8_t>(signatureRank);
+            entry.confidence = static_cast<uint8_t>(confidence);
+            if (!in.read(reinterpret_cast<char*>(entry.verifyBytes), OffsetCacheEntry::MaxVerifyBytes) ||
+                !in.read(reinterpret_cast<char*>(entry.verifyMask), OffsetCacheEntry::MaxVerifyBytes)) {
+                return false;
+            }
+            record.entries.push_back(entry);
+        }
+
+        uint32_t pathCount = 0;
+        if (!ReadU32(in, pathCount) || pathCount > 64) return false;
+        for (uint32_t p = 0; p < pathCount; ++p) {
+            OffsetCachePointerPath path;
+            uint32_t depth = 0;
+            if (!ReadU32(in, path.field) || !ReadU32(in, path.baseRva) || !ReadU32(in, depth) ||
+                depth > OffsetCachePointerPath::MaxDepth) {
+                return false;
+            }
+            for (uint32_t d = 0; d < depth; ++d) {
+                uint32_t offset = 0;
+                if (!ReadU32(in, offset)) return false;
+                path.offsets.push_back(static_cast<int32_t>(offset));
+            }
+            record.pointerPaths.push_back(path);
+        }
+        loaded.push_back(record);
+    }
+
+    records.swap(loaded);
+    return true;
+}
+
+bool OffsetCache::Save(const std::string& path) const {
+    // Se escribe a un temporal y se renombra para no dejar una caché a medias
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+
+        WriteU32(out, FileMagic);
+        WriteU32(out, FileVersion);
+        WriteU32(out, static_cast<uint32_t>(records.size()));
+
+        for (const OffsetCacheRecord& record : records) {
+            WriteKey(out, record.key);
+            WriteU32(out, static_cast<uint32_t>(record.entries.size()));
+
+            for (const OffsetCacheEntry& entry : record.entries) {
+                WriteU32(out, entry.field);
+                WriteU32(out, entry.siteRva);
+                WriteU32(out, entry.targetRva);
+                WriteU32(out, entry.verifyLength);
+                WriteU32(out, entry.signatureRank);
+                WriteU32(out, entry.confidence);
+                out.write(reinterpret_cast<const char*>(entry.verifyBytes), OffsetCacheEntry::MaxVerifyBytes);
+                out.write(reinterpret_cast<const char*>(entry.verifyMask), OffsetCacheEntry::MaxVerifyBytes);
+            }
+
+            WriteU32(out, static_cast<uint32_t>(record.pointerPaths.size()));
+            for (const OffsetCachePointerPath& path : record.pointerPaths) {
+                WriteU32(out, path.field);
+                WriteU32(out, path.baseRva);
+                WriteU32(out, static_cast<uint32_t>(path.offsets.size()));
+                for (int32_t offset : path.offsets) WriteU32(out, static_cast<uint32_t>(offset));
+            }
+        }
+
+        if (!out.good()) return false;
+    }
+
+    std::remove(path.c_str());
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+const OffsetCacheRecord* OffsetCache::Find(const OffsetCacheKey& key) const {
+    for (const OffsetCacheRecord& record : records) {
+        if (record.key == key) return &record;
+    }
+    return nullptr;
+}
+
+void OffsetCache::Store(const OffsetCacheRecord& record) {
+    OffsetCacheRecord stored = record;
+    const OffsetCacheRecord* previous = Find(record.key);
+    if (previous && stored.pointerPaths.empty()) stored.pointerPaths = previous->pointerPaths;
+
+    Remove(record.key);
+    records.push_back(stored);
+
+    if (records.size() > MaxRecords) {
+        records.erase(records.begin(), records.begin() + (records.size() - MaxRecords));
+    }
+}
+
+void OffsetCache::Remove(const OffsetCacheKey& key) {
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (records[i].key == key) {
+            records.erase(records.begin() + i);
+            return;
+        }
+    }
+}
+
+OffsetCacheEntry OffsetCache::MakeEntry(uint32_t field, uint32_t siteRva, uint32_t targetRva, const PatternView& pattern) {
+    OffsetCacheEntry entry;
+    entry.field = field;
+    entry.siteRva = siteRva;
+    entry.targetRva = targetRva;
+
+    const size_t length = pattern.length < OffsetCacheEntry::MaxVerifyBytes ? pattern.length : OffsetCacheEntry::MaxVerifyBytes;
+    entry.verifyLength = static_cast<uint8_t>(length);
+    for (size_t i = 0; i < length; ++i) {
+        entry.verifyBytes[i] = pattern.mask[i] ? pattern.bytes[i] : 0;
+        entry.verifyMask[i] = pattern.mask[i] ? 1 : 0;
+    }
+    return entry;
+}
+
+bool OffsetCache::VerifyEntry(const OffsetCacheEntry& entry, const uint8_t* siteBytes) {
+    for (size_t i = 0; i < entry.verifyLength; ++i) {
+        if (entry.verifyMask[i] && siteBytes[i] != entry.verifyBytes[i]) {
+            return false;
+        }
+    }
+    return true;
+}
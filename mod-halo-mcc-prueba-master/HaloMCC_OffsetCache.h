@@ -0,0 +1,93 @@
+// HaloMCC_OffsetCache.h
+// Caché binaria de offsets resueltos (RVAs relativas al módulo) para no re-escanear en
+// cada arranque. Se invalida sola cuando cambia el ejecutable (parche del juego).
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "HaloMCC_PatternScanner.h"
+
+// Identidad del módulo + juego detectado
+struct OffsetCacheKey {
+    uint32_t timeDateStamp = 0;
+    uint32_t sizeOfImage = 0;
+    uint32_t checkSum = 0;
+    uint32_t gameVersion = 0;     // GameVersion
+    uint32_t gamePlatform = 0;    // GamePlatform
+
+    bool operator==(const OffsetCacheKey& other) const {
+        return timeDateStamp == other.timeDateStamp && sizeOfImage == other.sizeOfImage &&
+            checkSum == other.checkSum && gameVersion == other.gameVersion &&
+            gamePlatform == other.gamePlatform;
+    }
+    bool operator!=(const OffsetCacheKey& other) const { return !(*this == other); }
+};
+
+// Campos de GameOffsets que salen de un escaneo
+enum OffsetField : uint32_t {
+    OFFSET_SPLIT_SCREEN_ENABLED = 1,
+    OFFSET_PLAYER_COUNT = 2,
+    OFFSET_CAMERA_BASE = 3
+};
+
+struct OffsetCacheEntry {
+    static const size_t MaxVerifyBytes = 16;
+
+    uint32_t field = 0;
+    uint32_t siteRva = 0;       // instrucción que casó con la firma
+    uint32_t targetRva = 0;     // global resuelto
+    uint8_t verifyLength = 0;   // bytes de la firma que se comprueban al cargar
+    uint8_t verifyBytes[MaxVerifyBytes] = {};
+    uint8_t verifyMask[MaxVerifyBytes] = {};
+    uint8_t signatureRank = 0;  // firma que ganó: 0 = la principal, 1.. = alternativas
+    uint8_t confidence = 0;     // 0-100, acuerdo entre las firmas del campo
+};
+
+// Cadena de punteros hacia un campo dinámico (sale de halo_pointer_scan, no del escaneo):
+// [[módulo+baseRva] + offsets[0]] ... + offsets[n-1], módulo = el de la clave del registro
+struct OffsetCachePointerPath {
+    static const size_t MaxDepth = 8;
+
+    uint32_t field = 0;
+    uint32_t baseRva = 0;
+    std::vector<int32_t> offsets;
+};
+
+struct OffsetCacheRecord {
+    OffsetCacheKey key;
+    std::vector<OffsetCacheEntry> entries;
+    std::vector<OffsetCachePointerPath> pointerPaths;
+
+    const OffsetCacheEntry* FindEntry(uint32_t field) const;
+    const OffsetCachePointerPath* FindPointerPath(uint32_t field) const;
+    // Reemplaza la cadena del mismo campo (o la añade)
+    void SetPointerPath(const OffsetCachePointerPath& path);
+};
+
+class OffsetCache {
+public:
+    static const uint32_t FileMagic = 0x4F434D48;     // "HMCO"
+    static const uint32_t FileVersion = 3;
+    static const size_t MaxRecords = 16;
+
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+
+    const OffsetCacheRecord* Find(const OffsetCacheKey& key) const;
+    // Reemplaza el registro con la misma clave (o lo añade; se descartan los más antiguos).
+    // Si el nuevo no trae cadenas de punteros conserva las del anterior: el DLL re-escanea
+    // firmas, pero las cadenas solo las pone la herramienta
+    void Store(const OffsetCacheRecord& record);
+    void Remove(const OffsetCacheKey& key);
+
+    const std::vector<OffsetCacheRecord>& GetRecords() const { return records; }
+
+    // Entrada a partir del match: guarda los primeros bytes significativos de la firma
+    static OffsetCacheEntry MakeEntry(uint32_t field, uint32_t siteRva, uint32_t targetRva, const PatternView& pattern);
+    // Comprueba los bytes guardados contra los bytes actuales del sitio (verifyLength bytes)
+    static bool VerifyEntry(const OffsetCacheEntry& entry, const uint8_t* siteBytes);
+
+private:
+    std::vector<OffsetCacheRecord> records;
+};
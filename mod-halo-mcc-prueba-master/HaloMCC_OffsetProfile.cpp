@@ -0,0 +1,564 @@
+// HaloMCC_OffsetProfile.cpp
+#include "HaloMCC_OffsetProfile.h"
+#include "HaloMCC_Signature.h"
+#include "HaloMCC_X86Decoder.h"
+#include <algorithm>
+#include <cctype>
+
+// ============================================================================
+// Firmas
+// ============================================================================
+
+namespace {
+
+// Por campo, en orden de preferencia. Una alternativa solo entra si sale de un sitio real de
+// un build de MCC y tiene bytes fijos de sobra para ser única en toda la imagen: una variante
+// adivinada con 4 bytes fijos matchea datos al azar y vota en contra de la buena
+
+// cmp dword ptr [rip+disp], 1 ; je rel32
+constexpr auto kSplitScreenCheck = MakeSignature("83 3D ?? ?? ?? ?? 01 0F 84 ?? ?? ?? ??");
+
+// mov eax, [rip+disp] ; cmp eax, 1 ; jle rel8
+constexpr auto kPlayerCount = MakeSignature("8B 05 ?? ?? ?? ?? 83 F8 01 7E ??");
+
+// movups xmm0, [rip+disp] ; movups [rcx], xmm0 ; movups xmm1, [rip+disp]
+constexpr auto kCameraMatrix = MakeSignature("0F 10 05 ?? ?? ?? ?? 0F 11 01 0F 10 0D ?? ?? ?? ??");
+
+OffsetSignature MakeOffsetSignature(uint32_t field, uint32_t rank, const char* name, uint32_t operandIndex,
+                                    const PreparedPattern& pattern, uint32_t targetSections) {
+    OffsetSignature signature;
+    signature.field = field;
+    signature.rank = rank;
+    signature.name = name;
+    signature.operandIndex = operandIndex;
+    signature.pattern = pattern;
+    signature.targetSections = targetSections;
+    return signature;
+}
+
+std::vector<OffsetSignature> CreateSignatures() {
+    // Las firmas actuales son genéricas y valen para todos los módulos (titles = TITLE_MASK_ALL);
+    // una firma propia de un juego lleva solo el bit de su título.
+    // Los dos flags se escriben desde el mod: tienen que estar en datos escribibles.
+    // Aún no hay firmas ancladas en cadena: hacen falta cadenas sacadas del binario que se
+    // distribuye y un patrón de ventana con bytes fijos de sobra para no casar en cualquier
+    // sitio de +-N bytes alrededor del lea
+    return {
+        MakeOffsetSignature(OFFSET_SPLIT_SCREEN_ENABLED, 0, "Split-screen check", 0, kSplitScreenCheck.Prepared(), SECTION_DATA),
+        MakeOffsetSignature(OFFSET_PLAYER_COUNT, 0, "Player count", 0, kPlayerCount.Prepared(), SECTION_DATA),
+        MakeOffsetSignature(OFFSET_CAMERA_BASE, 0, "Camera matrix", 0, kCameraMatrix.Prepared(), SECTION_ANY_DATA)
+    };
+}
+
+} // namespace
+
+const std::vector<OffsetSignature>& OffsetScanCore::GetSignatures() {
+    static const std::vector<OffsetSignature> signatures = CreateSignatures();
+    return signatures;
+}
+
+const OffsetSignature* OffsetScanCore::FindSignature(uint32_t field, uint32_t rank) {
+    for (const OffsetSignature& signature : GetSignatures()) {
+        if (signature.field == field && signature.rank == rank) return &signature;
+    }
+    return nullptr;
+}
+
+std::vector<uint32_t> OffsetScanCore::GetFields() {
+    return GetFields(GetSignatures());
+}
+
+std::vector<uint32_t> OffsetScanCore::GetFields(const std::vector<OffsetSignature>& signatures) {
+    std::vector<uint32_t> fields;
+    for (const OffsetSignature& signature : signatures) {
+        if (fields.empty() || fields.back() != signature.field) fields.push_back(signature.field);
+    }
+    return fields;
+}
+
+const char* OffsetScanCore::FieldToString(uint32_t field) {
+    switch (field) {
+    case OFFSET_SPLIT_SCREEN_ENABLED: return "Split-screen flag";
+    case OFFSET_PLAYER_COUNT: return "Player count";
+    case OFFSET_CAMERA_BASE: return "Camera base";
+    default: return "?";
+    }
+}
+
+uint32_t OffsetScanCore::GetSectionMask() {
+    return GetSectionMask(GetSignatures());
+}
+
+uint32_t OffsetScanCore::GetSectionMask(const std::vector<OffsetSignature>& signatures) {
+    uint32_t mask = 0;
+    for (const OffsetSignature& signature : signatures) {
+        mask |= signature.sections;
+    }
+    return mask;
+}
+
+const std::vector<OffsetTitleInfo>& OffsetScanCore::GetTitles() {
+    // gameVersion sigue el orden de GameVersion (UWP_Detection.h); ODST no tiene valor propio
+    static const std::vector<OffsetTitleInfo> titles = {
+        { TITLE_MCC, "mcc-win64-shipping.exe", 6, "MCC" },
+        { TITLE_HALO1, "halo1.dll", 0, "Halo: Combat Evolved" },
+        { TITLE_HALO2, "halo2.dll", 1, "Halo 2" },
+        { TITLE_HALO2A, "groundhog.dll", 2, "Halo 2 Anniversary" },
+        { TITLE_HALO3, "halo3.dll", 3, "Halo 3" },
+        { TITLE_HALO3ODST, "halo3odst.dll", 6, "Halo 3: ODST" },
+        { TITLE_REACH, "haloreach.dll", 4, "Halo: Reach" },
+        { TITLE_HALO4, "halo4.dll", 5, "Halo 4" }
+    };
+    return titles;
+}
+
+const OffsetTitleInfo* OffsetScanCore::FindTitle(uint32_t title) {
+    for (const OffsetTitleInfo& info : GetTitles()) {
+        if (info.title == title) return &info;
+    }
+    return nullptr;
+}
+
+const OffsetTitleInfo* OffsetScanCore::FindTitleByModule(const char* moduleName) {
+    if (!moduleName) return nullptr;
+
+    std::string lower(moduleName);
+    for (char& c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    if (lower == "mccwinstore-win64-shipping.exe") return FindTitle(TITLE_MCC);
+
+    for (const OffsetTitleInfo& info : GetTitles()) {
+        if (lower == info.moduleName) return &info;
+    }
+    return nullptr;
+}
+
+bool OffsetScanCore::AppliesTo(const OffsetSignature& signature, uint32_t title) {
+    return title < TITLE_COUNT && (signature.titles & (1u << title)) != 0;
+}
+
+void OffsetScanCore::BuildScanner(MultiPatternScanner& scanner, uint32_t title) {
+    BuildScanner(GetSignatures(), scanner, title);
+}
+
+void OffsetScanCore::BuildScanner(const std::vector<OffsetSignature>& signatures, MultiPatternScanner& scanner,
+                                  uint32_t title) {
+    for (const OffsetSignature& signature : signatures) {
+        if (!signature.anchorString && AppliesTo(signature, title)) scanner.AddPattern(signature.pattern);
+    }
+}
+
+bool OffsetScanCore::HasStringAnchors(uint32_t title) {
+    return HasStringAnchors(GetSignatures(), title);
+}
+
+bool OffsetScanCore::HasStringAnchors(const std::vector<OffsetSignature>& signatures, uint32_t title) {
+    for (const OffsetSignature& signature : signatures) {
+        if (signature.anchorString && AppliesTo(signature, title)) return true;
+    }
+    return false;
+}
+
+size_t OffsetScanCore::GetSiteLength(const OffsetSignature& signature) {
+    size_t length = signature.pattern.view.length;
+    if (signature.followUp.length && signature.followUpOffset + signature.followUp.length > length) {
+        length = signature.followUpOffset + signature.followUp.length;
+    }
+    return length + X86Decoder::MaxInstructionLength;
+}
+
+void OffsetScanCore::AddCandidates(std::vector<OffsetCandidates>& candidates, const std::vector<PatternMatches>& matches,
+                                   const uint8_t* data, size_t size, uint32_t dataRva, uint32_t sectionKind, uint32_t title) {
+    AddCandidates(GetSignatures(), candidates, matches, data, size, dataRva, sectionKind, title);
+}
+
+void OffsetScanCore::AddCandidates(const std::vector<OffsetSignature>& signatures, std::vector<OffsetCandidates>& candidates,
+                                   const std::vector<PatternMatches>& matches, const uint8_t* data, size_t size,
+                                   uint32_t dataRva, uint32_t sectionKind, uint32_t title) {
+    candidates.resize(signatures.size());
+
+    // matches va por id del scanner: las firmas ancladas en cadena y las de otros títulos no tienen patrón
+    size_t patternId = 0;
+    for (size_t id = 0; id < signatures.size(); ++id) {
+        if (signatures[id].anchorString || !AppliesTo(signatures[id], title)) continue;
+        if (patternId >= matches.size()) break;
+
+        const PatternMatches& found = matches[patternId++];
+        if (!(signatures[id].sections & sectionKind)) continue;
+
+        candidates[id].matchCount += found.count;
+        for (const uint8_t* match : found.candidates) {
+            if (candidates[id].sites.size() >= MaxCandidates) break;
+
+            const size_t offset = static_cast<size_t>(match - data);
+            OffsetSite site;
+            site.bytes = match;
+            site.available = size - offset;
+            site.rva = dataRva + static_cast<uint32_t>(offset);
+            candidates[id].sites.push_back(site);
+        }
+    }
+}
+
+void OffsetScanCore::AddStringAnchoredCandidates(std::vector<OffsetCandidates>& candidates, const StringIndex& strings,
+                                                 const XrefIndex& xrefs, ImageReadFunction read, void* context,
+                                                 uint32_t title) {
+    AddStringAnchoredCandidates(GetSignatures(), candidates, strings, xrefs, read, context, title);
+}
+
+void OffsetScanCore::AddStringAnchoredCandidates(const std::vector<OffsetSignature>& signatures,
+                                                 std::vector<OffsetCandidates>& candidates, const StringIndex& strings,
+                                                 const XrefIndex& xrefs, ImageReadFunction read, void* context,
+                                                 uint32_t title) {
+    candidates.resize(signatures.size());
+
+    std::vector<uint32_t> stringRvas;
+    for (size_t id = 0; id < signatures.size(); ++id) {
+        const OffsetSignature& signature = signatures[id];
+        if (!signature.anchorString || !AppliesTo(signature, title) || signature.windowEnd <= signature.windowBegin) continue;
+
+        strings.Find(signature.anchorString, stringRvas);
+        for (uint32_t stringRva : stringRvas) {
+            const XrefSpan references = xrefs.FindReferencesTo(stringRva);
+            for (const uint32_t* site = references.begin; site != references.end; ++site) {
+                // Solo lea reg, [rip + cadena] (con o sin REX)
+                size_t available = 0;
+                const uint8_t* code = read(context, *site, X86Decoder::MaxInstructionLength, available);
+                X86Instruction instruction;
+                if (!code || !X86Decoder::Decode(code, available, instruction) ||
+                    instruction.opcodeMap != 0 || instruction.opcode != 0x8D || !instruction.ripRelative) {
+                    continue;
+                }
+
+                // Ventana alrededor del lea, con margen para resolver el último match
+                const int64_t windowStart = static_cast<int64_t>(*site) + signature.windowBegin;
+                if (windowStart < 0) continue;
+                const size_t positions = static_cast<size_t>(signature.windowEnd - signature.windowBegin);
+                const uint8_t* window = read(context, static_cast<uint32_t>(windowStart),
+                                             positions + GetSiteLength(signature), available);
+                if (!window) continue;
+
+                size_t offset = 0;
+                while (offset < positions && offset < available) {
+                    const uint8_t* match = PatternScanner::FindFirst(window + offset, available - offset, signature.pattern);
+                    if (!match || static_cast<size_t>(match - window) >= positions) break;
+
+                    offset = static_cast<size_t>(match - window);
+                    candidates[id].matchCount++;
+                    if (candidates[id].sites.size() < MaxCandidates) {
+                        OffsetSite candidate;
+                        candidate.bytes = match;
+                        candidate.available = available - offset;
+                        candidate.rva = static_cast<uint32_t>(windowStart) + static_cast<uint32_t>(offset);
+                        candidates[id].sites.push_back(candidate);
+                    }
+                    offset++;
+                }
+            }
+        }
+    }
+}
+
+bool OffsetScanCore::ResolveTargetRva(const OffsetSignature& signature, const OffsetSite& site, uint32_t& targetRva) {
+    if (!site.bytes) return false;
+
+    // En RVAs de 32 bits: un disp negativo da la RVA correcta
+    uint64_t target = 0;
+    if (!X86Decoder::ResolveRipOperand(site.bytes, site.available, signature.pattern.view.length, site.rva,
+                                       signature.operandIndex, target)) {
+        return false;
+    }
+    targetRva = static_cast<uint32_t>(target);
+    return true;
+}
+
+bool OffsetScanCore::CheckConstraints(const OffsetSignature& signature, const OffsetSite& site, uint32_t targetRva,
+                                      const PEImage* image) {
+    if (signature.targetSections && image) {
+        const PESection* section = image->FindSectionByRva(targetRva);
+        if (!section || !(section->kind & signature.targetSections)) return false;
+    }
+
+    if (signature.followUp.length) {
+        if (signature.followUpOffset + signature.followUp.length > site.available) return false;
+        if (!PatternScanner::MatchAt(site.bytes + signature.followUpOffset, signature.followUp)) return false;
+    }
+    return true;
+}
+
+OffsetMatch OffsetScanCore::SelectCandidate(const OffsetSignature& signature, const OffsetCandidates& candidates,
+                                            const PEImage* image) {
+    OffsetMatch match;
+    match.field = signature.field;
+    match.matchCount = static_cast<uint32_t>(candidates.matchCount);
+    if (!candidates.sites.empty()) match.siteRva = candidates.sites.front().rva;
+
+    for (const OffsetSite& site : candidates.sites) {
+        uint32_t targetRva = 0;
+        if (!ResolveTargetRva(signature, site, targetRva)) continue;
+        if (!CheckConstraints(signature, site, targetRva, image)) continue;
+
+        match.candidateCount++;
+        if (!match.found) {
+            match.found = true;
+            match.siteRva = site.rva;
+            match.targetRva = targetRva;
+        }
+        else if (targetRva != match.targetRva) {
+            match.ambiguous = true;
+        }
+    }
+
+    // Más matches de los que se han podido mirar: no se sabe si el elegido es el bueno
+    if (match.found && candidates.matchCount > candidates.sites.size()) match.ambiguous = true;
+
+    if (match.ambiguous) match.found = false;
+    return match;
+}
+
+std::vector<OffsetMatch> OffsetScanCore::ResolveMatches(const std::vector<OffsetCandidates>& candidates, const PEImage* image) {
+    return ResolveMatches(GetSignatures(), candidates, image);
+}
+
+std::vector<OffsetMatch> OffsetScanCore::ResolveMatches(const std::vector<OffsetSignature>& signatures,
+                                                        const std::vector<OffsetCandidates>& candidates, const PEImage* image) {
+
+    std::vector<OffsetMatch> matches(signatures.size());
+    for (size_t id = 0; id < signatures.size(); ++id) {
+        matches[id] = SelectCandidate(signatures[id], id < candidates.size() ? candidates[id] : OffsetCandidates(), image);
+    }
+    return matches;
+}
+
+std::vector<OffsetResolution> OffsetScanCore::ScoreMatches(const std::vector<OffsetMatch>& matches) {
+    return ScoreMatches(GetSignatures(), matches);
+}
+
+std::vector<OffsetResolution> OffsetScanCore::ScoreMatches(const std::vector<OffsetSignature>& signatures,
+                                                           const std::vector<OffsetMatch>& matches) {
+    const std::vector<uint32_t> fields = GetFields(signatures);
+
+    std::vector<OffsetResolution> resolutions(fields.size());
+    for (size_t f = 0; f < fields.size(); ++f) {
+        OffsetResolution& resolution = resolutions[f];
+        resolution.field = fields[f];
+
+        // Pocas firmas por campo: se cuentan los votos de cada destino directamente
+        uint32_t resolvedCount = 0;
+        for (size_t id = 0; id < signatures.size() && id < matches.size(); ++id) {
+            if (signatures[id].field != fields[f] || !matches[id].found) continue;
+            resolvedCount++;
+
+            uint32_t votes = 0;
+            for (size_t other = 0; other < signatures.size() && other < matches.size(); ++other) {
+                if (signatures[other].field == fields[f] && matches[other].found &&
+                    matches[other].targetRva == matches[id].targetRva) {
+                    votes++;
+                }
+            }
+
+            // Las firmas van por rank: la primera con más votos es la de menor rank de su destino
+            if (votes > resolution.agreeing) {
+                resolution.found = true;
+                resolution.agreeing = votes;
+                resolution.siteRva = matches[id].siteRva;
+                resolution.targetRva = matches[id].targetRva;
+                resolution.signatureIndex = id;
+            }
+        }
+
+        if (!resolution.found) continue;
+
+        resolution.conflicting = resolvedCount - resolution.agreeing;
+        resolution.confidence = ComputeConfidence(resolution.agreeing, resolution.conflicting);
+
+        // Un empate no se decide por rank: la firma "principal" puede ser la que matchea basura
+        if (resolution.conflicting >= resolution.agreeing) {
+            resolution.contested = true;
+            resolution.found = false;
+        }
+    }
+    return resolutions;
+}
+
+uint8_t OffsetScanCore::ComputeConfidence(uint32_t agreeing, uint32_t conflicting) {
+    if (conflicting >= agreeing) return 0;
+
+    const uint32_t resolvedCount = agreeing + conflicting;
+    const uint32_t scale = resolvedCount > 2 ? resolvedCount : 2;
+    return static_cast<uint8_t>(100 * (agreeing - conflicting) / scale);
+}
+
+// ============================================================================
+// Re-escaneo incremental
+// ============================================================================
+
+size_t OffsetScanCore::GetMaxPatternLength(uint32_t title) {
+    size_t length = 0;
+    for (const OffsetSignature& signature : GetSignatures()) {
+        if (signature.anchorString || !AppliesTo(signature, title)) continue;
+        if (signature.pattern.view.length > length) length = signature.pattern.view.length;
+    }
+    return length;
+}
+
+void OffsetScanCore::BuildRescanWindows(const std::vector<DirtyRange>& dirty, const PEImage& image, uint32_t title,
+                                        std::vector<RescanWindow>& windows) {
+    windows.clear();
+    const size_t margin = GetMaxPatternLength(title);
+    if (margin == 0) return;
+
+    for (const DirtyRange& range : dirty) {
+        const PESection* section = image.FindSectionByRva(range.rva);
+        if (!section || range.size == 0) continue;
+
+        const uint64_t sectionBegin = section->virtualAddress;
+        const uint64_t sectionEnd = sectionBegin + section->virtualSize;
+        const uint64_t dirtyEnd = static_cast<uint64_t>(range.rva) + range.size;
+
+        const uint64_t begin = range.rva - sectionBegin >= margin - 1 ? range.rva - (margin - 1) : sectionBegin;
+        const uint64_t candidateEnd = dirtyEnd < sectionEnd ? dirtyEnd : sectionEnd;
+        const uint64_t scanEnd = candidateEnd + (margin - 1) < sectionEnd ? candidateEnd + (margin - 1) : sectionEnd;
+        if (candidateEnd <= begin) continue;
+
+        // Tramos sucios cercanos de la misma sección: una sola ventana
+        if (!windows.empty()) {
+            RescanWindow& last = windows.back();
+            const uint64_t lastCandidateEnd = static_cast<uint64_t>(last.rva) + last.candidateSize;
+            if (last.rva >= sectionBegin && last.rva < sectionEnd && begin <= lastCandidateEnd) {
+                last.candidateSize = static_cast<uint32_t>(candidateEnd - last.rva);
+                last.scanSize = static_cast<uint32_t>(scanEnd - last.rva);
+                continue;
+            }
+        }
+
+        RescanWindow window;
+        window.rva = static_cast<uint32_t>(begin);
+        window.candidateSize = static_cast<uint32_t>(candidateEnd - begin);
+        window.scanSize = static_cast<uint32_t>(scanEnd - begin);
+        window.sectionKind = section->kind;
+        windows.push_back(window);
+    }
+}
+
+void OffsetScanCore::DropCandidates(std::vector<OffsetCandidates>& candidates, const std::vector<RescanWindow>& windows) {
+    for (OffsetCandidates& signature : candidates) {
+        auto inWindow = [&](const OffsetSite& site) {
+            for (const RescanWindow& window : windows) {
+                if (site.rva >= window.rva && site.rva - window.rva < window.candidateSize) return true;
+            }
+            return false;
+        };
+
+        const size_t before = signature.sites.size();
+        signature.sites.erase(std::remove_if(signature.sites.begin(), signature.sites.end(), inWindow),
+            signature.sites.end());
+        signature.matchCount -= before - signature.sites.size();
+    }
+}
+
+bool OffsetScanCore::CanRescanIncrementally(const std::vector<OffsetCandidates>& candidates) {
+    for (const OffsetCandidates& signature : candidates) {
+        if (signature.matchCount != signature.sites.size()) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Escaneo sobre buffer
+// ============================================================================
+
+namespace {
+
+struct ImageBufferReader {
+    const PEImage* image;
+};
+
+// ImageReadFunction sobre el buffer de PEImage::Parse: sin copias
+const uint8_t* ReadImageBuffer(void* context, uint32_t rva, size_t size, size_t& available) {
+    const PEImage& image = *static_cast<ImageBufferReader*>(context)->image;
+    const PESection* section = image.FindSectionByRva(rva);
+    if (!section) return nullptr;
+
+    size_t sectionSize = 0;
+    const uint8_t* data = image.GetSectionData(*section, sectionSize);
+    const size_t offset = rva - section->virtualAddress;
+    if (!data || offset >= sectionSize) return nullptr;
+
+    available = sectionSize - offset < size ? sectionSize - offset : size;
+    return data + offset;
+}
+
+} // namespace
+
+std::vector<OffsetMatch> OffsetScanCore::ScanImage(const PEImage& image, const ScanOptions& options, uint32_t title) {
+    return ScanImage(GetSignatures(), image, options, title);
+}
+
+std::vector<OffsetMatch> OffsetScanCore::ScanImage(const std::vector<OffsetSignature>& signatures, const PEImage& image,
+                                                   const ScanOptions& options, uint32_t title) {
+    std::vector<OffsetCandidates> candidates(signatures.size());
+    if (!image.IsValid()) return ResolveMatches(signatures, candidates, nullptr);
+
+    MultiPatternScanner scanner;
+    BuildScanner(signatures, scanner, title);
+    const uint32_t sectionMask = GetSectionMask(signatures);
+
+    // Secciones en orden de cabecera: los candidatos quedan en orden de RVA
+    for (const PESection& section : image.GetSections()) {
+        if (!(section.kind & sectionMask)) continue;
+
+        size_t size = 0;
+        const uint8_t* data = image.GetSectionData(section, size);
+        if (!data || size == 0) continue;
+
+        std::vector<PatternMatches> matches;
+        ParallelPatternScanner::FindAll(data, size, scanner, options, matches, MaxCandidates);
+        AddCandidates(signatures, candidates, matches, data, size, section.virtualAddress, section.kind, title);
+    }
+
+    // Firmas ancladas en cadena: índices de cadenas y xrefs en lugar de otra pasada con patrones
+    if (HasStringAnchors(signatures, title)) {
+        StringIndex strings;
+        XrefIndex xrefs;
+        strings.Build(image);
+        xrefs.Build(image);
+        ImageBufferReader reader = { &image };
+        AddStringAnchoredCandidates(signatures, candidates, strings, xrefs, ReadImageBuffer, &reader, title);
+    }
+
+    return ResolveMatches(signatures, candidates, &image);
+}
+
+// ============================================================================
+// Perfil
+// ============================================================================
+
+OffsetCacheKey OffsetScanCore::MakeKey(const PEImage& image, uint32_t gameVersion, uint32_t gamePlatform) {
+    OffsetCacheKey key;
+    key.timeDateStamp = image.GetTimeDateStamp();
+    key.sizeOfImage = image.GetSizeOfImage();
+    key.checkSum = image.GetCheckSum();
+    key.gameVersion = gameVersion;
+    key.gamePlatform = gamePlatform;
+    return key;
+}
+
+OffsetCacheRecord OffsetScanCore::BuildRecord(const OffsetCacheKey& key, const std::vector<OffsetResolution>& resolutions) {
+    const std::vector<OffsetSignature>& signatures = GetSignatures();
+
+    OffsetCacheRecord record;
+    record.key = key;
+
+    for (const OffsetResolution& resolution : resolutions) {
+        if (!resolution.found || resolution.targetRva >= key.sizeOfImage) continue;
+        if (resolution.signatureIndex >= signatures.size()) continue;
+
+        const OffsetSignature& signature = signatures[resolution.signatureIndex];
+        OffsetCacheEntry entry = OffsetCache::MakeEntry(resolution.field, resolution.siteRva, resolution.targetRva,
+                                                        signature.pattern.view);
+        entry.signatureRank = static_cast<uint8_t>(signature.rank);
+        entry.confidence = resolution.confidence;
+        record.entries.push_back(entry);
+    }
+    return record;
+}
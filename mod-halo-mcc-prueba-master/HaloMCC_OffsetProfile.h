@@ -0,0 +1,214 @@
+// HaloMCC_OffsetProfile.h
+// Núcleo portable del escaneo de offsets: tabla de firmas, resolución del disp32 y el
+// perfil (registro de OffsetCache) que carga el DLL. Sin windows.h: lo comparten el DLL
+// y la herramienta offline de tools/.
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "HaloMCC_PatternScanner.h"
+#include "HaloMCC_PEImage.h"
+#include "HaloMCC_ParallelScan.h"
+#include "HaloMCC_OffsetCache.h"
+#include "HaloMCC_XrefIndex.h"
+#include "HaloMCC_StringIndex.h"
+#include "HaloMCC_PageHash.h"
+
+// Módulos que escanea el mod: el ejecutable de MCC y la DLL de cada juego, que MCC carga al
+// arrancar el título
+enum OffsetTitle : uint32_t {
+    TITLE_MCC = 0,          // MCC-Win64-Shipping.exe / MCCWinStore-Win64-Shipping.exe
+    TITLE_HALO1,            // halo1.dll
+    TITLE_HALO2,            // halo2.dll
+    TITLE_HALO2A,           // groundhog.dll (multijugador de Halo 2 Anniversary)
+    TITLE_HALO3,            // halo3.dll
+    TITLE_HALO3ODST,        // halo3odst.dll
+    TITLE_REACH,            // haloreach.dll
+    TITLE_HALO4,            // halo4.dll
+    TITLE_COUNT
+};
+
+const uint32_t TITLE_MASK_ALL = (1u << TITLE_COUNT) - 1;
+
+struct OffsetTitleInfo {
+    uint32_t title = TITLE_MCC;
+    const char* moduleName = "";        // en minúsculas
+    uint32_t gameVersion = 0;           // GameVersion para la clave de caché
+    const char* name = "";
+};
+
+// Firma de un offset: alguna instrucción del match lleva un operando [rip + disp32] al global.
+// Cada campo tiene varias firmas alternativas que se buscan en la misma pasada
+struct OffsetSignature {
+    uint32_t field = 0;                 // OffsetField
+    uint32_t rank = 0;                  // 0 = principal, 1.. = alternativas en orden de preferencia
+    uint32_t titles = TITLE_MASK_ALL;   // bits (1 << OffsetTitle) de los módulos donde se busca
+    const char* name = "";
+    uint32_t sections = SECTION_CODE;   // SectionKind donde se busca
+    uint32_t operandIndex = 0;          // operando RIP-relative a resolver (0 = el primero del match)
+    PreparedPattern pattern;            // vista a una Signature constexpr
+
+    // Restricciones secundarias para elegir entre varios matches de la firma
+    uint32_t targetSections = 0;        // SectionKind donde debe caer el destino (0 = cualquiera)
+    PatternView followUp;               // bytes esperados en match + followUpOffset (length 0 = no se mira)
+    size_t followUpOffset = 0;
+
+    // Firma anclada en cadena: no se escanea la imagen. Se buscan los 'lea reg, [rip + cadena]'
+    // de anchorString y 'pattern' (corta) se busca en [lea + windowBegin, lea + windowEnd)
+    const char* anchorString = nullptr; // nullptr = firma normal
+    int32_t windowBegin = 0;
+    int32_t windowEnd = 0;
+};
+
+// Bytes del sitio de un match para resolverlo (en el buffer escaneado o copiados bajo SEH)
+struct OffsetSite {
+    const uint8_t* bytes = nullptr;     // nullptr = firma no encontrada
+    size_t available = 0;               // bytes legibles desde 'bytes' (firma + margen para la última instrucción)
+    uint32_t rva = 0;
+};
+
+// Todos los matches de una firma (modo enumeración)
+struct OffsetCandidates {
+    size_t matchCount = 0;              // total, aunque no quepan en sites
+    std::vector<OffsetSite> sites;      // los primeros OffsetScanCore::MaxCandidates, en orden de dirección
+};
+
+struct OffsetMatch {
+    uint32_t field = 0;
+    bool found = false;
+    uint32_t siteRva = 0;
+    uint32_t targetRva = 0;
+
+    uint32_t matchCount = 0;            // matches de la firma en todo el escaneo (1 = única)
+    uint32_t candidateCount = 0;        // matches que se resuelven y cumplen las restricciones
+    bool ambiguous = false;             // candidatos válidos con destinos distintos: no se usa ninguno
+};
+
+// Resultado de un campo tras puntuar sus firmas. Cada firma que resuelve un destino es un
+// voto: dos firmas distintas que llegan al mismo global son un acierto fuerte
+struct OffsetResolution {
+    uint32_t field = 0;
+    bool found = false;
+    uint32_t siteRva = 0;               // sitio de la firma ganadora
+    uint32_t targetRva = 0;
+    size_t signatureIndex = 0;          // índice en GetSignatures() de la firma ganadora
+    uint32_t agreeing = 0;              // firmas que resuelven al destino ganador
+    uint32_t conflicting = 0;           // firmas que resuelven a otro destino
+    uint8_t confidence = 0;             // 0-100
+    bool contested = false;             // conflicting >= agreeing: found = false, no se elige ninguno
+};
+
+// Ventana de re-escaneo incremental alrededor de un tramo de páginas sucias: se vuelven a
+// buscar todos los matches que empiezan en [rva, rva + candidateSize) y se leen los bytes
+// hasta rva + scanSize (el último match puede salirse del tramo)
+struct RescanWindow {
+    uint32_t rva = 0;
+    uint32_t candidateSize = 0;
+    uint32_t scanSize = 0;
+    uint32_t sectionKind = 0;
+};
+
+// Lectura de un rango de la imagen por RVA. Devuelve un puntero que sigue siendo válido hasta
+// que acaba la resolución (el buffer del fichero, o una copia hecha bajo SEH en el DLL) y
+// en 'available' los bytes legibles (puede ser menos que 'size'); nullptr si no se puede leer
+typedef const uint8_t* (*ImageReadFunction)(void* context, uint32_t rva, size_t size, size_t& available);
+
+class OffsetScanCore {
+public:
+    // Candidatos que se guardan por firma; si hay más, la firma se da por ambigua
+    static const size_t MaxCandidates = 32;
+
+    // Ordenadas por campo y rank
+    static const std::vector<OffsetSignature>& GetSignatures();
+    static const OffsetSignature* FindSignature(uint32_t field, uint32_t rank = 0);
+    // Campos distintos, en el orden de GetSignatures()
+    static std::vector<uint32_t> GetFields();
+    static const char* FieldToString(uint32_t field);
+    // Unión de las secciones de todas las firmas
+    static uint32_t GetSectionMask();
+
+    // Tabla de módulos de título; nombre sin ruta, sin distinguir mayúsculas
+    static const std::vector<OffsetTitleInfo>& GetTitles();
+    static const OffsetTitleInfo* FindTitle(uint32_t title);
+    static const OffsetTitleInfo* FindTitleByModule(const char* moduleName);
+    static bool AppliesTo(const OffsetSignature& signature, uint32_t title);
+
+    // Un patrón por firma de escaneo del título, en el orden de GetSignatures(); las ancladas
+    // en cadena y las de otros títulos no entran (AddCandidates deshace el mapeo)
+    static void BuildScanner(MultiPatternScanner& scanner, uint32_t title);
+    static bool HasStringAnchors(uint32_t title);
+
+    // Bytes del sitio necesarios para resolver y comprobar las restricciones de la firma
+    static size_t GetSiteLength(const OffsetSignature& signature);
+
+    // Añade los matches de una sección (MultiPatternScanner::FindAll sobre [data, data + size))
+    // a los candidatos de las firmas que buscan en sectionKind. matches viene de BuildScanner(title)
+    static void AddCandidates(std::vector<OffsetCandidates>& candidates, const std::vector<PatternMatches>& matches,
+                              const uint8_t* data, size_t size, uint32_t dataRva, uint32_t sectionKind, uint32_t title);
+
+    // Candidatos de las firmas ancladas en cadena: cadena (strings) -> lea que la cargan
+    // (xrefs) -> firma corta en la ventana alrededor del lea. Las ventanas se leen con 'read'
+    static void AddStringAnchoredCandidates(std::vector<OffsetCandidates>& candidates, const StringIndex& strings,
+                                           const XrefIndex& xrefs, ImageReadFunction read, void* context, uint32_t title);
+
+    // Decodifica las instrucciones del match y resuelve el operando operandIndex
+    static bool ResolveTargetRva(const OffsetSignature& signature, const OffsetSite& site, uint32_t& targetRva);
+    // Destino en una sección de targetSections y followUp presente. image = nullptr no mira secciones
+    static bool CheckConstraints(const OffsetSignature& signature, const OffsetSite& site, uint32_t targetRva,
+                                 const PEImage* image);
+    // Elige entre los candidatos de una firma. Varios candidatos válidos con el mismo destino
+    // valen (el global se usa en varios sitios); con destinos distintos la firma es ambigua
+    static OffsetMatch SelectCandidate(const OffsetSignature& signature, const OffsetCandidates& candidates,
+                                       const PEImage* image);
+    // Todas las firmas de una vez: candidates[id] corresponde a GetSignatures()[id]
+    static std::vector<OffsetMatch> ResolveMatches(const std::vector<OffsetCandidates>& candidates, const PEImage* image);
+
+    // Un resultado por campo (orden de GetFields()). Gana el destino con más firmas de
+    // acuerdo; a igualdad, el de la firma de menor rank. Si hay tantas en conflicto como de
+    // acuerdo el campo queda contested y sin resolver: quien escanea decide (caché o nada)
+    static std::vector<OffsetResolution> ScoreMatches(const std::vector<OffsetMatch>& matches);
+    // 100 * (de acuerdo - en conflicto) / max(de acuerdo + en conflicto, 2): una firma sola se
+    // queda en 50, dos que coinciden llegan a 100, 2 contra 1 baja a 33 y un empate es 0
+    static uint8_t ComputeConfidence(uint32_t agreeing, uint32_t conflicting);
+
+    // Re-escaneo incremental. Un match que toca una página sucia empieza como mucho
+    // GetMaxPatternLength() - 1 bytes antes: las ventanas cubren eso, se recortan a su
+    // sección y se unen si se solapan. Los candidatos que empiezan en una ventana se quitan
+    // (DropCandidates) y se vuelven a añadir con lo que salga de escanearla (AddCandidates)
+    static size_t GetMaxPatternLength(uint32_t title);
+    static void BuildRescanWindows(const std::vector<DirtyRange>& dirty, const PEImage& image, uint32_t title,
+                                   std::vector<RescanWindow>& windows);
+    static void DropCandidates(std::vector<OffsetCandidates>& candidates, const std::vector<RescanWindow>& windows);
+    // Solo si se guardaron todos los matches: con sites recortado a MaxCandidates no se sabe
+    // qué matches habría fuera de las ventanas
+    static bool CanRescanIncrementally(const std::vector<OffsetCandidates>& candidates);
+
+    // Escaneo de una imagen que está entera en el buffer pasado a PEImage::Parse
+    // (fichero mapeado o copia). Enumera todos los matches en una pasada por sección.
+    // Un OffsetMatch por firma, en el orden de GetSignatures()
+    static std::vector<OffsetMatch> ScanImage(const PEImage& image, const ScanOptions& options, uint32_t title);
+
+    // Lo mismo sobre una tabla de firmas que no es GetSignatures() (ordenada igual, por campo
+    // y rank): los tests montan alternativas e imágenes sintéticas sin tocar la tabla real
+    static std::vector<uint32_t> GetFields(const std::vector<OffsetSignature>& signatures);
+    static uint32_t GetSectionMask(const std::vector<OffsetSignature>& signatures);
+    static void BuildScanner(const std::vector<OffsetSignature>& signatures, MultiPatternScanner& scanner, uint32_t title);
+    static bool HasStringAnchors(const std::vector<OffsetSignature>& signatures, uint32_t title);
+    static void AddCandidates(const std::vector<OffsetSignature>& signatures, std::vector<OffsetCandidates>& candidates,
+                              const std::vector<PatternMatches>& matches, const uint8_t* data, size_t size,
+                              uint32_t dataRva, uint32_t sectionKind, uint32_t title);
+    static void AddStringAnchoredCandidates(const std::vector<OffsetSignature>& signatures,
+                                           std::vector<OffsetCandidates>& candidates, const StringIndex& strings,
+                                           const XrefIndex& xrefs, ImageReadFunction read, void* context, uint32_t title);
+    static std::vector<OffsetMatch> ResolveMatches(const std::vector<OffsetSignature>& signatures,
+                                                   const std::vector<OffsetCandidates>& candidates, const PEImage* image);
+    static std::vector<OffsetResolution> ScoreMatches(const std::vector<OffsetSignature>& signatures,
+                                                      const std::vector<OffsetMatch>& matches);
+    static std::vector<OffsetMatch> ScanImage(const std::vector<OffsetSignature>& signatures, const PEImage& image,
+                                              const ScanOptions& options, uint32_t title);
+
+    static OffsetCacheKey MakeKey(const PEImage& image, uint32_t gameVersion, uint32_t gamePlatform);
+    // Registro de caché a partir de los campos resueltos; descarta destinos fuera de la imagen.
+    // Cada entrada guarda los bytes de la firma ganadora, su rank y la confianza
+    static OffsetCacheRecord BuildRecord(const OffsetCacheKey& key, const std::vector<OffsetResolution>& resolutions);
+};
@@ -1,11 +1,18 @@
 #include "pch.h"
 #include "HaloMCC_OffsetScanner.h"
+#include "HaloMCC_PatternScanner.h"
+#include "HaloMCC_PEImage.h"
+#include "HaloMCC_ThreadPool.h"
+#include "HaloMCC_OffsetCache.h"
+#include "HaloMCC_X86Decoder.h"
+#include "HaloMCC_AsyncLog.h"
 #include "SEHHelpers.h"
 #include <psapi.h>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <algorithm>
 
 #pragma comment(lib, "psapi.lib")
 
@@ -13,55 +20,42 @@
 static std::string ToHexString(uintptr_t value);
 static void LogToFile(const std::string& message);
 
-// ============================================================================
-// Implementaciones de ScanPatterns
-// ============================================================================
+namespace {
 
-std::vector<uint8_t> HaloMCCOffsetScanner::ScanPatterns::GetSplitScreenCheckPattern() {
-    return {
-        0x83, 0x3D, 0x00, 0x00, 0x00, 0x00, 0x01,
-        0x0F, 0x84, 0x00, 0x00, 0x00, 0x00
-    };
-}
+// Copias bajo SEH de las ventanas que pide OffsetScanCore::AddStringAnchoredCandidates;
+// viven hasta que acaba la resolución
+struct ModuleCopyReader {
+    uintptr_t baseAddress;
+    size_t moduleSize;
+    std::vector<std::vector<uint8_t>> copies;
+};
 
-std::vector<bool> HaloMCCOffsetScanner::ScanPatterns::GetSplitScreenCheckMask() {
-    return {
-        true, true, false, false, false, false, true,
-        true, true, false, false, false, false
-    };
-}
+const uint8_t* ReadModuleCopy(void* context, uint32_t rva, size_t size, size_t& available) {
+    ModuleCopyReader& reader = *static_cast<ModuleCopyReader*>(context);
+    if (rva >= reader.moduleSize) return nullptr;
+    if (size > reader.moduleSize - rva) size = reader.moduleSize - rva;
 
-std::vector<uint8_t> HaloMCCOffsetScanner::ScanPatterns::GetPlayerCountPattern() {
-    return {
-        0x8B, 0x05, 0x00, 0x00, 0x00, 0x00,
-        0x83, 0xF8, 0x01,
-        0x7E, 0x00
-    };
-}
+    std::vector<uint8_t> copy(size);
+    if (!SEH_MemReadRaw(reader.baseAddress + rva, copy.data(), size)) return nullptr;
 
-std::vector<bool> HaloMCCOffsetScanner::ScanPatterns::GetPlayerCountMask() {
-    return {
-        true, true, false, false, false, false,
-        true, true, true,
-        true, false
-    };
+    reader.copies.push_back(std::move(copy));
+    available = size;
+    return reader.copies.back().data();
 }
 
-std::vector<uint8_t> HaloMCCOffsetScanner::ScanPatterns::GetCameraMatrixPattern() {
-    return {
-        0x0F, 0x10, 0x05, 0x00, 0x00, 0x00, 0x00,
-        0x0F, 0x11, 0x01,
-        0x0F, 0x10, 0x0D, 0x00, 0x00, 0x00, 0x00
-    };
-}
+} // namespace
 
-std::vector<bool> HaloMCCOffsetScanner::ScanPatterns::GetCameraMatrixMask() {
-    return {
-        true, true, true, false, false, false, false,
-        true, true, true,
-        true, true, true, false, false, false, false
-    };
-}
+ScanOptions HaloMCCOffsetScanner::scanOptions;
+XrefIndex HaloMCCOffsetScanner::xrefIndex;
+StringIndex HaloMCCOffsetScanner::stringIndex;
+std::mutex HaloMCCOffsetScanner::cacheMutex;
+std::mutex HaloMCCOffsetScanner::scanStateMutex;
+std::vector<HaloMCCOffsetScanner::ScanState> HaloMCCOffsetScanner::scanStates;
+ModuleWatcher HaloMCCOffsetScanner::titleWatcher;
+std::mutex HaloMCCOffsetScanner::titleMutex;
+std::vector<TitleOffsets> HaloMCCOffsetScanner::titles;
+TitleOffsetsCallback HaloMCCOffsetScanner::titleCallback = nullptr;
+uint32_t HaloMCCOffsetScanner::titlePlatform = 0;
 
 // ============================================================================
 // Métodos privados
@@ -85,119 +79,570 @@ HMODULE HaloMCCOffsetScanner::GetGameModule() {
     return GetModuleHandleA(nullptr);
 }
 
-bool HaloMCCOffsetScanner::PatternMatch(uintptr_t address, const std::vector<uint8_t>& pattern, const std::vector<bool>& mask) {
-    if (pattern.empty() || mask.empty() || pattern.size() != mask.size()) return false;
-    
-    std::vector<unsigned char> maskBuf(mask.size());
-    for (size_t i = 0; i < mask.size(); ++i) {
-        maskBuf[i] = mask[i] ? 1 : 0;
+std::vector<OffsetMatch> HaloMCCOffsetScanner::ResolveMatches(uintptr_t baseAddress, const std::vector<OffsetCandidates>& found,
+                                                              const PEImage* image, uint32_t title) {
+    const std::vector<OffsetSignature>& signatures = OffsetScanCore::GetSignatures();
+
+    // Copia bajo SEH de cada candidato (firma + margen para la última instrucción); el
+    // decodificador trabaja sobre las copias
+    size_t stride = 0;
+    size_t siteCount = 0;
+    for (size_t id = 0; id < signatures.size(); ++id) {
+        const size_t length = OffsetScanCore::GetSiteLength(signatures[id]);
+        if (length > stride) stride = length;
+        if (id < found.size()) siteCount += found[id].sites.size();
     }
-    
-    return SEH_PatternMatchRaw(address, pattern.data(), maskBuf.data(), pattern.size());
-}
 
-uintptr_t HaloMCCOffsetScanner::ScanSplitScreenCheck(uintptr_t baseAddress, size_t moduleSize) {
-    LogToFile("Buscando patrón de verificación split-screen...");
+    std::vector<uint8_t> siteBytes(siteCount * stride);
+    std::vector<OffsetCandidates> candidates(signatures.size());
+    size_t slot = 0;
+    for (size_t id = 0; id < signatures.size() && id < found.size(); ++id) {
+        candidates[id].matchCount = found[id].matchCount;
+
+        for (const OffsetSite& live : found[id].sites) {
+            const uintptr_t address = reinterpret_cast<uintptr_t>(live.bytes);
+            uint8_t* copy = siteBytes.data() + slot++ * stride;
+            size_t length = OffsetScanCore::GetSiteLength(signatures[id]);
+            if (!SEH_MemReadRaw(address, copy, length)) {
+                // El margen puede caer en una página sin leer: solo la firma
+                length = signatures[id].pattern.view.length;
+                if (!SEH_MemReadRaw(address, copy, length)) {
+                    // Sitio ilegible: deja de contar como match, si no SelectCandidate vería más
+                    // matches que sitios y daría la firma por ambigua
+                    candidates[id].matchCount--;
+                    continue;
+                }
+            }
 
-    auto pattern = ScanPatterns::GetSplitScreenCheckPattern();
-    auto mask = ScanPatterns::GetSplitScreenCheckMask();
+            OffsetSite site;
+            site.bytes = copy;
+            site.available = length;
+            site.rva = live.rva;
+            candidates[id].sites.push_back(site);
+        }
+    }
 
-    for (size_t i = 0; i <= moduleSize - pattern.size(); i++) {
-        if (PatternMatch(baseAddress + i, pattern, mask)) {
-            uint32_t relativeAddr = 0;
-            if (SEH_MemReadRaw(baseAddress + i + 2, &relativeAddr, sizeof(uint32_t))) {
-                uintptr_t targetAddr = baseAddress + i + 7 + relativeAddr;
+    std::vector<OffsetMatch> resolved = OffsetScanCore::ResolveMatches(candidates, image);
 
-                LogToFile("✓ Split-screen check encontrado en: 0x" + ToHexString(baseAddress + i));
-                LogToFile("  -> Apunta a: 0x" + ToHexString(targetAddr));
+    for (size_t id = 0; id < resolved.size(); ++id) {
+        if (!OffsetScanCore::AppliesTo(signatures[id], title)) continue;
 
-                return targetAddr;
+        const std::string name(signatures[id].name);
+        const OffsetMatch& match = resolved[id];
+        if (match.found) {
+            LogToFile("✓ " + name + " encontrado en: 0x" + ToHexString(baseAddress + match.siteRva));
+            LogToFile("  -> Apunta a: 0x" + ToHexString(baseAddress + match.targetRva));
+            if (match.matchCount > 1) {
+                LogToFile("  ⚠ Firma no única: " + std::to_string(match.matchCount) + " matches, " +
+                    std::to_string(match.candidateCount) + " válidos con el mismo destino");
             }
         }
+        else if (match.ambiguous) {
+            LogToFile("✗ " + name + ": firma ambigua (" + std::to_string(match.matchCount) + " matches, " +
+                std::to_string(match.candidateCount) + " válidos con destinos distintos)");
+        }
+        else if (match.matchCount) {
+            LogToFile("✗ " + name + ": " + std::to_string(match.matchCount) +
+                " matches pero ninguno se resuelve o cumple las restricciones");
+        }
+        else {
+            LogToFile("✗ Patrón " + name + " no encontrado");
+        }
     }
 
-    LogToFile("✗ Patrón split-screen no encontrado");
-    return 0;
+    return resolved;
 }
 
-uintptr_t HaloMCCOffsetScanner::ScanPlayerCount(uintptr_t baseAddress, size_t moduleSize) {
-    LogToFile("Buscando patrón de conteo de jugadores...");
-
-    auto pattern = ScanPatterns::GetPlayerCountPattern();
-    auto mask = ScanPatterns::GetPlayerCountMask();
+// ============================================================================
+// Método público principal
+// ============================================================================
 
-    for (size_t i = 0; i <= moduleSize - pattern.size(); i++) {
-        if (PatternMatch(baseAddress + i, pattern, mask)) {
-            uint32_t relativeAddr = 0;
-            if (SEH_MemReadRaw(baseAddress + i + 2, &relativeAddr, sizeof(uint32_t))) {
-                uintptr_t targetAddr = baseAddress + i + 6 + relativeAddr;
+void HaloMCCOffsetScanner::SetScanOptions(const ScanOptions& options) {
+    scanOptions = options;
+}
 
-                LogToFile("✓ Player count encontrado en: 0x" + ToHexString(baseAddress + i));
-                LogToFile("  -> Apunta a: 0x" + ToHexString(targetAddr));
+ScanOptions HaloMCCOffsetScanner::GetScanOptions() {
+    return scanOptions;
+}
 
-                return targetAddr;
-            }
+std::string HaloMCCOffsetScanner::GetModuleDirectory() {
+    HMODULE self = nullptr;
+    char path[MAX_PATH] = {};
+
+    if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                           reinterpret_cast<LPCSTR>(&HaloMCCOffsetScanner::GetModuleDirectory), &self) &&
+        GetModuleFileNameA(self, path, MAX_PATH)) {
+        std::string dllPath(path);
+        size_t slash = dllPath.find_last_of("\\/");
+        if (slash != std::string::npos) {
+            return dllPath.substr(0, slash + 1);
         }
     }
 
-    LogToFile("✗ Patrón player count no encontrado");
-    return 0;
+    return "";
+}
+
+std::string HaloMCCOffsetScanner::GetCachePath() {
+    return GetModuleDirectory() + "HaloMCC_OffsetCache.bin";
+}
+
+std::string HaloMCCOffsetScanner::GetXrefIndexPath() {
+    return GetModuleDirectory() + "HaloMCC_XrefIndex.bin";
 }
 
-uintptr_t HaloMCCOffsetScanner::ScanCameraBase(uintptr_t baseAddress, size_t moduleSize) {
-    LogToFile("Buscando patrón de matriz de cámara...");
+const XrefIndex* HaloMCCOffsetScanner::GetXrefIndex() {
+    if (xrefIndex.IsReady()) return &xrefIndex;
 
-    auto pattern = ScanPatterns::GetCameraMatrixPattern();
-    auto mask = ScanPatterns::GetCameraMatrixMask();
+    uintptr_t baseAddress = 0;
+    size_t moduleSize = 0;
+    PEImage image;
+    if (!GetGameModuleRange(baseAddress, moduleSize) || !SEH_ParseLoadedImage(baseAddress, moduleSize, image)) {
+        return nullptr;
+    }
 
-    for (size_t i = 0; i <= moduleSize - pattern.size(); i++) {
-        if (PatternMatch(baseAddress + i, pattern, mask)) {
-            uint32_t relativeAddr = 0;
-            if (SEH_MemReadRaw(baseAddress + i + 3, &relativeAddr, sizeof(uint32_t))) {
-                uintptr_t targetAddr = baseAddress + i + 7 + relativeAddr;
+    // Solo depende del ejecutable, no del juego detectado
+    const OffsetCacheKey key = OffsetScanCore::MakeKey(image, 0, 0);
+    const std::string path = GetXrefIndexPath();
+    if (xrefIndex.Load(path, key)) {
+        LogToFile("✓ Índice de xrefs cargado: " + std::to_string(xrefIndex.GetCount()) + " referencias");
+        return &xrefIndex;
+    }
 
-                LogToFile("✓ Camera matrix encontrada en: 0x" + ToHexString(baseAddress + i));
-                LogToFile("  -> Base cámara: 0x" + ToHexString(targetAddr));
+    const auto start = std::chrono::steady_clock::now();
+    if (!SEH_BuildXrefIndex(baseAddress, image, xrefIndex)) {
+        // Incompleto: vale para esta sesión pero no se guarda
+        LogToFile("ADVERTENCIA: índice de xrefs incompleto (fallo leyendo código)");
+        return &xrefIndex;
+    }
 
-                return targetAddr;
-            }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LogToFile("Índice de xrefs construido: " + std::to_string(xrefIndex.GetCount()) + " referencias en " +
+        std::to_string(elapsed.count()) + " ms");
+    if (!xrefIndex.Save(path, key)) {
+        LogToFile("ADVERTENCIA: no se pudo escribir el índice de xrefs");
+    }
+    return &xrefIndex;
+}
+
+const StringIndex* HaloMCCOffsetScanner::GetStringIndex() {
+    if (stringIndex.IsReady()) return &stringIndex;
+
+    uintptr_t baseAddress = 0;
+    size_t moduleSize = 0;
+    PEImage image;
+    if (!GetGameModuleRange(baseAddress, moduleSize) || !SEH_ParseLoadedImage(baseAddress, moduleSize, image)) {
+        return nullptr;
+    }
+
+    // Barato (una pasada por .rdata): no se guarda en disco
+    if (!SEH_BuildStringIndex(baseAddress, image, stringIndex)) {
+        LogToFile("ADVERTENCIA: índice de cadenas incompleto (fallo leyendo .rdata)");
+    }
+    LogToFile("Índice de cadenas: " + std::to_string(stringIndex.GetCount()) + " cadenas");
+    return &stringIndex;
+}
+
+GameOffsets HaloMCCOffsetScanner::ScanForOffsets() {
+    LogToFile("=== Starting offset scan for Halo MCC 1.3385.0.0 ===");
+
+    uintptr_t baseAddress = 0;
+    size_t moduleSize = 0;
+    if (!GetGameModuleRange(baseAddress, moduleSize)) {
+        return GameOffsets{};
+    }
+
+    PEImage image;
+    const bool imageValid = SEH_ParseLoadedImage(baseAddress, moduleSize, image);
+
+    std::vector<OffsetResolution> resolved;
+    return ScanModule(baseAddress, moduleSize, imageValid ? &image : nullptr, TITLE_MCC, resolved);
+}
+
+GameOffsets HaloMCCOffsetScanner::LoadOrScanOffsets(uint32_t gameVersion, uint32_t gamePlatform, bool forceRescan) {
+    LogToFile("=== Starting offset scan for Halo MCC 1.3385.0.0 ===");
+
+    uintptr_t baseAddress = 0;
+    size_t moduleSize = 0;
+    if (!GetGameModuleRange(baseAddress, moduleSize)) {
+        return GameOffsets{};
+    }
+
+    return LoadOrScanModule(baseAddress, moduleSize, TITLE_MCC, gameVersion, gamePlatform, forceRescan);
+}
+
+GameOffsets HaloMCCOffsetScanner::LoadOrScanModule(uintptr_t baseAddress, size_t moduleSize, uint32_t title,
+                                                   uint32_t gameVersion, uint32_t gamePlatform, bool forceRescan) {
+    // Sin cabeceras PE válidas no hay clave fiable: escaneo completo sin caché
+    PEImage image;
+    std::vector<OffsetResolution> resolved;
+    if (!SEH_ParseLoadedImage(baseAddress, moduleSize, image)) {
+        return ScanModule(baseAddress, moduleSize, nullptr, title, resolved);
+    }
+
+    // Cada DLL de título tiene su propio TimeDateStamp: comparten fichero sin pisarse
+    const OffsetCacheKey key = OffsetScanCore::MakeKey(image, gameVersion, gamePlatform);
+    const std::string cachePath = GetCachePath();
+
+    if (!forceRescan) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        OffsetCache cache;
+        cache.Load(cachePath);
+
+        const OffsetCacheRecord* record = cache.Find(key);
+        GameOffsets cached;
+        if (record && LoadFromCache(baseAddress, moduleSize, *record, cached)) {
+            LogToFile("✓ Offsets cargados de caché (" + cachePath + ")");
+            return cached;
+        }
+        LogToFile(record ? "✗ Caché de offsets no coincide con el módulo, re-escaneando"
+                         : "Sin caché de offsets para este módulo");
+    }
+    else {
+        LogToFile("Rescan forzado: ignorando caché de offsets");
+    }
+
+    // El escaneo va sin lock: otro módulo puede estar escaneándose a la vez
+    GameOffsets offsets = ScanModule(baseAddress, moduleSize, &image, title, resolved);
+
+    // Se relee el fichero antes de escribir para no perder lo que guardó otro módulo mientras
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    OffsetCache cache;
+    cache.Load(cachePath);
+
+    // Campo con las firmas en conflicto: se mantiene el valor de caché si su sitio sigue igual
+    std::vector<OffsetCacheEntry> keptEntries;
+    const OffsetCacheRecord* cachedRecord = cache.Find(key);
+    for (const OffsetResolution& resolution : resolved) {
+        if (!resolution.contested || !cachedRecord) continue;
+
+        for (const OffsetCacheEntry& entry : cachedRecord->entries) {
+            if (entry.field != resolution.field || !VerifyCachedEntry(baseAddress, moduleSize, entry)) continue;
+
+            SetField(offsets, entry.field, baseAddress + entry.targetRva);
+            keptEntries.push_back(entry);
+            LogToFile("→ " + std::string(OffsetScanCore::FieldToString(entry.field)) + ": se mantiene el de caché 0x" +
+                ToHexString(baseAddress + entry.targetRva));
+            break;
         }
     }
+    if (!keptEntries.empty()) {
+        offsets.valid = offsets.splitScreenEnabledOffset && offsets.playerCountOffset;
+    }
 
-    LogToFile("✗ Patrón camera matrix no encontrado");
-    return 0;
+    // Solo se guardan escaneos válidos; uno fallido borra las entradas para no reutilizarlas
+    // (las cadenas de punteros del registro no dependen de las firmas y se quedan)
+    if (offsets.valid) {
+        OffsetCacheRecord record = OffsetScanCore::BuildRecord(key, resolved);
+        record.entries.insert(record.entries.end(), keptEntries.begin(), keptEntries.end());
+        cache.Store(record);
+    }
+    else {
+        const OffsetCacheRecord* previous = cache.Find(key);
+        if (previous && !previous->pointerPaths.empty()) {
+            OffsetCacheRecord kept;
+            kept.key = key;
+            kept.pointerPaths = previous->pointerPaths;
+            cache.Store(kept);
+        }
+        else {
+            cache.Remove(key);
+        }
+    }
+
+    if (cache.Save(cachePath)) {
+        LogToFile("Caché de offsets guardada: " + cachePath);
+    }
+    else {
+        LogToFile("ADVERTENCIA: no se pudo escribir la caché de offsets");
+    }
+
+    return offsets;
 }
 
 // ============================================================================
-// Método público principal
+// Módulos de título
 // ============================================================================
 
-GameOffsets HaloMCCOffsetScanner::ScanForOffsets() {
-    GameOffsets offsets;
+bool HaloMCCOffsetScanner::IsTitleModule(const std::string& name) {
+    const OffsetTitleInfo* info = OffsetScanCore::FindTitleByModule(name.c_str());
+    return info && info->title != TITLE_MCC;
+}
 
-    LogToFile("=== Starting offset scan for Halo MCC 1.3385.0.0 ===");
+void HaloMCCOffsetScanner::OnModuleEvent(const ModuleEvent& event) {
+    const OffsetTitleInfo* info = OffsetScanCore::FindTitleByModule(event.name.c_str());
+    if (!info) return;
+
+    TitleOffsets entry;
+    entry.title = info->title;
+    entry.gameVersion = info->gameVersion;
+    entry.moduleBase = event.baseAddress;
+    entry.moduleSize = event.moduleSize;
+
+    if (!event.loaded) {
+        {
+            std::lock_guard<std::mutex> lock(titleMutex);
+            auto it = std::find_if(titles.begin(), titles.end(), [&](const TitleOffsets& loaded) {
+                return loaded.title == entry.title && loaded.moduleBase == entry.moduleBase;
+            });
+            if (it == titles.end()) return;
+            entry = *it;
+            titles.erase(it);
+        }
+
+        DropScanState(entry.moduleBase);
+        LogToFile("Título descargado: " + std::string(info->name) + " (" + event.name + ")");
+        if (titleCallback) titleCallback(entry, false);
+        return;
+    }
+
+    // La enumeración inicial y el aviso del loader pueden repetir un módulo
+    {
+        std::lock_guard<std::mutex> lock(titleMutex);
+        for (const TitleOffsets& loaded : titles) {
+            if (loaded.title == entry.title && loaded.moduleBase == entry.moduleBase) return;
+        }
+    }
+
+    LogToFile("=== Título cargado: " + std::string(info->name) + " (" + event.name + ") en 0x" +
+        ToHexString(event.baseAddress) + " ===");
+    const auto start = std::chrono::steady_clock::now();
+    entry.offsets = LoadOrScanModule(event.baseAddress, event.moduleSize, info->title, info->gameVersion,
+        titlePlatform, false);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LogToFile(std::string(entry.offsets.valid ? "✓ " : "✗ ") + info->name + ": offsets " +
+        (entry.offsets.valid ? "listos" : "incompletos") + " en " + std::to_string(elapsed.count()) + " ms");
+
+    {
+        std::lock_guard<std::mutex> lock(titleMutex);
+        titles.push_back(entry);
+    }
+    if (titleCallback) titleCallback(entry, true);
+}
 
+bool HaloMCCOffsetScanner::StartTitleWatcher(uint32_t gamePlatform, TitleOffsetsCallback callback) {
+    if (titleWatcher.IsRunning()) return true;
+
+    titlePlatform = gamePlatform;
+    titleCallback = callback;
+    if (!titleWatcher.Start(&HaloMCCOffsetScanner::IsTitleModule, &HaloMCCOffsetScanner::OnModuleEvent)) {
+        LogToFile("ADVERTENCIA: sin avisos de carga de módulos, solo se usan los offsets del ejecutable");
+        return false;
+    }
+
+    LogToFile("Vigilando la carga de módulos de título");
+    return true;
+}
+
+void HaloMCCOffsetScanner::StopTitleWatcher() {
+    titleWatcher.Stop();
+    titleCallback = nullptr;
+
+    std::lock_guard<std::mutex> lock(titleMutex);
+    titles.clear();
+}
+
+bool HaloMCCOffsetScanner::GetTitleOffsets(uint32_t title, TitleOffsets& result) {
+    std::lock_guard<std::mutex> lock(titleMutex);
+    for (const TitleOffsets& loaded : titles) {
+        if (loaded.title == title) {
+            result = loaded;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<TitleOffsets> HaloMCCOffsetScanner::GetLoadedTitles() {
+    std::lock_guard<std::mutex> lock(titleMutex);
+    return titles;
+}
+
+// ============================================================================
+// Escaneo y caché
+// ============================================================================
+
+bool HaloMCCOffsetScanner::GetGameModuleRange(uintptr_t& baseAddress, size_t& moduleSize) {
     HMODULE gameModule = GetGameModule();
     if (!gameModule) {
         LogToFile("ERROR: No se pudo encontrar el módulo del juego");
-        return offsets;
+        return false;
     }
 
     MODULEINFO modInfo;
     if (!GetModuleInformation(GetCurrentProcess(), gameModule, &modInfo, sizeof(modInfo))) {
         LogToFile("ERROR: No se pudo obtener información del módulo");
-        return offsets;
+        return false;
     }
 
-    uintptr_t baseAddress = reinterpret_cast<uintptr_t>(modInfo.lpBaseOfDll);
-    size_t moduleSize = modInfo.SizeOfImage;
+    baseAddress = reinterpret_cast<uintptr_t>(modInfo.lpBaseOfDll);
+    moduleSize = modInfo.SizeOfImage;
 
     LogToFile("Módulo base: 0x" + ToHexString(baseAddress));
     LogToFile("Tamaño módulo: 0x" + ToHexString(moduleSize));
+    return true;
+}
 
-    offsets.splitScreenEnabledOffset = ScanSplitScreenCheck(baseAddress, moduleSize);
-    offsets.playerCountOffset = ScanPlayerCount(baseAddress, moduleSize);
-    offsets.cameraBaseOffset = ScanCameraBase(baseAddress, moduleSize);
+void HaloMCCOffsetScanner::SetField(GameOffsets& offsets, uint32_t field, uintptr_t address) {
+    switch (field) {
+    case OFFSET_SPLIT_SCREEN_ENABLED: offsets.splitScreenEnabledOffset = address; break;
+    case OFFSET_PLAYER_COUNT: offsets.playerCountOffset = address; break;
+    case OFFSET_CAMERA_BASE: offsets.cameraBaseOffset = address; break;
+    default: break;
+    }
+}
+
+bool HaloMCCOffsetScanner::LoadFromCache(uintptr_t baseAddress, size_t moduleSize, const OffsetCacheRecord& record, GameOffsets& offsets) {
+    offsets = GameOffsets{};
+
+    for (const OffsetCacheEntry& entry : record.entries) {
+        // Unos pocos bytes de la firma en el sitio cacheado: si cambiaron, la caché no sirve
+        if (!VerifyCachedEntry(baseAddress, moduleSize, entry)) {
+            LogToFile("✗ Sitio cacheado no coincide en RVA 0x" + ToHexString(entry.siteRva));
+            return false;
+        }
+
+        SetField(offsets, entry.field, baseAddress + entry.targetRva);
+        LogToFile("  " + std::string(OffsetScanCore::FieldToString(entry.field)) + " de caché (firma " +
+            std::to_string(entry.signatureRank) + ", confianza " + std::to_string(entry.confidence) + "%)");
+    }
+
+    offsets.valid = offsets.splitScreenEnabledOffset && offsets.playerCountOffset;
+    return offsets.valid;
+}
+
+bool HaloMCCOffsetScanner::VerifyCachedEntry(uintptr_t baseAddress, size_t moduleSize, const OffsetCacheEntry& entry) {
+    if (entry.siteRva + static_cast<size_t>(entry.verifyLength) > moduleSize || entry.targetRva >= moduleSize) {
+        return false;
+    }
+
+    uint8_t siteBytes[OffsetCacheEntry::MaxVerifyBytes] = {};
+    return SEH_MemReadRaw(baseAddress + entry.siteRva, siteBytes, entry.verifyLength) &&
+        OffsetCache::VerifyEntry(entry, siteBytes);
+}
+
+GameOffsets HaloMCCOffsetScanner::ScanModule(uintptr_t baseAddress, size_t moduleSize, const PEImage* image, uint32_t title,
+                                             std::vector<OffsetResolution>& resolved) {
+    GameOffsets offsets;
+    resolved.clear();
+
+    LogToFile("Backend de escaneo: " + std::string(PatternScanner::BackendToString(PatternScanner::GetBackend())));
+
+    // Todas las firmas del título se buscan en una sola pasada sobre el módulo
+    const OffsetTitleInfo* titleInfo = OffsetScanCore::FindTitle(title);
+    LogToFile("Buscando patrones (split-screen, player count, cámara) para " +
+        std::string(titleInfo ? titleInfo->name : "?") + "...");
+
+    MultiPatternScanner scanner;
+    OffsetScanCore::BuildScanner(scanner, title);
+
+    // Un pool para todo el escaneo (el del DLL si lo pasó a SetScanOptions); el juego está
+    // casi todo el arranque esperando I/O
+    ScanOptions options = scanOptions;
+    std::unique_ptr<ScanThreadPool> ownPool;
+    if (!options.pool || options.deterministic) {
+        ownPool = std::make_unique<ScanThreadPool>(options.deterministic ? 1 : options.workerCount);
+        options.pool = ownPool.get();
+    }
+    LogToFile("Workers de escaneo: " + std::to_string(options.pool->GetWorkerCount()));
+
+    // Todos los matches de cada firma en una pasada por sección, para validar que son únicas.
+    // Las firmas son de código: solo se recorren las secciones ejecutables
+    std::vector<OffsetCandidates> candidates(OffsetScanCore::GetSignatures().size());
+    // Si el módulo ya se escaneó, candidatos anteriores + páginas modificadas
+    const bool incremental = image && RescanChangedPages(baseAddress, moduleSize, *image, title, scanner, candidates);
+    if (incremental) {
+        LogToFile("Candidatos del escaneo anterior reutilizados");
+    }
+    else if (image) {
+        // Hashes antes de escanear: lo que cambie durante el escaneo saldrá sucio la próxima vez,
+        // igual que lo que no se pudo leer (queda desconocido)
+        PageHashSet pages;
+        if (!SEH_HashSections(baseAddress, *image, OffsetScanCore::GetSectionMask(), pages)) {
+            LogToFile("⚠ " + std::to_string(pages.GetUnknownPageCount()) +
+                " página(s) sin leer al hashear: se re-escanearán la próxima vez");
+        }
+
+        for (const PESection& section : image->GetSections()) {
+            LogToFile("  Sección " + std::string(section.name) + " (" + PEImage::SectionKindToString(section.kind) +
+                ") RVA 0x" + ToHexString(section.virtualAddress) + " tamaño 0x" + ToHexString(section.virtualSize));
+            if (!(section.kind & OffsetScanCore::GetSectionMask())) continue;
+
+            const uintptr_t sectionStart = baseAddress + section.virtualAddress;
+            std::vector<PatternMatches> matches;
+            SEH_EnumeratePatternsInRange(sectionStart, section.virtualSize, scanner, matches,
+                OffsetScanCore::MaxCandidates, options);
+            OffsetScanCore::AddCandidates(candidates, matches, reinterpret_cast<const uint8_t*>(sectionStart),
+                section.virtualSize, section.virtualAddress, section.kind, title);
+        }
+
+        SaveScanState(baseAddress, moduleSize, *image, title, pages, candidates);
+    }
+    else {
+        LogToFile("ADVERTENCIA: cabeceras PE no válidas, escaneando el módulo completo");
+        std::vector<PatternMatches> matches;
+        SEH_EnumeratePatternsInRange(baseAddress, moduleSize, scanner, matches, OffsetScanCore::MaxCandidates, options);
+        OffsetScanCore::AddCandidates(candidates, matches, reinterpret_cast<const uint8_t*>(baseAddress),
+            moduleSize, 0, SECTION_CODE | SECTION_ANY_DATA | SECTION_OTHER, title);
+    }
+
+    // Índices del módulo: los del ejecutable se comparten y se guardan; los de una DLL de
+    // título son locales al escaneo (se descargan con el título)
+    XrefIndex titleXrefs;
+    StringIndex titleStrings;
+    const XrefIndex* xrefs = nullptr;
+    const StringIndex* strings = nullptr;
+    if (image && title == TITLE_MCC) {
+        xrefs = GetXrefIndex();
+        strings = OffsetScanCore::HasStringAnchors(title) ? GetStringIndex() : nullptr;
+    }
+    else if (image) {
+        if (!SEH_BuildXrefIndex(baseAddress, *image, titleXrefs)) {
+            LogToFile("ADVERTENCIA: índice de xrefs del título incompleto (fallo leyendo código)");
+        }
+        xrefs = &titleXrefs;
+        if (OffsetScanCore::HasStringAnchors(title)) {
+            SEH_BuildStringIndex(baseAddress, *image, titleStrings);
+            strings = &titleStrings;
+        }
+    }
+
+    // Firmas ancladas en cadena: consultas a los índices de cadenas y xrefs, sin otra pasada
+    ModuleCopyReader reader = { baseAddress, moduleSize, {} };
+    if (strings && xrefs) {
+        OffsetScanCore::AddStringAnchoredCandidates(candidates, *strings, *xrefs, ReadModuleCopy, &reader, title);
+    }
+
+    // Todas las alternativas de cada campo se puntúan juntas por acuerdo
+    resolved = OffsetScanCore::ScoreMatches(ResolveMatches(baseAddress, candidates, image, title));
+
+    const std::vector<OffsetSignature>& signatures = OffsetScanCore::GetSignatures();
+    for (const OffsetResolution& resolution : resolved) {
+        const std::string field(OffsetScanCore::FieldToString(resolution.field));
+        if (resolution.contested) {
+            LogToFile("✗ " + field + ": firmas en conflicto (" + std::to_string(resolution.agreeing) + " de acuerdo, " +
+                std::to_string(resolution.conflicting) + " en conflicto), no se usa ninguna");
+            continue;
+        }
+        if (!resolution.found) {
+            LogToFile("✗ " + field + ": ninguna firma alternativa resuelve");
+            continue;
+        }
+
+        LogToFile("→ " + field + ": 0x" + ToHexString(baseAddress + resolution.targetRva) + " por '" +
+            signatures[resolution.signatureIndex].name + "', confianza " + std::to_string(resolution.confidence) +
+            "% (" + std::to_string(resolution.agreeing) + " de acuerdo, " + std::to_string(resolution.conflicting) +
+            " en conflicto)");
+        SetField(offsets, resolution.field, baseAddress + resolution.targetRva);
+    }
+
+    // Cuántas instrucciones tocan cada global encontrado (consulta al índice, sin re-escanear)
+    if (xrefs) {
+        for (const OffsetResolution& resolution : resolved) {
+            if (!resolution.found) continue;
+            LogToFile("  " + std::string(OffsetScanCore::FieldToString(resolution.field)) + ": " +
+                std::to_string(xrefs->FindReferencesTo(resolution.targetRva).Size()) + " referencias en código");
+        }
+    }
 
     if (offsets.splitScreenEnabledOffset && offsets.playerCountOffset) {
         offsets.valid = true;
@@ -209,6 +654,117 @@ GameOffsets HaloMCCOffsetScanner::ScanForOffsets() {
     return offsets;
 }
 
+// ============================================================================
+// Re-escaneo incremental
+// ============================================================================
+
+bool HaloMCCOffsetScanner::RescanChangedPages(uintptr_t baseAddress, size_t moduleSize, const PEImage& image, uint32_t title,
+                                              const MultiPatternScanner& scanner, std::vector<OffsetCandidates>& candidates) {
+    ScanState previous;
+    {
+        std::lock_guard<std::mutex> lock(scanStateMutex);
+        auto it = std::find_if(scanStates.begin(), scanStates.end(), [&](const ScanState& state) {
+            return state.baseAddress == baseAddress && state.title == title;
+        });
+        if (it == scanStates.end()) return false;
+        previous = *it;
+    }
+
+    if (previous.moduleSize != moduleSize || previous.timeDateStamp != image.GetTimeDateStamp()) {
+        LogToFile("Módulo distinto al del último escaneo: escaneo completo");
+        return false;
+    }
+    if (!OffsetScanCore::CanRescanIncrementally(previous.candidates)) {
+        LogToFile("Alguna firma tenía más de " + std::to_string(OffsetScanCore::MaxCandidates) +
+            " matches: escaneo completo");
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    PageHashSet pages;
+    if (!SEH_HashSections(baseAddress, image, OffsetScanCore::GetSectionMask(), pages)) {
+        LogToFile("⚠ " + std::to_string(pages.GetUnknownPageCount()) +
+            " página(s) sin leer al hashear: cuentan como modificadas");
+    }
+
+    std::vector<DirtyRange> dirty;
+    PageHashSet::Diff(previous.pages, pages, dirty);
+
+    // Páginas de código que cambian entre escaneos = parches en tiempo de ejecución (hooks
+    // del propio juego, anti-cheat u otros mods)
+    size_t dirtyPages = 0;
+    for (const DirtyRange& range : dirty) {
+        const size_t count = (range.size + PageHashSet::PageSize - 1) / PageHashSet::PageSize;
+        dirtyPages += count;
+
+        const PESection* section = image.FindSectionByRva(range.rva);
+        LogToFile("  ⚠ " + std::to_string(count) + " página(s) modificada(s) en " +
+            std::string(section ? section->name : "?") + " RVA 0x" + ToHexString(range.rva));
+    }
+
+    std::vector<RescanWindow> windows;
+    OffsetScanCore::BuildRescanWindows(dirty, image, title, windows);
+
+    candidates = previous.candidates;
+    OffsetScanCore::DropCandidates(candidates, windows);
+
+    size_t rescanned = 0;
+    for (const RescanWindow& window : windows) {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(baseAddress + window.rva);
+        std::vector<PatternMatches> matches(scanner.GetPatternCount());
+        if (!SEH_EnumeratePatternsRaw(data, window.scanSize, window.candidateSize, scanner, matches,
+                                      OffsetScanCore::MaxCandidates)) {
+            LogToFile("ADVERTENCIA: fallo leyendo una página modificada, escaneo completo");
+            return false;
+        }
+
+        OffsetScanCore::AddCandidates(candidates, matches, data, window.scanSize, window.rva, window.sectionKind, title);
+        rescanned += window.scanSize;
+    }
+
+    // Las ventanas añaden al final: se recupera el orden de dirección
+    for (OffsetCandidates& signature : candidates) {
+        std::sort(signature.sites.begin(), signature.sites.end(), [](const OffsetSite& a, const OffsetSite& b) {
+            return a.rva < b.rva;
+        });
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    LogToFile("Re-escaneo incremental: " + std::to_string(dirtyPages) + " de " + std::to_string(pages.GetPageCount()) +
+        " páginas cambiaron, " + std::to_string(rescanned / 1024) + " KB re-escaneados en " +
+        std::to_string(elapsed.count()) + " us (CRC32C " + (PageHasher::HasHardwareCrc() ? "SSE4.2" : "tablas") + ")");
+
+    SaveScanState(baseAddress, moduleSize, image, title, pages, candidates);
+    return true;
+}
+
+void HaloMCCOffsetScanner::SaveScanState(uintptr_t baseAddress, size_t moduleSize, const PEImage& image, uint32_t title,
+                                         const PageHashSet& pages, const std::vector<OffsetCandidates>& candidates) {
+    ScanState state;
+    state.baseAddress = baseAddress;
+    state.moduleSize = moduleSize;
+    state.title = title;
+    state.timeDateStamp = image.GetTimeDateStamp();
+    state.pages = pages;
+    state.candidates = candidates;
+
+    std::lock_guard<std::mutex> lock(scanStateMutex);
+    for (ScanState& existing : scanStates) {
+        if (existing.baseAddress == baseAddress && existing.title == title) {
+            existing = std::move(state);
+            return;
+        }
+    }
+    scanStates.push_back(std::move(state));
+}
+
+void HaloMCCOffsetScanner::DropScanState(uintptr_t baseAddress) {
+    std::lock_guard<std::mutex> lock(scanStateMutex);
+    scanStates.erase(std::remove_if(scanStates.begin(), scanStates.end(), [&](const ScanState& state) {
+        return state.baseAddress == baseAddress;
+    }), scanStates.end());
+}
+
 // ============================================================================
 // Funciones auxiliares
 // ============================================================================
@@ -220,16 +776,6 @@ static std::string ToHexString(uintptr_t value) {
 }
 
 static void LogToFile(const std::string& message) {
-    std::ofstream logFile("HaloMCC_OffsetScanner.log", std::ios::out | std::ios::app);
-    if (logFile.is_open()) {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        char timeStr[100];
-        struct tm timeInfo;
-        localtime_s(&timeInfo, &time_t);
-        strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", &timeInfo);
-
-        logFile << "[" << timeStr << "] " << message << std::endl;
-        logFile.close();
-    }
+    static const uint16_t channel = AsyncLogger::Get().OpenChannel("HaloMCC_OffsetScanner.log");
+    AsyncLogger::Get().Log(channel, message);
 }
\ No newline at end of file
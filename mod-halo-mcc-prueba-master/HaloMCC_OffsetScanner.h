@@ -4,6 +4,14 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <mutex>
+#include "HaloMCC_ParallelScan.h"
+#include "HaloMCC_OffsetCache.h"
+#include "HaloMCC_OffsetProfile.h"
+#include "HaloMCC_XrefIndex.h"
+#include "HaloMCC_StringIndex.h"
+#include "HaloMCC_ModuleWatcher.h"
+#include "HaloMCC_PageHash.h"
 
 // Estructura para offsets del juego
 struct GameOffsets {
@@ -30,26 +38,103 @@ struct GameOffsets {
     bool valid = false;
 };
 
+// Offsets de un módulo de título (halo1.dll, halo3.dll...) mientras está cargado
+struct TitleOffsets {
+    uint32_t title = TITLE_MCC;         // OffsetTitle
+    uint32_t gameVersion = 0;           // GameVersion
+    uintptr_t moduleBase = 0;
+    size_t moduleSize = 0;
+    GameOffsets offsets;
+};
+
+// Se llama desde el hilo del watcher: loaded = true tras escanear el módulo (válido o no),
+// false cuando se descarga
+typedef void (*TitleOffsetsCallback)(const TitleOffsets& title, bool loaded);
+
 // Scanner de offsets
 class HaloMCCOffsetScanner {
 public:
-    struct ScanPatterns {
-        static std::vector<uint8_t> GetSplitScreenCheckPattern();
-        static std::vector<bool> GetSplitScreenCheckMask();
-        static std::vector<uint8_t> GetPlayerCountPattern();
-        static std::vector<bool> GetPlayerCountMask();
-        static std::vector<uint8_t> GetCameraMatrixPattern();
-        static std::vector<bool> GetCameraMatrixMask();
-    };
-
+    // Escaneo completo, sin caché
     static GameOffsets ScanForOffsets();
 
+    // Usa la caché de offsets si la clave del módulo coincide y los bytes de cada sitio
+    // siguen ahí; si no, escaneo y se reescribe la caché. Si el módulo ya se escaneó en esta
+    // sesión solo se re-escanean las páginas cuyo hash cambió.
+    // forceRescan = ignorar la caché (F12)
+    static GameOffsets LoadOrScanOffsets(uint32_t gameVersion, uint32_t gamePlatform, bool forceRescan = false);
+
+    // Escanea (o saca de caché) cada DLL de título en cuanto MCC la carga, en un hilo aparte y
+    // solo con las firmas de ese título. Las ya cargadas se procesan al arrancar
+    static bool StartTitleWatcher(uint32_t gamePlatform, TitleOffsetsCallback callback);
+    static void StopTitleWatcher();
+    static bool GetTitleOffsets(uint32_t title, TitleOffsets& result);
+    static std::vector<TitleOffsets> GetLoadedTitles();
+
+    // Fichero de caché junto al DLL
+    static std::string GetCachePath();
+
+    // Índice de xrefs RIP-relative del módulo del juego. Se construye la primera vez que se
+    // pide (o se carga de GetXrefIndexPath() si es del mismo ejecutable). nullptr sin módulo
+    static const XrefIndex* GetXrefIndex();
+    static std::string GetXrefIndexPath();
+    // Cadenas de .rdata del módulo del juego (para las firmas ancladas en cadena)
+    static const StringIndex* GetStringIndex();
+
+    // Workers/tamaño de chunk del escaneo. deterministic = un solo hilo (tests). pool = el
+    // del DLL, que tiene que vivir hasta StopTitleWatcher (nullptr = uno por escaneo)
+    static void SetScanOptions(const ScanOptions& options);
+    static ScanOptions GetScanOptions();
+
 private:
+    // Último escaneo de un módulo: hashes de las secciones escaneadas y candidatos de las
+    // firmas de patrón (direcciones vivas), para el re-escaneo incremental
+    struct ScanState {
+        uintptr_t baseAddress = 0;
+        size_t moduleSize = 0;
+        uint32_t title = TITLE_MCC;
+        uint32_t timeDateStamp = 0;
+        PageHashSet pages;
+        std::vector<OffsetCandidates> candidates;
+    };
+
+    static std::string GetModuleDirectory();
     static HMODULE GetGameModule();
-    static uintptr_t ScanSplitScreenCheck(uintptr_t baseAddress, size_t moduleSize);
-    static uintptr_t ScanPlayerCount(uintptr_t baseAddress, size_t moduleSize);
-    static uintptr_t ScanCameraBase(uintptr_t baseAddress, size_t moduleSize);
-    static bool PatternMatch(uintptr_t address, const std::vector<uint8_t>& pattern, const std::vector<bool>& mask);
+    static bool GetGameModuleRange(uintptr_t& baseAddress, size_t& moduleSize);
+    // Caché + escaneo de un módulo cualquiera (el ejecutable o una DLL de título)
+    static GameOffsets LoadOrScanModule(uintptr_t baseAddress, size_t moduleSize, uint32_t title,
+                                        uint32_t gameVersion, uint32_t gamePlatform, bool forceRescan);
+    static GameOffsets ScanModule(uintptr_t baseAddress, size_t moduleSize, const PEImage* image, uint32_t title,
+                                  std::vector<OffsetResolution>& resolved);
+    // Candidatos a partir del último escaneo del módulo, re-escaneando solo las páginas que
+    // cambiaron. false = no hay estado utilizable, hace falta un escaneo completo
+    static bool RescanChangedPages(uintptr_t baseAddress, size_t moduleSize, const PEImage& image, uint32_t title,
+                                   const MultiPatternScanner& scanner, std::vector<OffsetCandidates>& candidates);
+    static void SaveScanState(uintptr_t baseAddress, size_t moduleSize, const PEImage& image, uint32_t title,
+                              const PageHashSet& pages, const std::vector<OffsetCandidates>& candidates);
+    static void DropScanState(uintptr_t baseAddress);
+    static bool LoadFromCache(uintptr_t baseAddress, size_t moduleSize, const OffsetCacheRecord& record, GameOffsets& offsets);
+    // Los bytes de la firma siguen en el sitio cacheado
+    static bool VerifyCachedEntry(uintptr_t baseAddress, size_t moduleSize, const OffsetCacheEntry& entry);
+    static void SetField(GameOffsets& offsets, uint32_t field, uintptr_t address);
+    // Copia bajo SEH los candidatos (direcciones vivas) y elige uno por firma
+    static std::vector<OffsetMatch> ResolveMatches(uintptr_t baseAddress, const std::vector<OffsetCandidates>& found,
+                                                   const PEImage* image, uint32_t title);
+
+    static bool IsTitleModule(const std::string& name);
+    static void OnModuleEvent(const ModuleEvent& event);
+
+    static ScanOptions scanOptions;
+    static XrefIndex xrefIndex;
+    static StringIndex stringIndex;
+    static std::mutex cacheMutex;           // el fichero de caché es compartido por todos los módulos
+    static std::mutex scanStateMutex;
+    static std::vector<ScanState> scanStates;
+
+    static ModuleWatcher titleWatcher;
+    static std::mutex titleMutex;
+    static std::vector<TitleOffsets> titles;
+    static TitleOffsetsCallback titleCallback;
+    static uint32_t titlePlatform;
 };
 
 // Función auxiliar exportada
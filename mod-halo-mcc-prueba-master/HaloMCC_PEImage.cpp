@@ -0,0 +1,234 @@
+// HaloMCC_PEImage.cpp
+#include "HaloMCC_PEImage.h"
+#include <cstring>
+
+// ============================================================================
+// Constantes PE (equivalentes a las de winnt.h, redefinidas para no depender de él)
+// ============================================================================
+
+namespace {
+
+const uint16_t DOS_SIGNATURE = 0x5A4D;          // "MZ"
+const uint32_t NT_SIGNATURE = 0x00004550;       // "PE\0\0"
+const uint16_t OPTIONAL_MAGIC_PE32 = 0x10B;
+const uint16_t OPTIONAL_MAGIC_PE32_PLUS = 0x20B;
+
+const uint32_t SCN_CNT_CODE = 0x00000020;
+const uint32_t SCN_CNT_INITIALIZED_DATA = 0x00000040;
+const uint32_t SCN_MEM_EXECUTE = 0x20000000;
+const uint32_t SCN_MEM_WRITE = 0x80000000;
+
+const size_t FILE_HEADER_SIZE = 20;
+const size_t SECTION_HEADER_SIZE = 40;
+const size_t MAX_SECTIONS = 96;
+
+template <typename T>
+bool ReadAt(const uint8_t* data, size_t size, size_t offset, T& out) {
+    if (offset > size || size - offset < sizeof(T)) return false;
+    memcpy(&out, data + offset, sizeof(T));
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// Parseo
+// ============================================================================
+
+bool PEImage::Parse(const uint8_t* buffer, size_t size, Layout bufferLayout) {
+    *this = PEImage();
+    data = buffer;
+    dataSize = size;
+    layout = bufferLayout;
+
+    if (!buffer) return false;
+
+    uint16_t dosMagic = 0;
+    uint32_t ntOffset = 0;
+    if (!ReadAt(buffer, size, 0, dosMagic) || dosMagic != DOS_SIGNATURE) return false;
+    if (!ReadAt(buffer, size, 0x3C, ntOffset)) return false;
+
+    uint32_t ntSignature = 0;
+    if (!ReadAt(buffer, size, ntOffset, ntSignature) || ntSignature != NT_SIGNATURE) return false;
+
+    const size_t fileHeader = static_cast<size_t>(ntOffset) + 4;
+    uint16_t numberOfSections = 0;
+    uint16_t sizeOfOptionalHeader = 0;
+    if (!ReadAt(buffer, size, fileHeader + 2, numberOfSections)) return false;
+    if (!ReadAt(buffer, size, fileHeader + 4, timeDateStamp)) return false;
+    if (!ReadAt(buffer, size, fileHeader + 16, sizeOfOptionalHeader)) return false;
+    if (numberOfSections == 0 || numberOfSections > MAX_SECTIONS) return false;
+
+    const size_t optionalHeader = fileHeader + FILE_HEADER_SIZE;
+    uint16_t magic = 0;
+    if (!ReadAt(buffer, size, optionalHeader, magic)) return false;
+
+    if (magic == OPTIONAL_MAGIC_PE32_PLUS) {
+        is64Bit = true;
+        if (!ReadAt(buffer, size, optionalHeader + 24, imageBase)) return false;
+    }
+    else if (magic == OPTIONAL_MAGIC_PE32) {
+        uint32_t imageBase32 = 0;
+        if (!ReadAt(buffer, size, optionalHeader + 28, imageBase32)) return false;
+        imageBase = imageBase32;
+    }
+    else {
+        return false;
+    }
+
+    // SizeOfImage/SizeOfHeaders/CheckSum están en el mismo offset en PE32 y PE32+
+    if (!ReadAt(buffer, size, optionalHeader + 56, sizeOfImage)) return false;
+    if (!ReadAt(buffer, size, optionalHeader + 60, sizeOfHeaders)) return false;
+    if (!ReadAt(buffer, size, optionalHeader + 64, checkSum)) return false;
+
+    // NumberOfRvaAndSizes + directorios: detrás de los campos de pila/heap, que miden 4 u 8
+    const size_t directoryCountOffset = optionalHeader + (is64Bit ? 108 : 92);
+    if (ReadAt(buffer, size, directoryCountOffset, directoryCount)) {
+        if (directoryCount > MaxDirectories) directoryCount = MaxDirectories;
+        for (uint32_t i = 0; i < directoryCount; ++i) {
+            const size_t entry = directoryCountOffset + 4 + i * 8;
+            if (entry + 8 > optionalHeader + sizeOfOptionalHeader ||
+                !ReadAt(buffer, size, entry, directoryRvas[i]) || !ReadAt(buffer, size, entry + 4, directorySizes[i])) {
+                directoryCount = i;
+                break;
+            }
+        }
+    }
+    else {
+        directoryCount = 0;
+    }
+
+    const size_t sectionTable = optionalHeader + sizeOfOptionalHeader;
+    sections.reserve(numberOfSections);
+
+    for (size_t i = 0; i < numberOfSections; ++i) {
+        const size_t header = sectionTable + i * SECTION_HEADER_SIZE;
+        if (header > size || size - header < SECTION_HEADER_SIZE) return false;
+
+        PESection section;
+        memcpy(section.name, buffer + header, 8);
+        section.name[8] = '\0';
+        ReadAt(buffer, size, header + 8, section.virtualSize);
+        ReadAt(buffer, size, header + 12, section.virtualAddress);
+        ReadAt(buffer, size, header + 16, section.rawSize);
+        ReadAt(buffer, size, header + 20, section.rawOffset);
+        ReadAt(buffer, size, header + 36, section.characteristics);
+
+        // Algunos linkers dejan VirtualSize a 0; en ese caso vale el tamaño crudo
+        if (section.virtualSize == 0) section.virtualSize = section.rawSize;
+
+        section.kind = ClassifySection(section.name, section.characteristics);
+        sections.push_back(section);
+    }
+
+    valid = true;
+    return true;
+}
+
+SectionKind PEImage::ClassifySection(const char* name, uint32_t characteristics) {
+    if (strcmp(name, ".text") == 0) return SECTION_CODE;
+    if (strcmp(name, ".data") == 0) return SECTION_DATA;
+    if (strcmp(name, ".rdata") == 0) return SECTION_RDATA;
+
+    // Metadatos del loader: nunca contienen firmas útiles
+    if (strcmp(name, ".pdata") == 0 || strcmp(name, ".reloc") == 0 || strcmp(name, ".rsrc") == 0) {
+        return SECTION_OTHER;
+    }
+
+    if (characteristics & (SCN_MEM_EXECUTE | SCN_CNT_CODE)) return SECTION_CODE;
+    if (characteristics & SCN_CNT_INITIALIZED_DATA) {
+        return (characteristics & SCN_MEM_WRITE) ? SECTION_DATA : SECTION_RDATA;
+    }
+    return SECTION_OTHER;
+}
+
+bool PEImage::GetDataDirectory(uint32_t index, uint32_t& rva, uint32_t& size) const {
+    if (index >= directoryCount || !directoryRvas[index] || !directorySizes[index]) return false;
+    rva = directoryRvas[index];
+    size = directorySizes[index];
+    return true;
+}
+
+const char* PEImage::SectionKindToString(SectionKind kind) {
+    switch (kind) {
+    case SECTION_CODE: return "code";
+    case SECTION_DATA: return "data";
+    case SECTION_RDATA: return "rdata";
+    default: return "other";
+    }
+}
+
+// ============================================================================
+// Consultas
+// ============================================================================
+
+const PESection* PEImage::FindSection(const char* name) const {
+    for (const PESection& section : sections) {
+        if (strcmp(section.name, name) == 0) return &section;
+    }
+    return nullptr;
+}
+
+const PESection* PEImage::FindSectionByRva(uint32_t rva) const {
+    for (const PESection& section : sections) {
+        if (rva >= section.virtualAddress && rva - section.virtualAddress < section.virtualSize) {
+            return &section;
+        }
+    }
+    return nullptr;
+}
+
+size_t PEImage::GetSectionSize(const PESection& section) const {
+    if (layout == Layout::MAPPED) return section.virtualSize;
+    return section.rawSize < section.virtualSize ? section.rawSize : section.virtualSize;
+}
+
+size_t PEImage::GetSectionOffset(const PESection& section) const {
+    return layout == Layout::MAPPED ? section.virtualAddress : section.rawOffset;
+}
+
+const uint8_t* PEImage::GetSectionData(const PESection& section, size_t& size) const {
+    size = 0;
+    const size_t offset = GetSectionOffset(section);
+    if (!data || offset >= dataSize) return nullptr;
+
+    size = GetSectionSize(section);
+    if (size > dataSize - offset) size = dataSize - offset;
+    return data + offset;
+}
+
+bool PEImage::RvaToOffset(uint32_t rva, size_t& offset) const {
+    if (layout == Layout::MAPPED) {
+        offset = rva;
+        return rva < sizeOfImage;
+    }
+
+    const PESection* section = FindSectionByRva(rva);
+    if (!section) {
+        // Las cabeceras se mapean 1:1
+        offset = rva;
+        return rva < sizeOfHeaders;
+    }
+
+    const uint32_t delta = rva - section->virtualAddress;
+    if (delta >= section->rawSize) return false;
+    offset = static_cast<size_t>(section->rawOffset) + delta;
+    return true;
+}
+
+bool PEImage::OffsetToRva(size_t offset, uint32_t& rva) const {
+    if (layout == Layout::MAPPED) {
+        rva = static_cast<uint32_t>(offset);
+        return offset < sizeOfImage;
+    }
+
+    for (const PESection& section : sections) {
+        if (offset >= section.rawOffset && offset - section.rawOffset < GetSectionSize(section)) {
+            rva = section.virtualAddress + static_cast<uint32_t>(offset - section.rawOffset);
+            return true;
+        }
+    }
+
+    rva = static_cast<uint32_t>(offset);
+    return offset < sizeOfHeaders;
+}
@@ -0,0 +1,91 @@
+// HaloMCC_PEImage.h
+// Parser mínimo de cabeceras PE/secciones. No depende de windows.h, así que funciona
+// igual sobre el módulo cargado en memoria que sobre un buffer/fichero fuera del juego.
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Clasificación de secciones; los valores son bits para poder combinarlos en filtros
+enum SectionKind : uint32_t {
+    SECTION_CODE  = 1 << 0,    // .text y cualquier sección ejecutable
+    SECTION_DATA  = 1 << 1,    // .data y datos inicializados escribibles
+    SECTION_RDATA = 1 << 2,    // .rdata y datos inicializados de solo lectura
+    SECTION_OTHER = 1 << 3,    // .reloc, .rsrc, .bss, ...
+
+    SECTION_ANY_DATA = SECTION_DATA | SECTION_RDATA
+};
+
+struct PESection {
+    char name[9] = {};
+    uint32_t virtualAddress = 0;
+    uint32_t virtualSize = 0;
+    uint32_t rawOffset = 0;
+    uint32_t rawSize = 0;
+    uint32_t characteristics = 0;
+    SectionKind kind = SECTION_OTHER;
+};
+
+class PEImage {
+public:
+    // Índices del directorio de datos que usa el código
+    static const uint32_t DirectoryBaseRelocation = 5;
+    static const uint32_t MaxDirectories = 16;
+
+    // MAPPED: imagen cargada por el loader (datos en base + RVA)
+    // FILE:   fichero en disco (datos en PointerToRawData)
+    enum class Layout {
+        MAPPED,
+        FILE
+    };
+
+    bool Parse(const uint8_t* data, size_t size, Layout layout);
+
+    bool IsValid() const { return valid; }
+    bool Is64Bit() const { return is64Bit; }
+    Layout GetLayout() const { return layout; }
+
+    uint32_t GetTimeDateStamp() const { return timeDateStamp; }
+    uint32_t GetSizeOfImage() const { return sizeOfImage; }
+    uint32_t GetSizeOfHeaders() const { return sizeOfHeaders; }
+    uint32_t GetCheckSum() const { return checkSum; }
+    uint64_t GetImageBase() const { return imageBase; }
+    // false si el directorio no existe o está vacío
+    bool GetDataDirectory(uint32_t index, uint32_t& rva, uint32_t& size) const;
+
+    const std::vector<PESection>& GetSections() const { return sections; }
+    const PESection* FindSection(const char* name) const;
+    const PESection* FindSectionByRva(uint32_t rva) const;
+
+    // Tamaño escaneable de la sección según el layout (VirtualSize en memoria, datos crudos en disco)
+    size_t GetSectionSize(const PESection& section) const;
+    // Offset de la sección respecto al inicio del buffer según el layout
+    size_t GetSectionOffset(const PESection& section) const;
+    // Datos de la sección dentro del buffer pasado a Parse (nullptr si quedan fuera)
+    const uint8_t* GetSectionData(const PESection& section, size_t& size) const;
+
+    // Conversión RVA <-> offset en el buffer (0/false si no pertenece a ninguna sección)
+    bool RvaToOffset(uint32_t rva, size_t& offset) const;
+    bool OffsetToRva(size_t offset, uint32_t& rva) const;
+
+    static SectionKind ClassifySection(const char* name, uint32_t characteristics);
+    static const char* SectionKindToString(SectionKind kind);
+
+private:
+    const uint8_t* data = nullptr;
+    size_t dataSize = 0;
+    Layout layout = Layout::MAPPED;
+    bool valid = false;
+    bool is64Bit = false;
+
+    uint32_t timeDateStamp = 0;
+    uint32_t sizeOfImage = 0;
+    uint32_t sizeOfHeaders = 0;
+    uint32_t checkSum = 0;
+    uint64_t imageBase = 0;
+    uint32_t directoryCount = 0;
+    uint32_t directoryRvas[MaxDirectories] = {};
+    uint32_t directorySizes[MaxDirectories] = {};
+
+    std::vector<PESection> sections;
+};
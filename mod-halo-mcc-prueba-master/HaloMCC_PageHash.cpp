@@ -0,0 +1,253 @@
+// HaloMCC_PageHash.cpp
+#include "HaloMCC_PageHash.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define HALO_HASH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// Igual que el scanner: GCC/Clang necesitan habilitar SSE4.2 por función
+#if defined(HALO_HASH_X86) && !defined(_MSC_VER)
+#define HALO_TARGET_SSE42 __attribute__((target("sse4.2")))
+#else
+#define HALO_TARGET_SSE42
+#endif
+
+// ============================================================================
+// CRC32C
+// ============================================================================
+
+namespace {
+
+const uint32_t Crc32cPolynomial = 0x82F63B78;   // reflejado
+
+struct Crc32cTables {
+    uint32_t table[8][256];
+
+    Crc32cTables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (Crc32cPolynomial & (0u - (crc & 1)));
+            table[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int slice = 1; slice < 8; ++slice) {
+                table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const Crc32cTables& GetTables() {
+    static const Crc32cTables tables;
+    return tables;
+}
+
+std::atomic<int> g_hardwareCrc{ -1 };
+
+bool DetectHardwareCrc() {
+#if defined(HALO_HASH_X86)
+    int regs[4] = {};
+#if defined(_MSC_VER)
+    __cpuid(regs, 1);
+#else
+    unsigned a = 0, b = 0, c = 0, d = 0;
+    __cpuid(1, a, b, c, d);
+    regs[2] = static_cast<int>(c);
+#endif
+    return (regs[2] & (1 << 20)) != 0;      // ECX.SSE4_2
+#else
+    return false;
+#endif
+}
+
+#if defined(HALO_HASH_X86)
+HALO_TARGET_SSE42
+uint32_t Crc32cHardware(const uint8_t* data, size_t size, uint32_t crc) {
+#if defined(_M_X64) || defined(__x86_64__)
+    uint64_t crc64 = crc;
+    for (; size >= 8; data += 8, size -= 8) {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        crc64 = _mm_crc32_u64(crc64, value);
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    for (; size >= 4; data += 4, size -= 4) {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        crc = _mm_crc32_u32(crc, value);
+    }
+    for (; size; ++data, --size) crc = _mm_crc32_u8(crc, *data);
+    return crc;
+}
+
+#if defined(_M_X64) || defined(__x86_64__)
+// crc32 tiene latencia 3 y throughput 1: una sola cadena deja la unidad parada dos de cada
+// tres ciclos. Tres páginas independientes entrelazadas la llenan (size múltiplo de 8)
+HALO_TARGET_SSE42
+void Crc32cHardware3(const uint8_t* a, const uint8_t* b, const uint8_t* c, size_t size, uint32_t out[3]) {
+    uint64_t crcA = 0xFFFFFFFF, crcB = 0xFFFFFFFF, crcC = 0xFFFFFFFF;
+    for (size_t offset = 0; offset < size; offset += 8) {
+        uint64_t valueA, valueB, valueC;
+        std::memcpy(&valueA, a + offset, sizeof(valueA));
+        std::memcpy(&valueB, b + offset, sizeof(valueB));
+        std::memcpy(&valueC, c + offset, sizeof(valueC));
+        crcA = _mm_crc32_u64(crcA, valueA);
+        crcB = _mm_crc32_u64(crcB, valueB);
+        crcC = _mm_crc32_u64(crcC, valueC);
+    }
+    out[0] = ~static_cast<uint32_t>(crcA);
+    out[1] = ~static_cast<uint32_t>(crcB);
+    out[2] = ~static_cast<uint32_t>(crcC);
+}
+#define HALO_HASH_INTERLEAVED 1
+#endif
+#endif
+
+} // namespace
+
+bool PageHasher::HasHardwareCrc() {
+    int hardware = g_hardwareCrc.load(std::memory_order_relaxed);
+    if (hardware < 0) {
+        hardware = DetectHardwareCrc() ? 1 : 0;
+        g_hardwareCrc.store(hardware, std::memory_order_relaxed);
+    }
+    return hardware != 0;
+}
+
+uint32_t PageHasher::Crc32c(const uint8_t* data, size_t size, uint32_t crc) {
+#if defined(HALO_HASH_X86)
+    if (HasHardwareCrc()) return ~Crc32cHardware(data, size, ~crc);
+#endif
+    return Crc32cSoftware(data, size, crc);
+}
+
+uint32_t PageHasher::Crc32cSoftware(const uint8_t* data, size_t size, uint32_t crc) {
+    const Crc32cTables& tables = GetTables();
+    const uint32_t (&t)[8][256] = tables.table;
+    crc = ~crc;
+
+    // Slicing-by-8: 8 bytes por iteración con 8 tablas (little-endian)
+    for (; size >= 8; data += 8, size -= 8) {
+        const uint32_t low = crc ^ (static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+            (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24));
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+            t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    }
+    for (; size; ++data, --size) crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xFF];
+    return ~crc;
+}
+
+// ============================================================================
+// Hashes por página
+// ============================================================================
+
+void PageHashSet::AddRange(const uint8_t* data, size_t size, uint32_t rva) {
+    BeginRange(rva, static_cast<uint32_t>(size));
+    HashPages(data, size, rva);
+}
+
+void PageHashSet::BeginRange(uint32_t rva, uint32_t size) {
+    ranges.emplace_back();
+    Range& range = ranges.back();
+    range.rva = rva;
+    range.size = size;
+    range.hashes.assign((static_cast<size_t>(size) + PageSize - 1) / PageSize, 0);
+    range.known.assign(range.hashes.size(), 0);
+}
+
+void PageHashSet::HashPages(const uint8_t* data, size_t size, uint32_t rva) {
+    if (ranges.empty()) return;
+    Range& range = ranges.back();
+    if (rva < range.rva || (rva - range.rva) % PageSize) return;
+
+    // Cada página se marca conocida después de hashearla: si la lectura falla a medias (SEH)
+    // la que estaba a medias y las siguientes siguen desconocidas y Diff las da por sucias
+    const uint32_t start = rva - range.rva;
+    if (start >= range.size) return;
+    const size_t first = start / PageSize;
+    if (size > range.size - start) size = range.size - start;
+
+    size_t offset = 0;
+#if defined(HALO_HASH_INTERLEAVED)
+    if (PageHasher::HasHardwareCrc()) {
+        for (; size - offset >= 3 * PageSize; offset += 3 * PageSize) {
+            uint32_t hashes[3];
+            const uint8_t* page = data + offset;
+            Crc32cHardware3(page, page + PageSize, page + 2 * PageSize, PageSize, hashes);
+            const size_t index = first + offset / PageSize;
+            for (size_t i = 0; i < 3; ++i) {
+                range.hashes[index + i] = hashes[i];
+                range.known[index + i] = 1;
+            }
+        }
+    }
+#endif
+    for (; offset < size; offset += PageSize) {
+        const size_t length = size - offset < PageSize ? size - offset : PageSize;
+        const size_t index = first + offset / PageSize;
+        range.hashes[index] = PageHasher::Crc32c(data + offset, length);
+        range.known[index] = 1;
+    }
+}
+
+size_t PageHashSet::GetPageCount() const {
+    size_t count = 0;
+    for (const Range& range : ranges) {
+        for (uint8_t known : range.known) count += known;
+    }
+    return count;
+}
+
+size_t PageHashSet::GetUnknownPageCount() const {
+    size_t count = 0;
+    for (const Range& range : ranges) count += range.known.size();
+    return count - GetPageCount();
+}
+
+void PageHashSet::Diff(const PageHashSet& previous, const PageHashSet& current, std::vector<DirtyRange>& dirty) {
+    dirty.clear();
+
+    auto addDirty = [&](uint32_t rva, uint32_t size) {
+        if (!dirty.empty() && dirty.back().rva + dirty.back().size == rva) {
+            dirty.back().size += size;
+            return;
+        }
+        DirtyRange range;
+        range.rva = rva;
+        range.size = size;
+        dirty.push_back(range);
+    };
+
+    for (const Range& range : current.ranges) {
+        const Range* before = nullptr;
+        for (const Range& candidate : previous.ranges) {
+            if (candidate.rva == range.rva && candidate.size == range.size) {
+                before = &candidate;
+                break;
+            }
+        }
+
+        const size_t expected = (static_cast<size_t>(range.size) + PageSize - 1) / PageSize;
+        if (!before || before->hashes.size() != expected || range.hashes.size() != expected) {
+            addDirty(range.rva, range.size);
+            continue;
+        }
+
+        for (size_t page = 0; page < expected; ++page) {
+            if (before->known[page] && range.known[page] && before->hashes[page] == range.hashes[page]) continue;
+
+            const uint32_t offset = static_cast<uint32_t>(page * PageSize);
+            const uint32_t length = range.size - offset < PageSize ? range.size - offset : static_cast<uint32_t>(PageSize);
+            addDirty(range.rva + offset, length);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+// HaloMCC_PageHash.h
+// Hashes CRC32C por página de las secciones escaneadas. Al re-escanear se comparan con los
+// del escaneo anterior y solo se vuelven a buscar patrones en las páginas que cambiaron; de
+// paso delatan el código parcheado en tiempo de ejecución.
+// Sin windows.h: lo usan el DLL y las herramientas de tools/.
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class PageHasher {
+public:
+    // CRC32C (Castagnoli) encadenable: Crc32c(b, n, Crc32c(a, m)) == CRC de a seguido de b.
+    // Instrucción crc32 de SSE4.2 si la CPU la tiene; si no, tablas (slicing-by-8)
+    static uint32_t Crc32c(const uint8_t* data, size_t size, uint32_t crc = 0);
+    static uint32_t Crc32cSoftware(const uint8_t* data, size_t size, uint32_t crc = 0);
+    static bool HasHardwareCrc();
+};
+
+// Tramo de páginas sucias (RVAs); size es múltiplo de página salvo al final de un tramo
+struct DirtyRange {
+    uint32_t rva = 0;
+    uint32_t size = 0;
+};
+
+// Hashes de varios tramos de una imagen (normalmente una sección cada uno)
+class PageHashSet {
+public:
+    static const size_t PageSize = 0x1000;
+
+    struct Range {
+        uint32_t rva = 0;
+        uint32_t size = 0;
+        std::vector<uint32_t> hashes;   // hashes[i] = página rva + i * PageSize (la última puede ser parcial)
+        std::vector<uint8_t> known;     // known[i] = 0 => página sin leer, su hash no vale
+    };
+
+    void Clear() { ranges.clear(); }
+
+    // Hashea [data, data + size), que empieza en 'rva'. Las páginas se cuentan desde 'rva'
+    // (las secciones cargadas ya están alineadas)
+    void AddRange(const uint8_t* data, size_t size, uint32_t rva);
+
+    // Lo mismo por partes, para secciones con huecos sin leer: BeginRange abre el tramo con
+    // todas las páginas desconocidas y HashPages hashea un trozo legible (alineado a página
+    // desde el inicio del tramo) del último tramo abierto. Lo que no se hashee queda desconocido
+    void BeginRange(uint32_t rva, uint32_t size);
+    void HashPages(const uint8_t* data, size_t size, uint32_t rva);
+
+    const std::vector<Range>& GetRanges() const { return ranges; }
+    // Páginas con hash (las desconocidas no cuentan)
+    size_t GetPageCount() const;
+    size_t GetUnknownPageCount() const;
+
+    // Páginas que difieren entre dos juegos de hashes de la misma imagen, unidas en tramos y
+    // ordenadas por RVA. Un tramo de 'current' sin igual en 'previous' cuenta entero, y una
+    // página desconocida en cualquiera de los dos cuenta como sucia
+    static void Diff(const PageHashSet& previous, const PageHashSet& current, std::vector<DirtyRange>& dirty);
+
+private:
+    std::vector<Range> ranges;
+};
@@ -0,0 +1,165 @@
+// HaloMCC_ParallelScan.cpp
+#include "HaloMCC_ParallelScan.h"
+#include "HaloMCC_ThreadPool.h"
+#include <atomic>
+#include <memory>
+
+namespace {
+
+bool DirectChunkScan(const uint8_t* begin, size_t size, const MultiPatternScanner& scanner,
+                     std::vector<const uint8_t*>& results, size_t& remaining) {
+    remaining = scanner.FindFirstAll(begin, size, results);
+    return true;
+}
+
+bool DirectChunkEnumerate(const uint8_t* begin, size_t size, size_t candidateEnd, const MultiPatternScanner& scanner,
+                          std::vector<PatternMatches>& results, size_t maxCandidates) {
+    scanner.FindAll(begin, size, results, maxCandidates, candidateEnd);
+    return true;
+}
+
+void AtomicMin(std::atomic<uintptr_t>& target, uintptr_t value) {
+    uintptr_t current = target.load();
+    while (value < current && !target.compare_exchange_weak(current, value)) {
+    }
+}
+
+size_t CountMissing(const std::vector<const uint8_t*>& results) {
+    size_t missing = 0;
+    for (const uint8_t* match : results) {
+        if (!match) missing++;
+    }
+    return missing;
+}
+
+} // namespace
+
+size_t ParallelPatternScanner::GetMaxPatternLength(const MultiPatternScanner& scanner) {
+    size_t maxLength = 1;
+    for (size_t id = 0; id < scanner.GetPatternCount(); ++id) {
+        const size_t length = scanner.GetPattern(id).view.length;
+        if (length > maxLength) maxLength = length;
+    }
+    return maxLength;
+}
+
+size_t ParallelPatternScanner::FindFirstAll(const uint8_t* begin, size_t size, const MultiPatternScanner& scanner,
+                                            const ScanOptions& options, std::vector<const uint8_t*>& results,
+                                            ChunkScanFunction scanChunk) {
+    if (!scanChunk) scanChunk = DirectChunkScan;
+
+    const size_t patternCount = scanner.GetPatternCount();
+    results.resize(patternCount, nullptr);
+
+    const size_t maxLength = GetMaxPatternLength(scanner);
+    const size_t chunkSize = options.chunkSize > maxLength ? options.chunkSize : maxLength;
+    const size_t chunkCount = begin ? (size + chunkSize - 1) / chunkSize : 0;
+
+    if (chunkCount <= 1) {
+        size_t remaining = 0;
+        scanChunk(begin, size, scanner, results, remaining);
+        return CountMissing(results);
+    }
+
+    // Mejor match por patrón; los chunks que empiezan más allá lo saltan
+    std::unique_ptr<std::atomic<uintptr_t>[]> best(new std::atomic<uintptr_t>[patternCount]);
+    for (size_t id = 0; id < patternCount; ++id) {
+        best[id].store(results[id] ? reinterpret_cast<uintptr_t>(results[id]) : UINTPTR_MAX);
+    }
+
+    std::function<void(size_t)> task = [&](size_t chunk) {
+        const size_t start = chunk * chunkSize;
+        const size_t candidateEnd = start + chunkSize < size ? start + chunkSize : size;
+        const size_t dataEnd = candidateEnd + (maxLength - 1) < size ? candidateEnd + (maxLength - 1) : size;
+        const uint8_t* chunkBegin = begin + start;
+
+        // Los patrones ya resueltos en una dirección menor se marcan como hechos
+        std::vector<const uint8_t*> local(patternCount, nullptr);
+        std::vector<bool> skipped(patternCount, false);
+        size_t pendingHere = 0;
+        for (size_t id = 0; id < patternCount; ++id) {
+            if (best[id].load() < reinterpret_cast<uintptr_t>(chunkBegin)) {
+                local[id] = chunkBegin;
+                skipped[id] = true;
+            }
+            else {
+                pendingHere++;
+            }
+        }
+        if (pendingHere == 0) return;
+
+        size_t remaining = 0;
+        if (!scanChunk(chunkBegin, dataEnd - start, scanner, local, remaining)) return;
+
+        for (size_t id = 0; id < patternCount; ++id) {
+            if (!skipped[id] && local[id]) {
+                AtomicMin(best[id], reinterpret_cast<uintptr_t>(local[id]));
+            }
+        }
+    };
+
+    if (options.pool && !options.deterministic) {
+        options.pool->ParallelFor(chunkCount, task);
+    }
+    else {
+        ScanThreadPool pool(options.deterministic ? 1 : options.workerCount);
+        pool.ParallelFor(chunkCount, task);
+    }
+
+    for (size_t id = 0; id < patternCount; ++id) {
+        const uintptr_t address = best[id].load();
+        results[id] = address == UINTPTR_MAX ? nullptr : reinterpret_cast<const uint8_t*>(address);
+    }
+    return CountMissing(results);
+}
+
+void ParallelPatternScanner::FindAll(const uint8_t* begin, size_t size, const MultiPatternScanner& scanner,
+                                     const ScanOptions& options, std::vector<PatternMatches>& results,
+                                     size_t maxCandidates, ChunkEnumerateFunction enumerateChunk) {
+    if (!enumerateChunk) enumerateChunk = DirectChunkEnumerate;
+
+    const size_t patternCount = scanner.GetPatternCount();
+    results.resize(patternCount);
+
+    const size_t maxLength = GetMaxPatternLength(scanner);
+    const size_t chunkSize = options.chunkSize > maxLength ? options.chunkSize : maxLength;
+    const size_t chunkCount = begin ? (size + chunkSize - 1) / chunkSize : 0;
+
+    if (chunkCount <= 1) {
+        enumerateChunk(begin, size, size, scanner, results, maxCandidates);
+        return;
+    }
+
+    // Aquí no hay atajo por dirección: todos los chunks se escanean enteros
+    std::vector<std::vector<PatternMatches>> perChunk(chunkCount);
+
+    std::function<void(size_t)> task = [&](size_t chunk) {
+        const size_t start = chunk * chunkSize;
+        const size_t candidateEnd = start + chunkSize < size ? start + chunkSize : size;
+        const size_t dataEnd = candidateEnd + (maxLength - 1) < size ? candidateEnd + (maxLength - 1) : size;
+
+        std::vector<PatternMatches>& local = perChunk[chunk];
+        local.resize(patternCount);
+        if (!enumerateChunk(begin + start, dataEnd - start, candidateEnd - start, scanner, local, maxCandidates)) {
+            local.assign(patternCount, PatternMatches{});
+        }
+    };
+
+    if (options.pool && !options.deterministic) {
+        options.pool->ParallelFor(chunkCount, task);
+    }
+    else {
+        ScanThreadPool pool(options.deterministic ? 1 : options.workerCount);
+        pool.ParallelFor(chunkCount, task);
+    }
+
+    for (const std::vector<PatternMatches>& local : perChunk) {
+        for (size_t id = 0; id < patternCount; ++id) {
+            results[id].count += local[id].count;
+            for (const uint8_t* candidate : local[id].candidates) {
+                if (results[id].candidates.size() >= maxCandidates) break;
+                results[id].candidates.push_back(candidate);
+            }
+        }
+    }
+}
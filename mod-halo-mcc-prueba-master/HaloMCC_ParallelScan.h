@@ -0,0 +1,45 @@
+// HaloMCC_ParallelScan.h
+// Escaneo multi-patrón repartido en chunks solapados sobre ScanThreadPool.
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "HaloMCC_PatternScanner.h"
+
+class ScanThreadPool;
+
+struct ScanOptions {
+    unsigned workerCount = 0;           // 0 = un worker por core
+    size_t chunkSize = 1024 * 1024;     // bytes de posiciones candidatas por chunk
+    bool deterministic = false;         // true = un solo hilo, chunks en orden (tests)
+    ScanThreadPool* pool = nullptr;     // pool compartido opcional (si no, se crea uno por llamada)
+};
+
+// Función que escanea un chunk; permite envolver la búsqueda (p.ej. con SEH en el DLL).
+// Misma semántica que MultiPatternScanner::FindFirstAll; devuelve false si el chunk falló.
+typedef bool (*ChunkScanFunction)(const uint8_t* begin, size_t size, const MultiPatternScanner& scanner,
+                                  std::vector<const uint8_t*>& results, size_t& remaining);
+
+// Igual para el modo enumeración (MultiPatternScanner::FindAll); candidateEnd es relativo a begin
+typedef bool (*ChunkEnumerateFunction)(const uint8_t* begin, size_t size, size_t candidateEnd,
+                                       const MultiPatternScanner& scanner, std::vector<PatternMatches>& results,
+                                       size_t maxCandidates);
+
+class ParallelPatternScanner {
+public:
+    // Igual que MultiPatternScanner::FindFirstAll, pero el rango se divide en chunks que se
+    // solapan pattern.size() - 1 bytes. Gana siempre el match de menor dirección, así que el
+    // resultado es idéntico al del escaneo secuencial.
+    static size_t FindFirstAll(const uint8_t* begin, size_t size, const MultiPatternScanner& scanner,
+                               const ScanOptions& options, std::vector<const uint8_t*>& results,
+                               ChunkScanFunction scanChunk = nullptr);
+
+    // Igual que MultiPatternScanner::FindAll. Cada chunk solo cuenta los matches que empiezan
+    // en su parte y los resultados se juntan en orden de chunk: los candidatos quedan en
+    // orden de dirección, como en el escaneo secuencial.
+    static void FindAll(const uint8_t* begin, size_t size, const MultiPatternScanner& scanner,
+                        const ScanOptions& options, std::vector<PatternMatches>& results,
+                        size_t maxCandidates, ChunkEnumerateFunction enumerateChunk = nullptr);
+
+    static size_t GetMaxPatternLength(const MultiPatternScanner& scanner);
+};
@@ -0,0 +1,427 @@
+// HaloMCC_PatternScanner.cpp
+#include "HaloMCC_PatternScanner.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define HALO_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC permite intrínsecos AVX2 sin /arch; GCC/Clang necesitan habilitarlos por función.
+#if defined(HALO_SCAN_X86) && !defined(_MSC_VER)
+#define HALO_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define HALO_TARGET_AVX2
+#endif
+
+// ============================================================================
+// Helpers internos
+// ============================================================================
+
+namespace {
+
+std::atomic<int> g_backend{ -1 };
+
+inline unsigned CountTrailingZeros64(uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<uint32_t>(value))) return static_cast<unsigned>(index);
+    _BitScanForward(&index, static_cast<uint32_t>(value >> 32));
+    return static_cast<unsigned>(index) + 32;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+// Verifica los candidatos marcados en 'bits' (bit i => posición base + i)
+inline const uint8_t* VerifyCandidates(uint64_t bits, const uint8_t* base, const PatternView& view) {
+    while (bits) {
+        const uint8_t* candidate = base + CountTrailingZeros64(bits);
+        if (PatternScanner::MatchAt(candidate, view)) {
+            return candidate;
+        }
+        bits &= bits - 1;
+    }
+    return nullptr;
+}
+
+#if defined(HALO_SCAN_X86)
+void Cpuid(int regs[4], int leaf, int subleaf) {
+#if defined(_MSC_VER)
+    __cpuidex(regs, leaf, subleaf);
+#else
+    unsigned a = 0, b = 0, c = 0, d = 0;
+    __cpuid_count(leaf, subleaf, a, b, c, d);
+    regs[0] = static_cast<int>(a);
+    regs[1] = static_cast<int>(b);
+    regs[2] = static_cast<int>(c);
+    regs[3] = static_cast<int>(d);
+#endif
+}
+
+uint64_t ReadXCR0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+} // namespace
+
+// ============================================================================
+// Preparación y verificación
+// ============================================================================
+
+bool PatternScanner::MatchAt(const uint8_t* data, const PatternView& pattern) {
+    for (size_t i = 0; i < pattern.length; ++i) {
+        if (pattern.mask[i] && data[i] != pattern.bytes[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Búsqueda
+// ============================================================================
+
+const uint8_t* PatternScanner::FindFirst(const uint8_t* begin, size_t size, const PreparedPattern& pattern) {
+    if (!begin || pattern.view.length == 0 || size < pattern.view.length) return nullptr;
+    if (!pattern.hasAnchor) return begin;
+
+    switch (GetBackend()) {
+    case ScanBackend::AVX2: return FindFirstAVX2(begin, size, pattern);
+    case ScanBackend::SSE2: return FindFirstSSE2(begin, size, pattern);
+    default:                return FindFirstScalar(begin, size, pattern);
+    }
+}
+
+const uint8_t* PatternScanner::FindFirstScalar(const uint8_t* begin, size_t size, const PreparedPattern& pattern) {
+    if (size < pattern.view.length) return nullptr;
+
+    // memchr sobre el ancla y verificación completa solo en los aciertos
+    const size_t candidates = size - pattern.view.length + 1;
+    const uint8_t* anchorBase = begin + pattern.anchorIndex;
+    size_t offset = 0;
+
+    while (offset < candidates) {
+        const void* hit = memchr(anchorBase + offset, pattern.anchorByte, candidates - offset);
+        if (!hit) return nullptr;
+
+        const size_t position = static_cast<const uint8_t*>(hit) - anchorBase;
+        if (MatchAt(begin + position, pattern.view)) {
+            return begin + position;
+        }
+        offset = position + 1;
+    }
+    return nullptr;
+}
+
+const uint8_t* PatternScanner::FindFirstSSE2(const uint8_t* begin, size_t size, const PreparedPattern& pattern) {
+#if defined(HALO_SCAN_X86)
+    const size_t candidates = size - pattern.view.length + 1;
+    const uint8_t* a1 = begin + pattern.anchorIndex;
+    const uint8_t* a2 = begin + pattern.anchor2Index;
+    const __m128i v1 = _mm_set1_epi8(static_cast<char>(pattern.anchorByte));
+    const __m128i v2 = _mm_set1_epi8(static_cast<char>(pattern.anchor2Byte));
+
+    // 32 posiciones candidatas por iteración (2 x 16 bytes por ancla)
+    size_t i = 0;
+    for (; i + 32 <= candidates; i += 32) {
+        const __m128i lo = _mm_and_si128(
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a1 + i)), v1),
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a2 + i)), v2));
+        const __m128i hi = _mm_and_si128(
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a1 + i + 16)), v1),
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a2 + i + 16)), v2));
+
+        const uint64_t bits = static_cast<uint32_t>(_mm_movemask_epi8(lo)) |
+            (static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hi))) << 16);
+        if (bits) {
+            const uint8_t* match = VerifyCandidates(bits, begin + i, pattern.view);
+            if (match) return match;
+        }
+    }
+
+    return FindFirstScalar(begin + i, size - i, pattern);
+#else
+    return FindFirstScalar(begin, size, pattern);
+#endif
+}
+
+HALO_TARGET_AVX2
+const uint8_t* PatternScanner::FindFirstAVX2(const uint8_t* begin, size_t size, const PreparedPattern& pattern) {
+#if defined(HALO_SCAN_X86)
+    const size_t candidates = size - pattern.view.length + 1;
+    const uint8_t* a1 = begin + pattern.anchorIndex;
+    const uint8_t* a2 = begin + pattern.anchor2Index;
+    const __m256i v1 = _mm256_set1_epi8(static_cast<char>(pattern.anchorByte));
+    const __m256i v2 = _mm256_set1_epi8(static_cast<char>(pattern.anchor2Byte));
+
+    // 64 posiciones candidatas por iteración (2 x 32 bytes por ancla)
+    size_t i = 0;
+    for (; i + 64 <= candidates; i += 64) {
+        const __m256i lo = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a1 + i)), v1),
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a2 + i)), v2));
+        const __m256i hi = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a1 + i + 32)), v1),
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a2 + i + 32)), v2));
+
+        const uint64_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(lo)) |
+            (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi))) << 32);
+        if (bits) {
+            const uint8_t* match = VerifyCandidates(bits, begin + i, pattern.view);
+            if (match) return match;
+        }
+    }
+
+    return FindFirstSSE2(begin + i, size - i, pattern);
+#else
+    return FindFirstScalar(begin, size, pattern);
+#endif
+}
+
+// ============================================================================
+// Selección de backend
+// ============================================================================
+
+ScanBackend PatternScanner::DetectBestBackend() {
+#if defined(HALO_SCAN_X86)
+    int regs[4] = {};
+    Cpuid(regs, 0, 0);
+    const int maxLeaf = regs[0];
+
+    Cpuid(regs, 1, 0);
+    const bool sse2 = (regs[3] & (1 << 26)) != 0;
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx = (regs[2] & (1 << 28)) != 0;
+
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx && (ReadXCR0() & 0x6) == 0x6) {
+        Cpuid(regs, 7, 0);
+        avx2 = (regs[1] & (1 << 5)) != 0;
+    }
+
+    if (avx2) return ScanBackend::AVX2;
+    if (sse2) return ScanBackend::SSE2;
+#endif
+    return ScanBackend::SCALAR;
+}
+
+ScanBackend PatternScanner::GetBackend() {
+    int backend = g_backend.load(std::memory_order_relaxed);
+    if (backend < 0) {
+        backend = static_cast<int>(DetectBestBackend());
+        g_backend.store(backend, std::memory_order_relaxed);
+    }
+    return static_cast<ScanBackend>(backend);
+}
+
+void PatternScanner::SetBackend(ScanBackend backend) {
+    // No permitir forzar un backend que la CPU no soporta
+    if (static_cast<int>(backend) > static_cast<int>(DetectBestBackend())) {
+        backend = DetectBestBackend();
+    }
+    g_backend.store(static_cast<int>(backend), std::memory_order_relaxed);
+}
+
+const char* PatternScanner::BackendToString(ScanBackend backend) {
+    switch (backend) {
+    case ScanBackend::AVX2: return "AVX2";
+    case ScanBackend::SSE2: return "SSE2";
+    default: return "Scalar";
+    }
+}
+
+// ============================================================================
+// MultiPatternScanner
+// ============================================================================
+
+size_t MultiPatternScanner::AddPattern(const PatternView& pattern) {
+    return AddPattern(PatternScanner::Prepare(pattern));
+}
+
+size_t MultiPatternScanner::AddPattern(const PreparedPattern& pattern) {
+    patterns.push_back(pattern);
+    RebuildBuckets();
+    return patterns.size() - 1;
+}
+
+void MultiPatternScanner::RebuildBuckets() {
+    bucketOffsets.assign(257, 0);
+    anchorBytes.clear();
+
+    for (const PreparedPattern& pattern : patterns) {
+        if (pattern.hasAnchor) bucketOffsets[pattern.anchorByte + 1]++;
+    }
+    for (size_t value = 0; value < 256; ++value) {
+        if (bucketOffsets[value + 1]) anchorBytes.push_back(static_cast<uint8_t>(value));
+        bucketOffsets[value + 1] += bucketOffsets[value];
+    }
+
+    bucketPatterns.assign(bucketOffsets[256], 0);
+    std::vector<uint32_t> cursor(bucketOffsets.begin(), bucketOffsets.end() - 1);
+    for (size_t id = 0; id < patterns.size(); ++id) {
+        if (patterns[id].hasAnchor) {
+            bucketPatterns[cursor[patterns[id].anchorByte]++] = static_cast<uint32_t>(id);
+        }
+    }
+}
+
+bool MultiPatternScanner::ProcessPosition(const uint8_t* begin, size_t size, size_t position, ScanState& state) const {
+    const uint8_t value = begin[position];
+    for (uint32_t i = bucketOffsets[value]; i < bucketOffsets[value + 1]; ++i) {
+        const uint32_t id = bucketPatterns[i];
+        if (state.first && (*state.first)[id]) continue;
+
+        const PreparedPattern& pattern = patterns[id];
+        if (position < pattern.anchorIndex) continue;
+
+        const size_t candidate = position - pattern.anchorIndex;
+        if (candidate + pattern.view.length > size || candidate >= state.candidateEnd) continue;
+        if (begin[candidate + pattern.anchor2Index] != pattern.anchor2Byte) continue;
+
+        if (PatternScanner::MatchAt(begin + candidate, pattern.view)) {
+            if (state.all) {
+                (*state.all)[id].Add(begin + candidate, state.maxCandidates);
+                continue;
+            }
+
+            (*state.first)[id] = begin + candidate;
+            if (--state.remaining == 0) return true;
+        }
+    }
+    return false;
+}
+
+void MultiPatternScanner::ScanScalar(const uint8_t* begin, size_t size, size_t from, ScanState& state) const {
+    for (size_t position = from; position < size; ++position) {
+        const uint8_t value = begin[position];
+        if (bucketOffsets[value] == bucketOffsets[value + 1]) continue;
+        if (ProcessPosition(begin, size, position, state)) break;
+    }
+}
+
+void MultiPatternScanner::Scan(const uint8_t* begin, size_t size, ScanState& state) const {
+    // Con demasiados valores de ancla distintos el OR de comparaciones deja de compensar
+    if (anchorBytes.size() > MaxSimdAnchors) {
+        ScanScalar(begin, size, 0, state);
+        return;
+    }
+
+    switch (PatternScanner::GetBackend()) {
+    case ScanBackend::AVX2: ScanAVX2(begin, size, state); break;
+    case ScanBackend::SSE2: ScanSSE2(begin, size, state); break;
+    default:                ScanScalar(begin, size, 0, state); break;
+    }
+}
+
+size_t MultiPatternScanner::FindFirstAll(const uint8_t* begin, size_t size, std::vector<const uint8_t*>& results) const {
+    results.resize(patterns.size(), nullptr);
+
+    size_t remaining = 0;
+    for (size_t id = 0; id < patterns.size(); ++id) {
+        if (results[id]) continue;
+
+        // Patrón todo wildcards: coincide en la primera posición donde cabe
+        if (!patterns[id].hasAnchor && begin && patterns[id].view.length && size >= patterns[id].view.length) {
+            results[id] = begin;
+            continue;
+        }
+        if (patterns[id].hasAnchor) remaining++;
+    }
+
+    if (!begin || remaining == 0) return remaining;
+
+    ScanState state;
+    state.first = &results;
+    state.remaining = remaining;
+    Scan(begin, size, state);
+    return state.remaining;
+}
+
+void MultiPatternScanner::FindAll(const uint8_t* begin, size_t size, std::vector<PatternMatches>& results,
+                                  size_t maxCandidates, size_t candidateEnd) const {
+    results.resize(patterns.size());
+    if (!begin || patterns.empty()) return;
+
+    ScanState state;
+    state.all = &results;
+    state.maxCandidates = maxCandidates;
+    state.candidateEnd = candidateEnd;
+    Scan(begin, size, state);
+}
+
+void MultiPatternScanner::ScanSSE2(const uint8_t* begin, size_t size, ScanState& state) const {
+#if defined(HALO_SCAN_X86)
+    __m128i needles[MaxSimdAnchors];
+    const size_t needleCount = anchorBytes.size();
+    for (size_t k = 0; k < needleCount; ++k) {
+        needles[k] = _mm_set1_epi8(static_cast<char>(anchorBytes[k]));
+    }
+
+    size_t position = 0;
+    for (; position + 16 <= size; position += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + position));
+        __m128i hits = _mm_cmpeq_epi8(data, needles[0]);
+        for (size_t k = 1; k < needleCount; ++k) {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(data, needles[k]));
+        }
+
+        uint64_t bits = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        while (bits) {
+            if (ProcessPosition(begin, size, position + CountTrailingZeros64(bits), state)) return;
+            bits &= bits - 1;
+        }
+    }
+
+    ScanScalar(begin, size, position, state);
+#else
+    ScanScalar(begin, size, 0, state);
+#endif
+}
+
+HALO_TARGET_AVX2
+void MultiPatternScanner::ScanAVX2(const uint8_t* begin, size_t size, ScanState& state) const {
+#if defined(HALO_SCAN_X86)
+    __m256i needles[MaxSimdAnchors];
+    const size_t needleCount = anchorBytes.size();
+    for (size_t k = 0; k < needleCount; ++k) {
+        needles[k] = _mm256_set1_epi8(static_cast<char>(anchorBytes[k]));
+    }
+
+    size_t position = 0;
+    for (; position + 32 <= size; position += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin + position));
+        __m256i hits = _mm256_cmpeq_epi8(data, needles[0]);
+        for (size_t k = 1; k < needleCount; ++k) {
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(data, needles[k]));
+        }
+
+        uint64_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+        while (bits) {
+            if (ProcessPosition(begin, size, position + CountTrailingZeros64(bits), state)) return;
+            bits &= bits - 1;
+        }
+    }
+
+    ScanScalar(begin, size, position, state);
+#else
+    ScanScalar(begin, size, 0, state);
+#endif
+}
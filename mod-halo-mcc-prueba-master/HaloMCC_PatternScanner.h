@@ -0,0 +1,196 @@
+// HaloMCC_PatternScanner.h
+// Motor de búsqueda de patrones con máscara (SSE2/AVX2 + fallback escalar).
+// No depende de windows.h: opera sobre buffers crudos ya validados por el llamador.
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Vista no-propietaria de un patrón. mask[i] != 0 => byte significativo, 0 => wildcard.
+struct PatternView {
+    const uint8_t* bytes = nullptr;
+    const uint8_t* mask = nullptr;
+    size_t length = 0;
+};
+
+// Patrón listo para escanear: anclas elegidas una sola vez por escaneo.
+struct PreparedPattern {
+    PatternView view;
+    size_t anchorIndex = 0;     // byte más raro (no-wildcard)
+    size_t anchor2Index = 0;    // segundo byte más raro, en otra posición si existe
+    uint8_t anchorByte = 0;
+    uint8_t anchor2Byte = 0;
+    bool hasAnchor = false;     // false => patrón todo wildcards
+};
+
+// Todos los matches de un patrón (modo enumeración)
+struct PatternMatches {
+    size_t count = 0;                           // total de matches
+    std::vector<const uint8_t*> candidates;     // los primeros maxCandidates, en orden de dirección
+
+    void Add(const uint8_t* match, size_t maxCandidates) {
+        count++;
+        if (candidates.size() < maxCandidates) candidates.push_back(match);
+    }
+};
+
+enum class ScanBackend {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+class PatternScanner {
+public:
+    // constexpr: las firmas de HaloMCC_Signature.h eligen sus anclas en compilación
+    static constexpr PreparedPattern Prepare(const PatternView& pattern);
+
+    // Primer match en [begin, begin + size) o nullptr.
+    static const uint8_t* FindFirst(const uint8_t* begin, size_t size, const PreparedPattern& pattern);
+
+    // Comprueba el patrón completo en una posición concreta (sin anclas).
+    static bool MatchAt(const uint8_t* data, const PatternView& pattern);
+
+    // Backend elegido por CPUID en el primer uso; SetBackend permite forzarlo (tests/benchmarks).
+    static ScanBackend GetBackend();
+    static void SetBackend(ScanBackend backend);
+    static ScanBackend DetectBestBackend();
+    static const char* BackendToString(ScanBackend backend);
+
+    // Frecuencia aproximada de cada byte en código x86-64 (0 = raro, valores altos = común)
+    static constexpr uint8_t ByteCommonness(uint8_t value);
+
+private:
+    static const uint8_t* FindFirstScalar(const uint8_t* begin, size_t size, const PreparedPattern& pattern);
+    static const uint8_t* FindFirstSSE2(const uint8_t* begin, size_t size, const PreparedPattern& pattern);
+    static const uint8_t* FindFirstAVX2(const uint8_t* begin, size_t size, const PreparedPattern& pattern);
+};
+
+// ============================================================================
+// Elección de anclas (constexpr)
+// ============================================================================
+
+// Solo se usa para ordenar candidatos a ancla, no necesita ser exacta.
+constexpr uint8_t PatternScanner::ByteCommonness(uint8_t value) {
+    switch (value) {
+    case 0x00: return 255;
+    case 0xFF: return 200;
+    case 0x48: return 190;
+    case 0xCC: return 170;
+    case 0x8B: return 160;
+    case 0x89: return 150;
+    case 0x24: return 140;
+    case 0x0F: return 130;
+    case 0x4C: return 120;
+    case 0xE8: return 115;
+    case 0x01: return 110;
+    case 0x8D: return 105;
+    case 0x44: return 100;
+    case 0x83: return 95;
+    case 0x49: return 90;
+    case 0x41: return 85;
+    case 0x74: return 80;
+    case 0x85: return 75;
+    case 0xC0: return 70;
+    case 0x10: return 65;
+    case 0x20: return 60;
+    case 0x08: return 58;
+    case 0x75: return 56;
+    case 0x40: return 54;
+    case 0x33: return 52;
+    case 0x90: return 50;
+    case 0xC3: return 48;
+    case 0x28: return 46;
+    case 0x30: return 44;
+    case 0x04: return 42;
+    case 0x18: return 40;
+    case 0x38: return 38;
+    case 0x45: return 36;
+    case 0x02: return 34;
+    case 0x80: return 32;
+    case 0x05: return 30;
+    case 0x4D: return 28;
+    case 0x3D: return 26;
+    case 0x84: return 24;
+    default:   return 8;
+    }
+}
+
+constexpr PreparedPattern PatternScanner::Prepare(const PatternView& pattern) {
+    PreparedPattern prepared;
+    prepared.view = pattern;
+
+    size_t best = SIZE_MAX;
+    size_t second = SIZE_MAX;
+    for (size_t i = 0; i < pattern.length; ++i) {
+        if (!pattern.mask[i]) continue;
+
+        const uint8_t score = ByteCommonness(pattern.bytes[i]);
+        if (best == SIZE_MAX || score < ByteCommonness(pattern.bytes[best])) {
+            second = best;
+            best = i;
+        }
+        else if (second == SIZE_MAX || score < ByteCommonness(pattern.bytes[second])) {
+            second = i;
+        }
+    }
+
+    if (best == SIZE_MAX) return prepared;
+
+    if (second == SIZE_MAX) second = best;
+
+    prepared.hasAnchor = true;
+    prepared.anchorIndex = best;
+    prepared.anchor2Index = second;
+    prepared.anchorByte = pattern.bytes[best];
+    prepared.anchor2Byte = pattern.bytes[second];
+    return prepared;
+}
+
+// Varios patrones en una sola pasada sobre el buffer: tabla de anclas agrupadas por
+// valor de byte (bucket) + verificación completa solo de los patrones de ese bucket.
+class MultiPatternScanner {
+public:
+    // Devuelve el id del patrón (índice en el resultado). La vista debe seguir viva.
+    size_t AddPattern(const PatternView& pattern);
+    // Igual, con las anclas ya elegidas (Signature::Prepared)
+    size_t AddPattern(const PreparedPattern& pattern);
+    size_t GetPatternCount() const { return patterns.size(); }
+    const PreparedPattern& GetPattern(size_t id) const { return patterns[id]; }
+
+    // results[id] = primer match de cada patrón. Las entradas que ya vienen con valor se
+    // consideran resueltas, así se puede llamar varias veces (una por región legible).
+    // Devuelve cuántos patrones siguen sin encontrarse.
+    size_t FindFirstAll(const uint8_t* begin, size_t size, std::vector<const uint8_t*>& results) const;
+
+    // Todos los matches de cada patrón en la misma pasada (no se para en el primero).
+    // Solo cuentan los que empiezan antes de candidateEnd (chunks solapados). Se suma a lo
+    // que ya haya en results, así se puede llamar una vez por región en orden ascendente.
+    void FindAll(const uint8_t* begin, size_t size, std::vector<PatternMatches>& results,
+                 size_t maxCandidates, size_t candidateEnd = SIZE_MAX) const;
+
+private:
+    static const size_t MaxSimdAnchors = 16;
+
+    // Estado de una pasada: primer match por patrón (first) o enumeración (all)
+    struct ScanState {
+        std::vector<const uint8_t*>* first = nullptr;
+        std::vector<PatternMatches>* all = nullptr;
+        size_t maxCandidates = 0;
+        size_t candidateEnd = SIZE_MAX;
+        size_t remaining = 0;
+    };
+
+    void RebuildBuckets();
+    // true = no queda nada por buscar
+    bool ProcessPosition(const uint8_t* begin, size_t size, size_t position, ScanState& state) const;
+    void Scan(const uint8_t* begin, size_t size, ScanState& state) const;
+    void ScanScalar(const uint8_t* begin, size_t size, size_t from, ScanState& state) const;
+    void ScanSSE2(const uint8_t* begin, size_t size, ScanState& state) const;
+    void ScanAVX2(const uint8_t* begin, size_t size, ScanState& state) const;
+
+    std::vector<PreparedPattern> patterns;
+    std::vector<uint8_t> anchorBytes;           // valores de ancla distintos
+    std::vector<uint32_t> bucketOffsets;        // 257 entradas, layout CSR por valor de byte
+    std::vector<uint32_t> bucketPatterns;       // ids de patrón agrupados por ancla
+};
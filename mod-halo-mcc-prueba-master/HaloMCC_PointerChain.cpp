@@ -0,0 +1,145 @@
+// HaloMCC_PointerChain.cpp
+#include "HaloMCC_PointerChain.h"
+#include <algorithm>
+
+PointerChainCache::PointerChainCache() {
+    for (size_t i = 0; i < MaxChains; ++i) {
+        present[i].store(false, std::memory_order_relaxed);
+        addresses[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void PointerChainCache::SetReader(ProcessReadFunction function, void* context) {
+    std::lock_guard<std::mutex> lock(mutex);
+    read = function;
+    readContext = context;
+}
+
+void PointerChainCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < MaxChains; ++i) {
+        chains[i] = Chain();
+        present[i].store(false, std::memory_order_release);
+        addresses[i].store(0, std::memory_order_release);
+    }
+    watches.clear();
+    Invalidate();
+}
+
+bool PointerChainCache::SetChain(ChainId id, uintptr_t baseAddress, const std::vector<int32_t>& offsets) {
+    if (id >= MaxChains) return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    chains[id].used = true;
+    chains[id].baseAddress = baseAddress;
+    chains[id].offsets = offsets;
+    present[id].store(true, std::memory_order_release);
+    Invalidate();
+    return true;
+}
+
+bool PointerChainCache::AddWatch(uintptr_t address) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!address || watches.size() >= MaxWatches) return false;
+
+    Watch watch;
+    watch.address = address;
+    watches.push_back(watch);
+    return true;
+}
+
+bool PointerChainCache::Poll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!read) return false;
+
+    bool changed = false;
+    for (Watch& watch : watches) {
+        uint32_t value = 0;
+        if (!read(readContext, watch.address, &value, sizeof(value))) value = 0;
+
+        if (watch.known && value != watch.value) changed = true;
+        watch.value = value;
+        watch.known = true;
+    }
+
+    if (changed) Invalidate();
+    return changed;
+}
+
+bool PointerChainCache::Refresh() {
+    if (resolvedGeneration.load(std::memory_order_acquire) == generation.load(std::memory_order_acquire)) return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    // Otro hilo pudo resolver mientras se esperaba el lock. Se apunta la generación leída
+    // antes de resolver: una invalidación durante la resolución fuerza otra pasada
+    const uint64_t target = generation.load(std::memory_order_acquire);
+    if (resolvedGeneration.load(std::memory_order_acquire) == target) return false;
+
+    ResolveAll();
+    resolvedGeneration.store(target, std::memory_order_release);
+    return true;
+}
+
+size_t PointerChainCache::GetChainCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (const Chain& chain : chains) {
+        if (chain.used) count++;
+    }
+    return count;
+}
+
+size_t PointerChainCache::GetResolvedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (size_t i = 0; i < MaxChains; ++i) {
+        if (chains[i].used && addresses[i].load(std::memory_order_relaxed)) count++;
+    }
+    return count;
+}
+
+// Todas las cadenas a la vez, nivel a nivel: en cada nivel se leen una sola vez las celdas
+// distintas (las cadenas que comparten prefijo, como cámara y jugadores colgando del mismo
+// objeto global, comparten lecturas)
+void PointerChainCache::ResolveAll() {
+    std::array<uintptr_t, MaxChains> current = {};
+    std::array<bool, MaxChains> alive = {};
+    size_t depth = 0;
+    for (size_t i = 0; i < MaxChains; ++i) {
+        if (!chains[i].used) continue;
+        current[i] = chains[i].baseAddress;
+        alive[i] = read != nullptr;
+        depth = std::max(depth, chains[i].offsets.size());
+    }
+
+    std::vector<uintptr_t> cells;
+    std::vector<uint64_t> values;
+    for (size_t level = 0; level < depth; ++level) {
+        cells.clear();
+        for (size_t i = 0; i < MaxChains; ++i) {
+            if (alive[i] && level < chains[i].offsets.size()) cells.push_back(current[i]);
+        }
+        std::sort(cells.begin(), cells.end());
+        cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+        values.assign(cells.size(), 0);
+        for (size_t c = 0; c < cells.size(); ++c) {
+            if (!read(readContext, cells[c], &values[c], sizeof(uint64_t))) values[c] = 0;
+        }
+
+        for (size_t i = 0; i < MaxChains; ++i) {
+            if (!alive[i] || level >= chains[i].offsets.size()) continue;
+
+            const size_t cell = std::lower_bound(cells.begin(), cells.end(), current[i]) - cells.begin();
+            if (!values[cell]) {
+                alive[i] = false;
+                continue;
+            }
+            current[i] = static_cast<uintptr_t>(values[cell] + static_cast<int64_t>(chains[i].offsets[level]));
+        }
+    }
+
+    for (size_t i = 0; i < MaxChains; ++i) {
+        addresses[i].store(alive[i] ? current[i] : 0, std::memory_order_release);
+    }
+}
@@ -0,0 +1,80 @@
+// HaloMCC_PointerChain.h
+// Direcciones finales de las cadenas de punteros del perfil (cámara, tabla de jugadores...)
+// cacheadas. Leer una es una sola carga atómica; las cadenas se vuelven a recorrer todas a la
+// vez solo cuando sube la generación: cambia un valor vigilado (estado de juego/menú, es
+// decir, cambio de nivel) o alguien invalida a mano (carga/descarga de un módulo).
+// Sin windows.h: la lectura la pone quien llama (bajo SEH en el DLL).
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "HaloMCC_ProcessMemory.h"
+
+class PointerChainCache {
+public:
+    // Huecos fijos (el DLL usa el OffsetField de cada campo): así leer no depende de un vector
+    // que otro hilo pueda estar rehaciendo
+    typedef uint32_t ChainId;
+    static const size_t MaxChains = 16;
+    static const size_t MaxWatches = 4;
+
+    PointerChainCache();
+
+    void SetReader(ProcessReadFunction function, void* context);
+
+    // Quita cadenas y vigilancias; los Get() que estén en curso devuelven 0
+    void Clear();
+    // [[baseAddress] + offsets[0]] ... + offsets[n-1] (mismo formato que PointerPath, ya con la
+    // base del módulo sumada). false si id >= MaxChains
+    bool SetChain(ChainId id, uintptr_t baseAddress, const std::vector<int32_t>& offsets);
+    // Valor de 32 bits que, si cambia, invalida todas las cadenas
+    bool AddWatch(uintptr_t address);
+
+    void Invalidate() { generation.fetch_add(1, std::memory_order_acq_rel); }
+    uint64_t GetGeneration() const { return generation.load(std::memory_order_acquire); }
+
+    bool HasChain(ChainId id) const {
+        return id < MaxChains && present[id].load(std::memory_order_acquire);
+    }
+    // Dirección final de la cadena (0 = no hay o no resolvió). Una carga, desde cualquier hilo
+    uintptr_t Get(ChainId id) const {
+        return id < MaxChains ? addresses[id].load(std::memory_order_acquire) : 0;
+    }
+
+    // Lee los valores vigilados e invalida si alguno cambió. true si invalidó
+    bool Poll();
+    // Re-resuelve todas las cadenas si la generación cambió desde la última vez; si no, solo
+    // cuesta comparar dos contadores. true si resolvió
+    bool Refresh();
+
+    size_t GetChainCount() const;
+    size_t GetResolvedCount() const;
+
+private:
+    struct Chain {
+        bool used = false;
+        uintptr_t baseAddress = 0;
+        std::vector<int32_t> offsets;
+    };
+
+    struct Watch {
+        uintptr_t address = 0;
+        uint32_t value = 0;
+        bool known = false;
+    };
+
+    void ResolveAll();
+
+    mutable std::mutex mutex;           // cadenas, vigilancias y resolución; Get() no lo toca
+    std::array<Chain, MaxChains> chains;
+    std::vector<Watch> watches;
+    std::array<std::atomic<bool>, MaxChains> present;
+    std::array<std::atomic<uintptr_t>, MaxChains> addresses;
+    std::atomic<uint64_t> generation{ 1 };
+    std::atomic<uint64_t> resolvedGeneration{ 0 };
+    ProcessReadFunction read = nullptr;
+    void* readContext = nullptr;
+};
@@ -0,0 +1,335 @@
+// HaloMCC_PointerScan.cpp
+#include "HaloMCC_PointerScan.h"
+#include "HaloMCC_ProcessMemory.h"
+#include "HaloMCC_ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <unordered_set>
+
+namespace {
+
+// Unidad de trabajo al construir el mapa
+const size_t MapChunkSize = 4 * 1024 * 1024;
+// Nodos por tarea al expandir un nivel
+const size_t NodesPerTask = 1024;
+
+void RunTasks(ScanThreadPool* pool, size_t count, const std::function<void(size_t)>& task) {
+    if (pool) {
+        pool->ParallelFor(count, task);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) task(i);
+}
+
+std::string TrimSpaces(const std::string& text) {
+    const size_t first = text.find_first_not_of(" \t");
+    if (first == std::string::npos) return std::string();
+    const size_t last = text.find_last_not_of(" \t\r\n");
+    return text.substr(first, last - first + 1);
+}
+
+// "0x1A", "1A", "-0x8"; todo el texto tiene que ser el número
+bool ParseHex(const std::string& text, long long& value) {
+    std::string digits = TrimSpaces(text);
+    bool negative = false;
+    if (!digits.empty() && digits[0] == '-') {
+        negative = true;
+        digits = digits.substr(1);
+    }
+    if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) digits = digits.substr(2);
+    if (digits.empty()) return false;
+
+    char* end = nullptr;
+    const unsigned long long parsed = std::strtoull(digits.c_str(), &end, 16);
+    if (*end != '\0' || parsed > 0xFFFFFFFFull) return false;
+    value = negative ? -static_cast<long long>(parsed) : static_cast<long long>(parsed);
+    return true;
+}
+
+std::string ToHex(long long value) {
+    char buffer[32];
+    if (value < 0) std::snprintf(buffer, sizeof(buffer), "-0x%llX", static_cast<unsigned long long>(-value));
+    else std::snprintf(buffer, sizeof(buffer), "0x%llX", static_cast<unsigned long long>(value));
+    return buffer;
+}
+
+} // namespace
+
+// ============================================================================
+// PointerPath
+// ============================================================================
+
+std::string PointerPath::ToString() const {
+    std::string text = module + "+" + ToHex(baseRva);
+    for (int32_t offset : offsets) text += " -> " + ToHex(offset);
+    return text;
+}
+
+bool PointerPath::Parse(const std::string& text, PointerPath& path) {
+    path = PointerPath();
+
+    std::vector<std::string> parts;
+    size_t start = 0;
+    for (;;) {
+        const size_t arrow = text.find("->", start);
+        parts.push_back(TrimSpaces(text.substr(start, arrow == std::string::npos ? std::string::npos : arrow - start)));
+        if (arrow == std::string::npos) break;
+        start = arrow + 2;
+    }
+
+    const size_t plus = parts[0].rfind('+');
+    long long value = 0;
+    if (plus == std::string::npos || plus == 0 || !ParseHex(parts[0].substr(plus + 1), value) || value < 0) return false;
+
+    for (size_t i = 0; i < plus; ++i) {
+        const char c = parts[0][i];
+        path.module.push_back((c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c);
+    }
+    path.baseRva = static_cast<uint32_t>(value);
+
+    for (size_t i = 1; i < parts.size(); ++i) {
+        if (!ParseHex(parts[i], value) || value > 0x7FFFFFFF || value < -0x7FFFFFFF) return false;
+        path.offsets.push_back(static_cast<int32_t>(value));
+    }
+    return true;
+}
+
+bool PointerPath::Resolve(const ProcessMemory& memory, uintptr_t& address) const {
+    const ProcessModule* base = memory.FindModuleByName(module.c_str());
+    if (!base || baseRva >= base->size) return false;
+
+    address = base->base + baseRva;
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        uint64_t value = 0;
+        if (!memory.ReadPointer(address, value) || !value) return false;
+        address = static_cast<uintptr_t>(value + static_cast<int64_t>(offsets[i]));
+    }
+    return true;
+}
+
+// ============================================================================
+// PointerMap
+// ============================================================================
+
+bool PointerMap::Build(const ProcessMemory& memory, ScanThreadPool* pool, size_t maxEntries) {
+    entries.clear();
+
+    // Rangos válidos (regiones contiguas unidas) para descartar valores que no son punteros
+    std::vector<std::pair<uint64_t, uint64_t>> valid;
+    for (const ProcessRegion& region : memory.GetRegions()) {
+        if (!valid.empty() && valid.back().second == region.base) valid.back().second += region.size;
+        else valid.emplace_back(region.base, region.base + region.size);
+    }
+    if (valid.empty()) return true;
+    const uint64_t lowest = valid.front().first;
+    const uint64_t highest = valid.back().second;
+
+    struct Chunk {
+        const ProcessRegion* region;
+        size_t offset;
+        size_t size;
+    };
+    std::vector<Chunk> chunks;
+    for (const ProcessRegion& region : memory.GetRegions()) {
+        if (!(region.flags & REGION_WRITABLE)) continue;
+        for (size_t offset = 0; offset < region.size; offset += MapChunkSize) {
+            const size_t size = region.size - offset < MapChunkSize ? region.size - offset : MapChunkSize;
+            chunks.push_back(Chunk{ &region, offset, size });
+        }
+    }
+
+    // Cada chunk deja sus punteros ordenados en su propio vector
+    std::vector<std::vector<Entry>> found(chunks.size());
+    std::atomic<size_t> total{ 0 };
+    std::atomic<bool> overflow{ false };
+    RunTasks(pool, chunks.size(), [&](size_t index) {
+        if (overflow.load(std::memory_order_relaxed)) return;
+
+        const Chunk& chunk = chunks[index];
+        const uintptr_t base = chunk.region->base + chunk.offset;
+        std::vector<uint8_t> buffer;
+        const uint8_t* data = nullptr;
+        if (chunk.region->data) {
+            data = chunk.region->data + chunk.offset;
+        }
+        else {
+            buffer.resize(chunk.size);
+            if (!memory.Read(base, buffer.data(), chunk.size)) return;
+            data = buffer.data();
+        }
+
+        std::vector<Entry>& out = found[index];
+        const size_t skew = (8 - base % 8) % 8;
+        for (size_t offset = skew; offset + 8 <= chunk.size; offset += 8) {
+            uint64_t value;
+            std::memcpy(&value, data + offset, sizeof(value));
+            if (value < lowest || value >= highest) continue;
+
+            auto it = std::upper_bound(valid.begin(), valid.end(), value,
+                [](uint64_t v, const std::pair<uint64_t, uint64_t>& range) { return v < range.first; });
+            if (it == valid.begin() || value >= (it - 1)->second) continue;
+
+            out.push_back(Entry{ value, static_cast<uint64_t>(base + offset) });
+        }
+
+        if (total.fetch_add(out.size(), std::memory_order_relaxed) + out.size() > maxEntries) {
+            overflow.store(true, std::memory_order_relaxed);
+            return;
+        }
+        std::sort(out.begin(), out.end(), [](const Entry& a, const Entry& b) { return a.value < b.value; });
+    });
+
+    if (overflow.load()) {
+        found.clear();
+        return false;
+    }
+
+    // Runs ordenados contiguos y mezcla por parejas en paralelo hasta que queda uno
+    std::vector<size_t> bounds(1, 0);
+    entries.reserve(total.load());
+    for (std::vector<Entry>& part : found) {
+        if (part.empty()) continue;
+        entries.insert(entries.end(), part.begin(), part.end());
+        bounds.push_back(entries.size());
+        std::vector<Entry>().swap(part);
+    }
+
+    while (bounds.size() > 2) {
+        const size_t runs = bounds.size() - 1;
+        RunTasks(pool, runs / 2, [&](size_t pair) {
+            std::inplace_merge(entries.begin() + bounds[pair * 2], entries.begin() + bounds[pair * 2 + 1],
+                entries.begin() + bounds[pair * 2 + 2],
+                [](const Entry& a, const Entry& b) { return a.value < b.value; });
+        });
+
+        std::vector<size_t> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2) merged.push_back(bounds[i]);
+        if (merged.back() != bounds.back()) merged.push_back(bounds.back());
+        bounds.swap(merged);
+    }
+    return true;
+}
+
+const PointerMap::Entry* PointerMap::LowerBound(uint64_t low) const {
+    auto it = std::lower_bound(entries.begin(), entries.end(), low,
+        [](const Entry& entry, uint64_t value) { return entry.value < value; });
+    return entries.data() + (it - entries.begin());
+}
+
+// ============================================================================
+// PointerScanner
+// ============================================================================
+
+size_t PointerScanner::Scan(const ProcessMemory& memory, const PointerMap& map, uintptr_t target,
+                            const PointerScanOptions& options, std::vector<PointerPath>& results) {
+    results.clear();
+
+    // Nodo = dirección de un puntero; offset = cuánto hay que sumarle a su valor para llegar
+    // al nodo hijo (nivel anterior), parent = índice de ese hijo
+    struct Node {
+        uint64_t address;
+        uint32_t parent;
+        int32_t offset;
+    };
+    struct Hit {
+        Node node;
+        const ProcessModule* module;
+    };
+
+    auto acceptsModule = [&](const ProcessModule* module) {
+        if (!module) return false;
+        if (options.modules.empty()) return true;
+        return std::find(options.modules.begin(), options.modules.end(), module->name) != options.modules.end();
+    };
+
+    std::vector<std::vector<Node>> levels(1);
+    levels[0].push_back(Node{ static_cast<uint64_t>(target), 0, 0 });
+    std::unordered_set<uint64_t> visited;
+    visited.insert(target);
+
+    for (unsigned depth = 1; depth <= options.maxDepth && !levels.back().empty(); ++depth) {
+        const std::vector<Node>& current = levels.back();
+        const size_t taskCount = (current.size() + NodesPerTask - 1) / NodesPerTask;
+        std::vector<std::vector<Node>> next(taskCount);
+        std::vector<std::vector<Hit>> hits(taskCount);
+        const bool last = depth == options.maxDepth;
+
+        RunTasks(options.pool, taskCount, [&](size_t task) {
+            const size_t end = std::min(current.size(), (task + 1) * NodesPerTask);
+            for (size_t index = task * NodesPerTask; index < end; ++index) {
+                const uint64_t address = current[index].address;
+                const uint64_t low = address > options.maxOffset ? address - options.maxOffset : 0;
+
+                for (const PointerMap::Entry* entry = map.LowerBound(low); entry != map.End() && entry->value <= address; ++entry) {
+                    const Node node{ entry->address, static_cast<uint32_t>(index), static_cast<int32_t>(address - entry->value) };
+
+                    // Un puntero dentro de un módulo es estático: la cadena termina ahí
+                    const ProcessModule* module = memory.FindModule(static_cast<uintptr_t>(entry->address));
+                    if (module) {
+                        if (acceptsModule(module)) hits[task].push_back(Hit{ node, module });
+                    }
+                    else if (!last) {
+                        next[task].push_back(node);
+                    }
+                }
+            }
+        });
+
+        // Cadenas completas de este nivel: offsets desde el puntero estático hacia el objetivo
+        for (const std::vector<Hit>& taskHits : hits) {
+            for (const Hit& hit : taskHits) {
+                PointerPath path;
+                path.module = hit.module->name;
+                path.baseRva = static_cast<uint32_t>(hit.node.address - hit.module->base);
+                path.offsets.push_back(hit.node.offset);
+
+                uint32_t parent = hit.node.parent;
+                for (size_t level = depth - 1; level > 0; --level) {
+                    const Node& node = levels[level][parent];
+                    path.offsets.push_back(node.offset);
+                    parent = node.parent;
+                }
+                results.push_back(path);
+            }
+        }
+        if (results.size() >= options.maxResults) break;
+
+        // Siguiente nivel sin repetir direcciones (la primera llegada es la de menor profundidad)
+        std::vector<Node> level;
+        for (const std::vector<Node>& taskNodes : next) {
+            for (const Node& node : taskNodes) {
+                if (level.size() >= options.maxNodesPerLevel) break;
+                if (visited.insert(node.address).second) level.push_back(node);
+            }
+        }
+        levels.push_back(std::move(level));
+    }
+
+    auto weight = [](const PointerPath& path) {
+        uint64_t sum = 0;
+        for (int32_t offset : path.offsets) sum += static_cast<uint64_t>(offset < 0 ? -static_cast<int64_t>(offset) : offset);
+        return sum;
+    };
+    std::stable_sort(results.begin(), results.end(), [&](const PointerPath& a, const PointerPath& b) {
+        if (a.offsets.size() != b.offsets.size()) return a.offsets.size() < b.offsets.size();
+        return weight(a) < weight(b);
+    });
+    if (results.size() > options.maxResults) results.resize(options.maxResults);
+    return results.size();
+}
+
+size_t PointerScanner::Filter(const ProcessMemory& memory, uintptr_t target, std::vector<PointerPath>& paths) {
+    size_t kept = 0;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        uintptr_t address = 0;
+        if (!paths[i].Resolve(memory, address) || address != target) continue;
+        if (kept != i) paths[kept] = std::move(paths[i]);
+        kept++;
+    }
+    paths.resize(kept);
+    return kept;
+}
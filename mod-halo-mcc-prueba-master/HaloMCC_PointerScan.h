@@ -0,0 +1,76 @@
+// HaloMCC_PointerScan.h
+// Búsqueda de cadenas de punteros estables hacia una dirección dinámica (cámara, tabla de
+// jugadores...): módulo+rva -> [+off]... -> objetivo. Se hace hacia atrás: todos los punteros
+// del proceso en un mapa ordenado por valor y, nivel a nivel, los que apuntan cerca de los
+// nodos del nivel anterior, hasta dar con uno dentro de un módulo (dirección estática).
+// Sin windows.h: funciona sobre el proceso vivo y sobre volcados (tools/halo_pointer_scan).
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ProcessMemory;
+class ScanThreadPool;
+
+// [[module+baseRva] + offsets[0]] ... + offsets[n-1]: cada offset salvo el último se suma y se
+// desreferencia; el último da la dirección final
+struct PointerPath {
+    std::string module;
+    uint32_t baseRva = 0;
+    std::vector<int32_t> offsets;
+
+    bool operator==(const PointerPath& other) const {
+        return module == other.module && baseRva == other.baseRva && offsets == other.offsets;
+    }
+
+    // "halo3.dll+0x1A2B30 -> 0x10 -> 0x48"; Parse acepta lo mismo (y offsets negativos "-0x8")
+    std::string ToString() const;
+    static bool Parse(const std::string& text, PointerPath& path);
+
+    // Dirección final en 'memory'; false si el módulo no está o algún puntero no se puede leer
+    bool Resolve(const ProcessMemory& memory, uintptr_t& address) const;
+};
+
+struct PointerScanOptions {
+    unsigned maxDepth = 4;              // punteros en la cadena
+    uint32_t maxOffset = 0x1000;        // offset máximo en cada nivel (tamaño de estructura)
+    size_t maxResults = 256;
+    size_t maxNodesPerLevel = 1 << 20;  // tope de la explosión combinatoria
+    // Solo cadenas que empiezan en estos módulos (vacío = cualquiera), en minúsculas
+    std::vector<std::string> modules;
+    ScanThreadPool* pool = nullptr;
+};
+
+// Todos los valores alineados a 8 de las regiones escribibles que apuntan dentro de alguna
+// región, ordenados por valor
+class PointerMap {
+public:
+    struct Entry {
+        uint64_t value;
+        uint64_t address;
+    };
+
+    // false si hay más de maxEntries punteros (16 bytes cada uno)
+    bool Build(const ProcessMemory& memory, ScanThreadPool* pool = nullptr, size_t maxEntries = 64u * 1024u * 1024u);
+
+    size_t GetCount() const { return entries.size(); }
+    size_t GetMemoryUsage() const { return entries.capacity() * sizeof(Entry); }
+
+    // Punteros con valor en [low, high], en orden de valor
+    const Entry* LowerBound(uint64_t low) const;
+    const Entry* End() const { return entries.data() + entries.size(); }
+
+private:
+    std::vector<Entry> entries;
+};
+
+class PointerScanner {
+public:
+    // Cadenas hacia 'target', las más cortas primero (y a igual profundidad, offsets menores)
+    static size_t Scan(const ProcessMemory& memory, const PointerMap& map, uintptr_t target,
+                       const PointerScanOptions& options, std::vector<PointerPath>& results);
+
+    // Se queda con las cadenas que en 'memory' (otra sesión, otro nivel) llevan a 'target'
+    static size_t Filter(const ProcessMemory& memory, uintptr_t target, std::vector<PointerPath>& paths);
+};
@@ -0,0 +1,284 @@
+// HaloMCC_ProcessMemory.cpp
+#include "HaloMCC_ProcessMemory.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+// ============================================================================
+// Serialización (little-endian)
+// ============================================================================
+
+namespace {
+
+void WriteU32(std::ofstream& out, uint32_t value) {
+    uint8_t bytes[4];
+    for (int i = 0; i < 4; ++i) bytes[i] = static_cast<uint8_t>(value >> (i * 8));
+    out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+void WriteU64(std::ofstream& out, uint64_t value) {
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; ++i) bytes[i] = static_cast<uint8_t>(value >> (i * 8));
+    out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+// Lector con límites sobre el fichero mapeado
+struct DumpCursor {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+
+    bool ReadU32(uint32_t& value) {
+        if (size - offset < 4) return false;
+        value = 0;
+        for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(data[offset + i]) << (i * 8);
+        offset += 4;
+        return true;
+    }
+
+    bool ReadU64(uint64_t& value) {
+        if (size - offset < 8) return false;
+        value = 0;
+        for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(data[offset + i]) << (i * 8);
+        offset += 8;
+        return true;
+    }
+};
+
+const size_t DumpHeaderSize = 16;
+const size_t DumpRegionEntrySize = 32;
+const size_t DumpModuleEntrySize = 32;      // sin el nombre
+const uint32_t MaxModuleNameLength = 260;
+
+char ToLowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+} // namespace
+
+// ============================================================================
+// Regiones y módulos
+// ============================================================================
+
+void ProcessMemory::Clear() {
+    regions.clear();
+    modules.clear();
+    read = nullptr;
+    readContext = nullptr;
+}
+
+void ProcessMemory::AddRegion(const ProcessRegion& region) {
+    if (region.size) regions.push_back(region);
+}
+
+void ProcessMemory::AddModule(const ProcessModule& module) {
+    modules.push_back(module);
+}
+
+void ProcessMemory::Finalize() {
+    std::sort(regions.begin(), regions.end(),
+        [](const ProcessRegion& a, const ProcessRegion& b) { return a.base < b.base; });
+    std::sort(modules.begin(), modules.end(),
+        [](const ProcessModule& a, const ProcessModule& b) { return a.base < b.base; });
+}
+
+void ProcessMemory::SetReader(ProcessReadFunction function, void* context) {
+    read = function;
+    readContext = context;
+}
+
+size_t ProcessMemory::GetTotalSize() const {
+    size_t total = 0;
+    for (const ProcessRegion& region : regions) total += region.size;
+    return total;
+}
+
+const ProcessRegion* ProcessMemory::FindRegion(uintptr_t address) const {
+    auto it = std::upper_bound(regions.begin(), regions.end(), address,
+        [](uintptr_t value, const ProcessRegion& region) { return value < region.base; });
+    if (it == regions.begin()) return nullptr;
+    --it;
+    return address - it->base < it->size ? &*it : nullptr;
+}
+
+const ProcessModule* ProcessMemory::FindModule(uintptr_t address) const {
+    auto it = std::upper_bound(modules.begin(), modules.end(), address,
+        [](uintptr_t value, const ProcessModule& module) { return value < module.base; });
+    if (it == modules.begin()) return nullptr;
+    --it;
+    return address - it->base < it->size ? &*it : nullptr;
+}
+
+const ProcessModule* ProcessMemory::FindModuleByName(const char* name) const {
+    std::string lower;
+    for (const char* c = name; *c; ++c) lower.push_back(ToLowerAscii(*c));
+    for (const ProcessModule& module : modules) {
+        if (module.name == lower) return &module;
+    }
+    return nullptr;
+}
+
+bool ProcessMemory::Read(uintptr_t address, void* buffer, size_t size) const {
+    uint8_t* out = static_cast<uint8_t*>(buffer);
+    while (size) {
+        const ProcessRegion* region = FindRegion(address);
+        if (!region) return false;
+
+        const size_t offset = address - region->base;
+        const size_t length = region->size - offset < size ? region->size - offset : size;
+        if (region->data) {
+            std::memcpy(out, region->data + offset, length);
+        }
+        else if (!read || !read(readContext, address, out, length)) {
+            return false;
+        }
+
+        address += length;
+        out += length;
+        size -= length;
+    }
+    return true;
+}
+
+bool ProcessMemory::ReadPointer(uintptr_t address, uint64_t& value) const {
+    return Read(address, &value, sizeof(value));
+}
+
+const uint8_t* ProcessMemory::GetData(uintptr_t address, size_t size) const {
+    const ProcessRegion* region = FindRegion(address);
+    if (!region || !region->data) return nullptr;
+
+    const uint8_t* start = region->data + (address - region->base);
+    size_t covered = region->size - (address - region->base);
+    for (size_t i = region - regions.data() + 1; covered < size; ++i) {
+        if (i >= regions.size()) return nullptr;
+
+        const ProcessRegion& previous = regions[i - 1];
+        const ProcessRegion& next = regions[i];
+        if (next.base != previous.base + previous.size || next.data != previous.data + previous.size) return nullptr;
+        covered += next.size;
+    }
+    return start;
+}
+
+// ============================================================================
+// Volcado
+// ============================================================================
+
+bool ProcessMemory::SaveDump(const std::string& path, const std::atomic<bool>* stop) const {
+    size_t tableSize = DumpHeaderSize + regions.size() * DumpRegionEntrySize;
+    for (const ProcessModule& module : modules) tableSize += DumpModuleEntrySize + module.name.size();
+
+    // Igual que la caché de offsets: temporal + rename
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+
+        WriteU32(out, DumpMagic);
+        WriteU32(out, DumpVersion);
+        WriteU32(out, static_cast<uint32_t>(modules.size()));
+        WriteU32(out, static_cast<uint32_t>(regions.size()));
+
+        for (const ProcessModule& module : modules) {
+            WriteU64(out, module.base);
+            WriteU64(out, module.size);
+            WriteU32(out, module.timeDateStamp);
+            WriteU32(out, module.sizeOfImage);
+            WriteU32(out, module.checkSum);
+            WriteU32(out, static_cast<uint32_t>(module.name.size()));
+            out.write(module.name.data(), static_cast<std::streamsize>(module.name.size()));
+        }
+
+        uint64_t fileOffset = (tableSize + DumpAlignment - 1) & ~static_cast<uint64_t>(DumpAlignment - 1);
+        for (const ProcessRegion& region : regions) {
+            WriteU64(out, region.base);
+            WriteU64(out, region.size);
+            WriteU32(out, region.protect);
+            WriteU32(out, region.flags);
+            WriteU64(out, fileOffset);
+            fileOffset += (region.size + DumpAlignment - 1) & ~static_cast<uint64_t>(DumpAlignment - 1);
+        }
+
+        // Datos por bloques: una región del proceso vivo puede tener cientos de MB
+        std::vector<uint8_t> buffer(1024 * 1024);
+        const std::vector<uint8_t> padding(DumpAlignment, 0);
+        size_t written = tableSize;
+        bool stopped = false;
+        for (const ProcessRegion& region : regions) {
+            if (stopped) break;
+            const size_t pad = (DumpAlignment - written % DumpAlignment) % DumpAlignment;
+            out.write(reinterpret_cast<const char*>(padding.data()), static_cast<std::streamsize>(pad));
+            written += pad;
+
+            for (size_t offset = 0; offset < region.size; offset += buffer.size()) {
+                if (stop && stop->load(std::memory_order_relaxed)) {
+                    stopped = true;
+                    break;
+                }
+                const size_t length = region.size - offset < buffer.size() ? region.size - offset : buffer.size();
+                if (!Read(region.base + offset, buffer.data(), length)) std::memset(buffer.data(), 0, length);
+                out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(length));
+            }
+            written += region.size;
+        }
+
+        if (stopped || !out.good()) {
+            out.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::remove(path.c_str());
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+bool ProcessMemory::OpenDump(const uint8_t* data, size_t size) {
+    Clear();
+
+    DumpCursor cursor{ data, size, 0 };
+    uint32_t magic = 0, version = 0, moduleCount = 0, regionCount = 0;
+    if (!cursor.ReadU32(magic) || magic != DumpMagic) return false;
+    if (!cursor.ReadU32(version) || version != DumpVersion) return false;
+    if (!cursor.ReadU32(moduleCount) || !cursor.ReadU32(regionCount)) return false;
+    if (moduleCount > size / DumpModuleEntrySize || regionCount > size / DumpRegionEntrySize) return false;
+
+    for (uint32_t i = 0; i < moduleCount; ++i) {
+        ProcessModule module;
+        uint64_t base = 0, moduleSize = 0;
+        uint32_t nameLength = 0;
+        if (!cursor.ReadU64(base) || !cursor.ReadU64(moduleSize) || !cursor.ReadU32(module.timeDateStamp) ||
+            !cursor.ReadU32(module.sizeOfImage) || !cursor.ReadU32(module.checkSum) || !cursor.ReadU32(nameLength) ||
+            nameLength > MaxModuleNameLength || size - cursor.offset < nameLength) {
+            Clear();
+            return false;
+        }
+
+        module.base = static_cast<uintptr_t>(base);
+        module.size = static_cast<size_t>(moduleSize);
+        module.name.assign(reinterpret_cast<const char*>(data + cursor.offset), nameLength);
+        cursor.offset += nameLength;
+        modules.push_back(module);
+    }
+
+    for (uint32_t i = 0; i < regionCount; ++i) {
+        ProcessRegion region;
+        uint64_t base = 0, regionSize = 0, fileOffset = 0;
+        if (!cursor.ReadU64(base) || !cursor.ReadU64(regionSize) || !cursor.ReadU32(region.protect) ||
+            !cursor.ReadU32(region.flags) || !cursor.ReadU64(fileOffset) ||
+            fileOffset > size || regionSize > size - fileOffset) {
+            Clear();
+            return false;
+        }
+
+        region.base = static_cast<uintptr_t>(base);
+        region.size = static_cast<size_t>(regionSize);
+        region.data = data + fileOffset;
+        AddRegion(region);
+    }
+
+    Finalize();
+    return true;
+}
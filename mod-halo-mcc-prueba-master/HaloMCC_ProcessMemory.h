@@ -0,0 +1,84 @@
+// HaloMCC_ProcessMemory.h
+// Vista de la memoria de un proceso para los scanners que no trabajan sobre un solo módulo
+// (punteros, búsquedas de valores): regiones + módulos cargados. Puede ser el proceso vivo
+// (lectura por callback, bajo SEH en el DLL) o un volcado mapeado en memoria (herramientas).
+// Sin windows.h.
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+enum ProcessRegionFlags : uint32_t {
+    REGION_WRITABLE   = 1 << 0,
+    REGION_EXECUTABLE = 1 << 1,
+    REGION_IMAGE      = 1 << 2      // parte de un módulo (MEM_IMAGE)
+};
+
+struct ProcessRegion {
+    uintptr_t base = 0;
+    size_t size = 0;
+    uint32_t protect = 0;           // PAGE_* tal cual
+    uint32_t flags = 0;             // ProcessRegionFlags
+    const uint8_t* data = nullptr;  // volcado: datos de la región; proceso vivo: nullptr (se usa el callback)
+};
+
+struct ProcessModule {
+    std::string name;               // en minúsculas, sin ruta
+    uintptr_t base = 0;
+    size_t size = 0;
+    // Identidad del módulo (misma que OffsetCacheKey) para poder guardar perfiles desde un volcado
+    uint32_t timeDateStamp = 0;
+    uint32_t sizeOfImage = 0;
+    uint32_t checkSum = 0;
+};
+
+// Copia [address, address + size) en buffer; false si no se puede leer entero
+typedef bool (*ProcessReadFunction)(void* context, uintptr_t address, void* buffer, size_t size);
+
+class ProcessMemory {
+public:
+    static const uint32_t DumpMagic = 0x44434D48;      // "HMCD"
+    static const uint32_t DumpVersion = 1;
+    // Los datos de cada región empiezan alineados a página en el fichero (mapeo directo)
+    static const size_t DumpAlignment = 0x1000;
+
+    void Clear();
+    void AddRegion(const ProcessRegion& region);
+    void AddModule(const ProcessModule& module);
+    // Ordena regiones y módulos por dirección; obligatorio antes de Find*/Read
+    void Finalize();
+
+    // Lectura de las regiones sin 'data' (proceso vivo)
+    void SetReader(ProcessReadFunction function, void* context);
+
+    const std::vector<ProcessRegion>& GetRegions() const { return regions; }
+    const std::vector<ProcessModule>& GetModules() const { return modules; }
+    size_t GetTotalSize() const;
+
+    const ProcessRegion* FindRegion(uintptr_t address) const;
+    const ProcessModule* FindModule(uintptr_t address) const;
+    const ProcessModule* FindModuleByName(const char* name) const;     // sin distinguir mayúsculas
+
+    // Puede cruzar regiones contiguas. false si algún byte cae fuera o no se puede leer
+    bool Read(uintptr_t address, void* buffer, size_t size) const;
+    bool ReadPointer(uintptr_t address, uint64_t& value) const;
+    // Puntero directo a [address, address + size) si cae en regiones con datos que van seguidos
+    // en el volcado (la imagen de un módulo suele ir así); nullptr si hay huecos o no hay datos
+    const uint8_t* GetData(uintptr_t address, size_t size) const;
+
+    // Volcado propio: cabecera + tablas + datos de cada región. Las regiones que no se puedan
+    // leer al escribir quedan a cero. Los datos van de la memoria al fichero por bloques (nunca
+    // hay una copia entera en RAM); si 'stop' se pone a true entre bloques se corta, se borra
+    // el temporal y devuelve false
+    bool SaveDump(const std::string& path, const std::atomic<bool>* stop = nullptr) const;
+    // Sobre un fichero ya mapeado: las regiones apuntan dentro de 'data', que debe seguir vivo
+    bool OpenDump(const uint8_t* data, size_t size);
+
+private:
+    std::vector<ProcessRegion> regions;
+    std::vector<ProcessModule> modules;
+    ProcessReadFunction read = nullptr;
+    void* readContext = nullptr;
+};
@@ -0,0 +1,274 @@
+// HaloMCC_RegionIndex.cpp
+#include "HaloMCC_RegionIndex.h"
+
+namespace {
+
+// PAGE_* de winnt.h
+const uint32_t PageNoAccess = 0x01;
+const uint32_t PageGuard = 0x100;
+const uint32_t PageReadable = 0x02 | 0x04 | 0x08 | 0x20 | 0x40 | 0x80;
+const uint32_t PageWritable = 0x04 | 0x08 | 0x40 | 0x80;
+const uint32_t PageExecutable = 0x10 | 0x20 | 0x40 | 0x80;
+
+bool SameRegion(const AddressRegion& a, const AddressRegion& b) {
+    return a.base == b.base && a.size == b.size && a.allocationBase == b.allocationBase &&
+        a.state == b.state && a.protect == b.protect && a.type == b.type;
+}
+
+// Las libres no forman asignaciones: cada una va sola
+bool SameAllocation(const AddressRegion& a, const AddressRegion& b) {
+    return a.state != REGION_STATE_FREE && b.state != REGION_STATE_FREE && a.allocationBase == b.allocationBase;
+}
+
+} // namespace
+
+bool AddressRegion::IsReadable() const {
+    return IsCommitted() && (protect & PageReadable) && !(protect & (PageGuard | PageNoAccess));
+}
+
+bool AddressRegion::IsWritable() const {
+    return IsReadable() && (protect & PageWritable);
+}
+
+bool AddressRegion::IsExecutable() const {
+    return IsCommitted() && (protect & PageExecutable) && !(protect & (PageGuard | PageNoAccess));
+}
+
+// ============================================================================
+// RegionTable
+// ============================================================================
+
+size_t RegionTable::LowerIndex(uintptr_t address) const {
+    return std::upper_bound(regions.begin(), regions.end(), address,
+        [](uintptr_t value, const AddressRegion& region) { return value < region.End(); }) - regions.begin();
+}
+
+const AddressRegion* RegionTable::Find(uintptr_t address) const {
+    const size_t index = LowerIndex(address);
+    if (index >= regions.size() || regions[index].base > address) return nullptr;
+    return &regions[index];
+}
+
+const ProcessModule* RegionTable::FindModule(uintptr_t address) const {
+    const AddressRegion* region = Find(address);
+    if (!region || region->module < 0) return nullptr;
+    return &modules[region->module];
+}
+
+bool RegionTable::IsReadable(uintptr_t address, size_t size) const {
+    const uintptr_t end = address + size;
+    if (end < address) return false;
+
+    uintptr_t cursor = address;
+    for (size_t i = LowerIndex(address); cursor < end; ++i) {
+        if (i >= regions.size() || regions[i].base > cursor || !regions[i].IsReadable()) return false;
+        cursor = regions[i].End();
+    }
+    return true;
+}
+
+// ============================================================================
+// AddressSpaceIndex
+// ============================================================================
+
+AddressSpaceIndex& AddressSpaceIndex::GetProcessIndex() {
+    static AddressSpaceIndex index;
+    return index;
+}
+
+void AddressSpaceIndex::SetBackend(const RegionBackend& newBackend) {
+    std::lock_guard<std::mutex> lock(mutex);
+    backend = newBackend;
+}
+
+bool AddressSpaceIndex::HasBackend() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return backend.query != nullptr;
+}
+
+void AddressSpaceIndex::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::atomic_store(&table, std::shared_ptr<const RegionTable>());
+}
+
+size_t AddressSpaceIndex::Walk(uintptr_t from, uintptr_t to, std::vector<AddressRegion>& regions) const {
+    size_t queries = 0;
+    uintptr_t address = from;
+    while (address < to) {
+        AddressRegion region;
+        queries++;
+        if (!backend.query(backend.context, address, region)) break;
+
+        regions.push_back(region);
+        const uintptr_t next = region.End();
+        if (next <= address) break;
+        address = next;
+    }
+    return queries;
+}
+
+bool AddressSpaceIndex::Rebuild() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!backend.query) return false;
+
+    std::vector<AddressRegion> regions;
+    Walk(0, UINTPTR_MAX, regions);
+    if (regions.empty()) return false;
+
+    const std::shared_ptr<const RegionTable> previous = Get();
+    Publish(regions, previous.get());
+    return true;
+}
+
+size_t AddressSpaceIndex::Refresh() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!backend.query) return 0;
+
+    const std::shared_ptr<const RegionTable> previous = Get();
+    std::vector<AddressRegion> regions;
+    if (!previous || previous->regions.empty()) {
+        const size_t queries = Walk(0, UINTPTR_MAX, regions);
+        if (!regions.empty()) Publish(regions, previous.get());
+        return queries;
+    }
+
+    const std::vector<AddressRegion>& old = previous->regions;
+    regions.reserve(old.size() + 16);
+
+    size_t queries = 0;
+    uintptr_t covered = old.front().base;       // la tabla nueva cubre [old.front().base, covered)
+    for (size_t i = 0; i < old.size();) {
+        size_t j = i + 1;
+        while (j < old.size() && SameAllocation(old[i], old[j])) ++j;
+
+        const uintptr_t groupBegin = old[i].base;
+        const uintptr_t groupEnd = old[j - 1].End();
+        if (groupEnd <= covered) {
+            i = j;
+            continue;
+        }
+
+        // Si la primera y la última región siguen igual, la asignación se copia entera
+        bool unchanged = groupBegin == covered;
+        AddressRegion probe;
+        if (unchanged) {
+            queries++;
+            unchanged = backend.query(backend.context, old[i].base, probe) && SameRegion(probe, old[i]);
+        }
+        if (unchanged && j - i > 1) {
+            queries++;
+            unchanged = backend.query(backend.context, old[j - 1].base, probe) && SameRegion(probe, old[j - 1]);
+        }
+
+        if (unchanged) {
+            regions.insert(regions.end(), old.begin() + i, old.begin() + j);
+            covered = groupEnd;
+        }
+        else {
+            const size_t before = regions.size();
+            queries += Walk(covered, groupEnd, regions);
+            if (regions.size() > before) covered = regions.back().End();
+        }
+        i = j;
+    }
+
+    // Lo que haya por encima de la última región conocida
+    queries += Walk(covered, UINTPTR_MAX, regions);
+
+    // Sin cambios se sigue con la misma tabla (y la misma generación)
+    if (regions.size() != old.size() || !std::equal(regions.begin(), regions.end(), old.begin(), SameRegion)) {
+        Publish(regions, previous.get());
+    }
+    return queries;
+}
+
+size_t AddressSpaceIndex::RefreshRange(uintptr_t start, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!backend.query || !size) return 0;
+
+    const std::shared_ptr<const RegionTable> previous = Get();
+    std::vector<AddressRegion> regions;
+    if (!previous || previous->regions.empty()) {
+        const size_t queries = Walk(0, UINTPTR_MAX, regions);
+        if (!regions.empty()) Publish(regions, previous.get());
+        return queries;
+    }
+
+    std::vector<AddressRegion> walked;
+    const size_t queries = Walk(start, start + size, walked);
+    if (walked.empty()) return queries;
+
+    const std::vector<AddressRegion>& old = previous->regions;
+    const uintptr_t spanBegin = walked.front().base;
+    const uintptr_t spanEnd = walked.back().End();
+
+    // Lo normal (un módulo que ya estaba): el tramo coincide y no hay nada que publicar
+    size_t k = previous->LowerIndex(spanBegin);
+    if (k + walked.size() <= old.size() &&
+        std::equal(walked.begin(), walked.end(), old.begin() + k, SameRegion)) {
+        return queries;
+    }
+
+    regions.reserve(old.size() + walked.size());
+    regions.insert(regions.end(), old.begin(), old.begin() + k);
+    if (k < old.size() && old[k].base < spanBegin) {
+        AddressRegion head = old[k];
+        head.size = spanBegin - head.base;
+        regions.push_back(head);
+    }
+
+    regions.insert(regions.end(), walked.begin(), walked.end());
+
+    while (k < old.size() && old[k].End() <= spanEnd) ++k;
+    if (k < old.size() && old[k].base < spanEnd) {
+        AddressRegion tail = old[k];
+        tail.size = tail.End() - spanEnd;
+        tail.base = spanEnd;
+        regions.push_back(tail);
+        ++k;
+    }
+    regions.insert(regions.end(), old.begin() + k, old.end());
+
+    Publish(regions, previous.get());
+    return queries;
+}
+
+void AddressSpaceIndex::Publish(std::vector<AddressRegion>& regions, const RegionTable* previous) {
+    std::shared_ptr<RegionTable> next = std::make_shared<RegionTable>();
+
+    for (const AddressRegion& region : regions) {
+        if (region.type == REGION_TYPE_IMAGE && region.state != REGION_STATE_FREE) {
+            next->imageBases.push_back(region.allocationBase);
+        }
+    }
+    std::sort(next->imageBases.begin(), next->imageBases.end());
+    next->imageBases.erase(std::unique(next->imageBases.begin(), next->imageBases.end()), next->imageBases.end());
+
+    // La lista de módulos solo se vuelve a pedir si se cargó o descargó alguna imagen
+    if (previous && previous->imageBases == next->imageBases) {
+        next->modules = previous->modules;
+    }
+    else if (backend.modules) {
+        backend.modules(backend.context, next->modules);
+        std::sort(next->modules.begin(), next->modules.end(),
+            [](const ProcessModule& a, const ProcessModule& b) { return a.base < b.base; });
+    }
+
+    for (AddressRegion& region : regions) {
+        region.module = -1;
+        if (region.type != REGION_TYPE_IMAGE || next->modules.empty()) continue;
+
+        const auto it = std::upper_bound(next->modules.begin(), next->modules.end(), region.base,
+            [](uintptr_t address, const ProcessModule& module) { return address < module.base; });
+        if (it == next->modules.begin()) continue;
+
+        const ProcessModule& module = *(it - 1);
+        if (region.base < module.base + module.size) {
+            region.module = static_cast<int32_t>((it - 1) - next->modules.begin());
+        }
+    }
+
+    next->regions.swap(regions);
+    next->generation = ++generation;
+    std::atomic_store(&table, std::shared_ptr<const RegionTable>(std::move(next)));
+}
@@ -0,0 +1,143 @@
+// HaloMCC_RegionIndex.h
+// Índice de todo el espacio de direcciones (64 bits, sin tope) con protección, estado, tipo y
+// módulo dueño de cada región. Se construye una vez y después se refresca por partes: por
+// asignación (solo se vuelve a recorrer la que cambió) o por rango (lo que va a escanear un
+// scanner). Cada refresco publica una tabla nueva e inmutable; quien la tenga la puede seguir
+// usando desde cualquier hilo sin locks.
+// Sin windows.h: la consulta (VirtualQuery) y la lista de módulos las pone quien llama
+// (SEH_GetRegionIndex en el DLL).
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "HaloMCC_ProcessMemory.h"
+
+// MEM_* de winnt.h
+enum RegionState : uint32_t {
+    REGION_STATE_COMMIT  = 0x1000,
+    REGION_STATE_RESERVE = 0x2000,
+    REGION_STATE_FREE    = 0x10000
+};
+
+enum RegionType : uint32_t {
+    REGION_TYPE_PRIVATE = 0x20000,
+    REGION_TYPE_MAPPED  = 0x40000,
+    REGION_TYPE_IMAGE   = 0x1000000
+};
+
+// Lo mismo que MEMORY_BASIC_INFORMATION más el módulo
+struct AddressRegion {
+    uintptr_t base = 0;
+    size_t size = 0;
+    uintptr_t allocationBase = 0;
+    uint32_t allocationProtect = 0;
+    uint32_t state = 0;                 // RegionState
+    uint32_t protect = 0;               // PAGE_*
+    uint32_t type = 0;                  // RegionType
+    int32_t module = -1;                // índice en RegionTable::GetModules()
+
+    uintptr_t End() const { return base + size; }
+    bool IsCommitted() const { return state == REGION_STATE_COMMIT; }
+    bool IsReadable() const;            // comprometida, legible y sin PAGE_GUARD/PAGE_NOACCESS
+    bool IsWritable() const;
+    bool IsExecutable() const;
+};
+
+struct RegionBackend {
+    // Como VirtualQuery: la región que contiene 'address'. false = fuera del espacio de usuario
+    bool (*query)(void* context, uintptr_t address, AddressRegion& region) = nullptr;
+    // Módulos cargados; solo se pide cuando cambian las imágenes mapeadas
+    bool (*modules)(void* context, std::vector<ProcessModule>& modules) = nullptr;
+    void* context = nullptr;
+};
+
+// Foto del espacio de direcciones: regiones contiguas y ordenadas (también las libres)
+class RegionTable {
+public:
+    const std::vector<AddressRegion>& GetRegions() const { return regions; }
+    const std::vector<ProcessModule>& GetModules() const { return modules; }
+    uint64_t GetGeneration() const { return generation; }
+
+    const AddressRegion* Find(uintptr_t address) const;
+    const ProcessModule* FindModule(uintptr_t address) const;
+    // [address, address + size) entero en regiones legibles
+    bool IsReadable(uintptr_t address, size_t size) const;
+
+    // Tramos legibles seguidos dentro de [start, start + size), en orden. 'visit(runStart,
+    // runSize)' devuelve true para parar
+    template <typename Visitor>
+    void ForEachReadableRun(uintptr_t start, size_t size, Visitor visit) const;
+
+private:
+    friend class AddressSpaceIndex;
+
+    // Primera región que acaba después de 'address'
+    size_t LowerIndex(uintptr_t address) const;
+
+    std::vector<AddressRegion> regions;
+    std::vector<ProcessModule> modules;             // ordenados por base
+    std::vector<uintptr_t> imageBases;              // AllocationBase de las imágenes, para saber si cambiaron
+    uint64_t generation = 0;
+};
+
+class AddressSpaceIndex {
+public:
+    // El del proceso actual (el DLL le pone el backend); las herramientas no lo usan
+    static AddressSpaceIndex& GetProcessIndex();
+
+    void SetBackend(const RegionBackend& backend);
+    bool HasBackend() const;
+
+    // Recorrido completo. false sin backend o si no devolvió nada
+    bool Rebuild();
+    // Por asignación: se consultan la primera y la última región de cada AllocationBase y solo
+    // se vuelve a recorrer la que no coincide (más lo que haya aparecido en huecos libres). Un
+    // cambio de protección en medio de una asignación espera al próximo Rebuild/RefreshRange.
+    // Sin tabla hace un Rebuild. Devuelve las consultas hechas
+    size_t Refresh();
+    // Recorre solo [start, start + size) y lo sustituye en la tabla (no publica si no cambió)
+    size_t RefreshRange(uintptr_t start, size_t size);
+
+    // nullptr hasta el primer Rebuild/Refresh. Una carga atómica
+    std::shared_ptr<const RegionTable> Get() const { return std::atomic_load(&table); }
+    void Clear();
+
+private:
+    size_t Walk(uintptr_t from, uintptr_t to, std::vector<AddressRegion>& regions) const;
+    void Publish(std::vector<AddressRegion>& regions, const RegionTable* previous);
+
+    mutable std::mutex mutex;                       // refrescos entre sí; Get() no lo toca
+    RegionBackend backend;
+    std::shared_ptr<const RegionTable> table;
+    uint64_t generation = 0;
+};
+
+template <typename Visitor>
+void RegionTable::ForEachReadableRun(uintptr_t start, size_t size, Visitor visit) const {
+    const uintptr_t end = start + size;
+    uintptr_t runStart = 0;
+    uintptr_t runEnd = 0;
+
+    for (size_t i = LowerIndex(start); i < regions.size() && regions[i].base < end; ++i) {
+        const AddressRegion& region = regions[i];
+        if (region.IsReadable()) {
+            const uintptr_t from = std::max(region.base, start);
+            if (runEnd != from) {
+                if (runEnd > runStart && visit(runStart, runEnd - runStart)) return;
+                runStart = from;
+            }
+            runEnd = std::min(region.End(), end);
+        }
+        else if (runEnd > runStart) {
+            if (visit(runStart, runEnd - runStart)) return;
+            runStart = runEnd = 0;
+        }
+    }
+
+    if (runEnd > runStart) {
+        visit(runStart, runEnd - runStart);
+    }
+}
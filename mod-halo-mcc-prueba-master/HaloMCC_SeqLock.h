@@ -0,0 +1,85 @@
+// HaloMCC_SeqLock.h
+// Publicación de un valor pequeño (trivialmente copiable) de un escritor a muchos lectores sin
+// locks. El escritor no espera nunca; el lector copia y reintenta si el escritor estaba a
+// medias, así que nunca ve un valor mezclado de dos publicaciones. Los datos se guardan en
+// palabras atómicas para que la copia concurrente no sea una carrera de datos.
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock necesita un tipo trivialmente copiable");
+
+public:
+    static const size_t WordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    SeqLock() {
+        for (size_t i = 0; i < WordCount; ++i) data[i].store(0, std::memory_order_relaxed);
+        Store(T());
+        sequence.store(0, std::memory_order_release);
+    }
+
+    // Un solo escritor a la vez (si hay varios, que se serialicen fuera)
+    void Store(const T& value) {
+        const uint64_t current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed);
+        WriteData(value, current);
+    }
+
+    // Para cuando puede haber más de un escritor (hooks llamados desde varios hilos): si otro
+    // está publicando no se espera, se descarta este valor y devuelve false
+    bool TryStore(const T& value) {
+        uint64_t current = sequence.load(std::memory_order_relaxed);
+        if ((current & 1) ||
+            !sequence.compare_exchange_strong(current, current + 1, std::memory_order_relaxed)) {
+            return false;
+        }
+        WriteData(value, current);
+        return true;
+    }
+
+    // Copia coherente del último valor. Devuelve su número de publicación (0 = nada publicado)
+    uint64_t Load(T& value) const {
+        uint64_t words[WordCount];
+        for (unsigned spins = 0;; ++spins) {
+            const uint64_t before = sequence.load(std::memory_order_acquire);
+            if (!(before & 1)) {
+                for (size_t i = 0; i < WordCount; ++i) words[i] = data[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) {
+                    memcpy(&value, words, sizeof(T));
+                    return before / 2;
+                }
+            }
+            // El escritor tarda unas pocas stores; solo si se le quitó la CPU a mitad se cede
+            if (spins >= 64) std::this_thread::yield();
+        }
+    }
+
+    T Load() const {
+        T value;
+        Load(value);
+        return value;
+    }
+
+    uint64_t GetVersion() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    // Con la secuencia ya impar (current + 1)
+    void WriteData(const T& value, uint64_t current) {
+        uint64_t words[WordCount] = {};
+        memcpy(words, &value, sizeof(T));
+
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WordCount; ++i) data[i].store(words[i], std::memory_order_relaxed);
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    alignas(64) std::atomic<uint64_t> sequence{ 0 };
+    alignas(64) std::atomic<uint64_t> data[WordCount];
+};
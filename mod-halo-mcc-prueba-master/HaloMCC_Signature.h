@@ -0,0 +1,99 @@
+// HaloMCC_Signature.h
+// Firmas estilo IDA ("83 3D ?? ?? ?? ?? 01 0F 84") parseadas en compilación a arrays fijos
+// de bytes/máscara, con las anclas ya elegidas. Una firma mal escrita no compila:
+//
+//   constexpr auto kSplitScreenCheck = MakeSignature("83 3D ?? ?? ?? ?? 01 0F 84");
+//
+// Deben declararse constexpr con almacenamiento estático (namespace/static) para que la
+// vista que devuelven View()/Prepared() siga viva durante el escaneo.
+//
+// No llevan tabla de saltos (Horspool/BMH): los scanners no avanzan por desplazamientos,
+// buscan el ancla (el byte más raro) con SIMD o memchr y solo verifican la firma entera en
+// esos aciertos. Con firmas de 10-20 bytes llenas de wildcards el salto de Horspool sería de
+// pocos bytes; lo que se precalcula aquí son las anclas.
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "HaloMCC_PatternScanner.h"
+
+template <size_t Capacity>
+class Signature {
+public:
+    constexpr explicit Signature(const char* text) {
+        size_t i = 0;
+        while (text[i]) {
+            if (text[i] == ' ') {
+                ++i;
+                continue;
+            }
+
+            if (length >= Capacity) throw "firma demasiado larga";
+
+            // "?" o "??" = wildcard
+            if (text[i] == '?') {
+                ++i;
+                if (text[i] == '?') ++i;
+                bytes[length] = 0;
+                mask[length] = 0;
+            }
+            else {
+                const int high = HexValue(text[i]);
+                const int low = text[i + 1] ? HexValue(text[i + 1]) : -1;
+                if (high < 0 || low < 0) throw "byte hex no válido en la firma";
+                bytes[length] = static_cast<uint8_t>((high << 4) | low);
+                mask[length] = 1;
+                i += 2;
+            }
+
+            if (text[i] != ' ' && text[i] != '\0') throw "falta separador entre bytes de la firma";
+            ++length;
+        }
+
+        if (length == 0) throw "firma vacía";
+
+        const PreparedPattern prepared = PatternScanner::Prepare(PatternView{ bytes, mask, length });
+        if (!prepared.hasAnchor) throw "firma sin bytes fijos";
+        anchorIndex = prepared.anchorIndex;
+        anchor2Index = prepared.anchor2Index;
+    }
+
+    constexpr size_t Length() const { return length; }
+    constexpr uint8_t ByteAt(size_t index) const { return bytes[index]; }
+    constexpr bool IsWildcard(size_t index) const { return mask[index] == 0; }
+
+    constexpr PatternView View() const {
+        return PatternView{ bytes, mask, length };
+    }
+
+    // Anclas precalculadas: no hace falta PatternScanner::Prepare en tiempo de ejecución
+    constexpr PreparedPattern Prepared() const {
+        PreparedPattern prepared;
+        prepared.view = View();
+        prepared.anchorIndex = anchorIndex;
+        prepared.anchor2Index = anchor2Index;
+        prepared.anchorByte = bytes[anchorIndex];
+        prepared.anchor2Byte = bytes[anchor2Index];
+        prepared.hasAnchor = true;
+        return prepared;
+    }
+
+private:
+    static constexpr int HexValue(char c) {
+        return (c >= '0' && c <= '9') ? c - '0'
+             : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+             : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+             : -1;
+    }
+
+    uint8_t bytes[Capacity] = {};
+    uint8_t mask[Capacity] = {};
+    size_t length = 0;
+    size_t anchorIndex = 0;
+    size_t anchor2Index = 0;
+};
+
+// Cada byte ocupa al menos un carácter más su separador: N / 2 + 1 es siempre suficiente
+template <size_t N>
+constexpr Signature<N / 2 + 1> MakeSignature(const char (&text)[N]) {
+    return Signature<N / 2 + 1>(text);
+}
@@ -0,0 +1,412 @@
+// HaloMCC_SignatureGen.cpp
+#include "HaloMCC_SignatureGen.h"
+#include "HaloMCC_ParallelScan.h"
+#include "HaloMCC_ThreadPool.h"
+#include "HaloMCC_X86Decoder.h"
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+
+namespace {
+
+// Barrido de sitios: chunks independientes que empiezan a decodificar un poco antes para
+// resincronizarse con las instrucciones (como el barrido lineal de XrefIndex)
+const size_t SiteChunkSize = 1024 * 1024;
+const size_t ResyncBytes = 64;
+
+// IMAGE_REL_BASED_*
+const uint16_t RelocationHighLow = 3;
+const uint16_t RelocationDir64 = 10;
+
+void RunTasks(ScanThreadPool* pool, size_t count, const std::function<void(size_t)>& task) {
+    if (pool) {
+        pool->ParallelFor(count, task);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) task(i);
+}
+
+uint32_t ReadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+        (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void MaskRange(std::vector<uint8_t>& mask, size_t begin, size_t length) {
+    for (size_t i = begin; i < begin + length && i < mask.size(); ++i) mask[i] = 0;
+}
+
+// Opciones de escaneo sobre el pool compartido (si lo hay)
+ScanOptions MakeScanOptions(ScanThreadPool* pool) {
+    ScanOptions options;
+    options.pool = pool;
+    options.deterministic = pool == nullptr;
+    return options;
+}
+
+} // namespace
+
+// ============================================================================
+// GeneratedSignature
+// ============================================================================
+
+size_t GeneratedSignature::GetFixedCount() const {
+    size_t count = 0;
+    for (uint8_t value : mask) {
+        if (value) count++;
+    }
+    return count;
+}
+
+std::string GeneratedSignature::ToString() const {
+    std::string text;
+    char hex[4];
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        if (i) text.push_back(' ');
+        if (!mask[i]) {
+            text += "??";
+            continue;
+        }
+        std::snprintf(hex, sizeof(hex), "%02X", bytes[i]);
+        text += hex;
+    }
+    return text;
+}
+
+// ============================================================================
+// Imagen de origen
+// ============================================================================
+
+bool SignatureGenerator::Build(const PEImage& source) {
+    image = &source;
+    code.clear();
+    relocations.clear();
+    if (!source.IsValid()) return false;
+
+    for (const PESection& section : source.GetSections()) {
+        if (section.kind != SECTION_CODE) continue;
+
+        CodeRange range;
+        range.data = source.GetSectionData(section, range.size);
+        range.rva = section.virtualAddress;
+        if (range.data && range.size) code.push_back(range);
+    }
+
+    // Bloques IMAGE_BASE_RELOCATION: RVA de página + entradas de 16 bits (tipo << 12 | offset)
+    uint32_t directoryRva = 0, directorySize = 0;
+    const PESection* relocSection = nullptr;
+    if (source.GetDataDirectory(PEImage::DirectoryBaseRelocation, directoryRva, directorySize)) {
+        relocSection = source.FindSectionByRva(directoryRva);
+    }
+    if (relocSection) {
+        size_t sectionSize = 0;
+        const uint8_t* sectionData = source.GetSectionData(*relocSection, sectionSize);
+        const size_t start = directoryRva - relocSection->virtualAddress;
+        if (sectionData && start < sectionSize) {
+            const uint8_t* blocks = sectionData + start;
+            const size_t available = std::min<size_t>(directorySize, sectionSize - start);
+            size_t pos = 0;
+            while (available - pos >= 8) {
+                const uint32_t pageRva = ReadU32(blocks + pos);
+                const uint32_t blockSize = ReadU32(blocks + pos + 4);
+                if (blockSize < 8 || blockSize > available - pos) break;
+
+                for (size_t entry = pos + 8; entry + 2 <= pos + blockSize; entry += 2) {
+                    const uint16_t value = static_cast<uint16_t>(blocks[entry] | (blocks[entry + 1] << 8));
+                    const uint16_t type = value >> 12;
+                    Relocation relocation;
+                    relocation.rva = pageRva + (value & 0xFFF);
+                    relocation.size = type == RelocationDir64 ? 8 : (type == RelocationHighLow ? 4 : 0);
+                    if (relocation.size) relocations.push_back(relocation);
+                }
+                pos += blockSize;
+            }
+        }
+    }
+
+    std::sort(relocations.begin(), relocations.end(),
+        [](const Relocation& a, const Relocation& b) { return a.rva < b.rva; });
+    return !code.empty();
+}
+
+bool SignatureGenerator::IsRelocated(uint32_t rva) const {
+    auto it = std::upper_bound(relocations.begin(), relocations.end(), rva,
+        [](uint32_t value, const Relocation& relocation) { return value < relocation.rva; });
+    if (it == relocations.begin()) return false;
+    --it;
+    return rva - it->rva < it->size;
+}
+
+// ============================================================================
+// Sitios
+// ============================================================================
+
+void SignatureGenerator::FindSites(const std::vector<uint32_t>& targets, std::vector<XrefEntry>& sites,
+                                   ScanThreadPool* pool) const {
+    sites.clear();
+    std::vector<uint32_t> sorted(targets);
+    std::sort(sorted.begin(), sorted.end());
+
+    struct Chunk {
+        const CodeRange* range;
+        size_t offset;
+        std::vector<XrefEntry> sites;
+    };
+    std::vector<Chunk> chunks;
+    for (const CodeRange& range : code) {
+        for (size_t offset = 0; offset < range.size; offset += SiteChunkSize) chunks.push_back(Chunk{ &range, offset, {} });
+    }
+
+    RunTasks(pool, chunks.size(), [&](size_t index) {
+        Chunk& chunk = chunks[index];
+        const CodeRange& range = *chunk.range;
+        const size_t end = std::min(range.size, chunk.offset + SiteChunkSize);
+        size_t pos = chunk.offset > ResyncBytes ? chunk.offset - ResyncBytes : 0;
+
+        while (pos < end) {
+            X86Instruction instruction;
+            if (!X86Decoder::Decode(range.data + pos, range.size - pos, instruction)) {
+                pos++;
+                continue;
+            }
+
+            if (instruction.ripRelative && pos >= chunk.offset) {
+                const uint32_t siteRva = range.rva + static_cast<uint32_t>(pos);
+                const uint32_t targetRva = static_cast<uint32_t>(X86Decoder::GetRipTarget(siteRva, instruction));
+                if (std::binary_search(sorted.begin(), sorted.end(), targetRva)) {
+                    chunk.sites.push_back(XrefEntry{ siteRva, targetRva });
+                }
+            }
+            pos += instruction.length;
+        }
+    });
+
+    for (const Chunk& chunk : chunks) sites.insert(sites.end(), chunk.sites.begin(), chunk.sites.end());
+}
+
+// ============================================================================
+// Generación
+// ============================================================================
+
+const uint8_t* SignatureGenerator::GetCode(uint32_t rva, size_t& available) const {
+    for (const CodeRange& range : code) {
+        if (rva >= range.rva && rva - range.rva < range.size) {
+            available = range.size - (rva - range.rva);
+            return range.data + (rva - range.rva);
+        }
+    }
+    available = 0;
+    return nullptr;
+}
+
+bool SignatureGenerator::BuildTemplate(GeneratedSignature& signature, std::vector<size_t>& ends) const {
+    signature.bytes.clear();
+    signature.mask.clear();
+    signature.unique = false;
+    ends.clear();
+
+    size_t available = 0;
+    const uint8_t* site = GetCode(signature.siteRva, available);
+    if (!site) return false;
+
+    size_t length = 0;
+    while (length < MaxLength && length < available) {
+        X86Instruction instruction;
+        if (!X86Decoder::Decode(site + length, available - length, instruction)) break;
+        if (length + instruction.length > MaxLength) break;
+
+        // La primera instrucción es la del sitio: tiene que llevar el operando al global
+        if (length == 0) {
+            if (!instruction.ripRelative) return false;
+            const uint32_t target = static_cast<uint32_t>(X86Decoder::GetRipTarget(signature.siteRva, instruction));
+            if (signature.targetRva && target != signature.targetRva) return false;
+            signature.targetRva = target;
+        }
+
+        signature.bytes.insert(signature.bytes.end(), site + length, site + length + instruction.length);
+        signature.mask.resize(signature.bytes.size(), 1);
+        if (instruction.ripRelative) {
+            MaskRange(signature.mask, length + instruction.displacementOffset, instruction.displacementSize);
+        }
+        if (instruction.relativeBranch) {
+            MaskRange(signature.mask, length + instruction.immediateOffset, instruction.immediateSize);
+        }
+        for (size_t i = length; i < length + instruction.length; ++i) {
+            if (IsRelocated(signature.siteRva + static_cast<uint32_t>(i))) signature.mask[i] = 0;
+        }
+
+        length += instruction.length;
+        ends.push_back(length);
+    }
+
+    const PESection* targetSection = image->FindSectionByRva(signature.targetRva);
+    signature.targetSection = targetSection ? static_cast<uint32_t>(targetSection->kind) : 0;
+    return !ends.empty();
+}
+
+void SignatureGenerator::Generate(std::vector<GeneratedSignature>& signatures, ScanThreadPool* pool) const {
+    std::vector<std::vector<size_t>> ends(signatures.size());
+    RunTasks(pool, signatures.size(), [&](size_t i) {
+        if (!BuildTemplate(signatures[i], ends[i])) ends[i].clear();
+    });
+
+    // Semilla: primera instrucción, o más si no tiene bytes fijos por los que anclar. Los
+    // sitios de un mismo global suelen empezar igual ("8B 05 ?? ?? ?? ??"): las semillas
+    // iguales son un solo patrón del escáner y se comparten los matches
+    struct Seed {
+        size_t signature;
+        size_t end;                     // índice en ends de la última instrucción de la semilla
+        const uint8_t* site;
+    };
+    std::vector<Seed> seeds;
+    std::vector<std::vector<size_t>> groups;    // patrón del escáner -> semillas
+    MultiPatternScanner scanner;
+    for (size_t i = 0; i < signatures.size(); ++i) {
+        size_t end = 0;
+        size_t fixed = 0;
+        for (; end < ends[i].size(); ++end) {
+            fixed = 0;
+            for (size_t b = 0; b < ends[i][end]; ++b) fixed += signatures[i].mask[b] ? 1 : 0;
+            if (fixed >= 2) break;
+        }
+        if (end >= ends[i].size()) continue;
+
+        size_t available = 0;
+        seeds.push_back(Seed{ i, end, GetCode(signatures[i].siteRva, available) });
+
+        const PatternView view{ signatures[i].bytes.data(), signatures[i].mask.data(), ends[i][end] };
+        size_t group = 0;
+        for (; group < groups.size(); ++group) {
+            const PatternView& other = scanner.GetPattern(group).view;
+            bool same = other.length == view.length;
+            for (size_t b = 0; b < view.length && same; ++b) {
+                same = other.mask[b] == view.mask[b] && (!view.mask[b] || other.bytes[b] == view.bytes[b]);
+            }
+            if (same) break;
+        }
+        if (group == groups.size()) {
+            scanner.AddPattern(view);
+            groups.emplace_back();
+        }
+        groups[group].push_back(seeds.size() - 1);
+    }
+    if (seeds.empty()) return;
+
+    // Por chunk y semilla: instrucción más lejana hasta la que casa algún match que no es el
+    // sitio (-1 = ninguno). Los matches de un chunk se procesan y se tiran
+    struct Chunk {
+        const CodeRange* range;
+        size_t offset;
+        std::vector<int32_t> reach;
+    };
+    std::vector<Chunk> chunks;
+    for (const CodeRange& range : code) {
+        for (size_t offset = 0; offset < range.size; offset += SiteChunkSize) chunks.push_back(Chunk{ &range, offset, {} });
+    }
+
+    const size_t maxSeedLength = ParallelPatternScanner::GetMaxPatternLength(scanner);
+    RunTasks(pool, chunks.size(), [&](size_t index) {
+        Chunk& chunk = chunks[index];
+        const CodeRange& range = *chunk.range;
+        const size_t candidateEnd = std::min(SiteChunkSize, range.size - chunk.offset);
+        const size_t dataSize = std::min(candidateEnd + maxSeedLength - 1, range.size - chunk.offset);
+
+        std::vector<PatternMatches> matches(groups.size());
+        scanner.FindAll(range.data + chunk.offset, dataSize, matches, SIZE_MAX, candidateEnd);
+
+        chunk.reach.assign(seeds.size(), -1);
+        for (size_t group = 0; group < groups.size(); ++group) for (size_t j : groups[group]) {
+            const GeneratedSignature& signature = signatures[seeds[j].signature];
+            const std::vector<size_t>& signatureEnds = ends[seeds[j].signature];
+
+            for (const uint8_t* match : matches[group].candidates) {
+                if (match == seeds[j].site) continue;
+
+                const size_t available = static_cast<size_t>(range.data + range.size - match);
+                size_t k = seeds[j].end;
+                size_t from = signatureEnds[k];
+                while (k + 1 < signatureEnds.size() && signatureEnds[k + 1] <= available) {
+                    bool same = true;
+                    for (size_t b = from; b < signatureEnds[k + 1] && same; ++b) {
+                        same = !signature.mask[b] || match[b] == signature.bytes[b];
+                    }
+                    if (!same) break;
+                    from = signatureEnds[++k];
+                }
+                chunk.reach[j] = std::max(chunk.reach[j], static_cast<int32_t>(k));
+            }
+        }
+    });
+
+    for (size_t j = 0; j < seeds.size(); ++j) {
+        int32_t reach = -1;
+        for (const Chunk& chunk : chunks) reach = std::max(reach, chunk.reach[j]);
+
+        GeneratedSignature& signature = signatures[seeds[j].signature];
+        const std::vector<size_t>& signatureEnds = ends[seeds[j].signature];
+        const size_t last = reach < 0 ? seeds[j].end : static_cast<size_t>(reach) + 1;
+        if (last >= signatureEnds.size()) continue;
+
+        signature.bytes.resize(signatureEnds[last]);
+        signature.mask.resize(signatureEnds[last]);
+        signature.unique = true;
+    }
+}
+
+// ============================================================================
+// Imagen nueva
+// ============================================================================
+
+void SignatureGenerator::Locate(const PEImage& target, const std::vector<GeneratedSignature>& signatures,
+                                std::vector<LocatedSignature>& located, ScanThreadPool* pool) {
+    located.assign(signatures.size(), LocatedSignature());
+
+    std::vector<CodeRange> ranges;
+    for (const PESection& section : target.GetSections()) {
+        if (section.kind != SECTION_CODE) continue;
+
+        CodeRange range;
+        range.data = target.GetSectionData(section, range.size);
+        range.rva = section.virtualAddress;
+        if (range.data && range.size) ranges.push_back(range);
+    }
+
+    MultiPatternScanner scanner;
+    std::vector<size_t> ids;
+    for (size_t i = 0; i < signatures.size(); ++i) {
+        if (!signatures[i].unique) continue;
+        scanner.AddPattern(signatures[i].View());
+        ids.push_back(i);
+    }
+    if (ids.empty()) return;
+
+    // Basta con saber si hay uno o más
+    std::vector<PatternMatches> matches;
+    const ScanOptions options = MakeScanOptions(pool);
+    for (const CodeRange& range : ranges) {
+        ParallelPatternScanner::FindAll(range.data, range.size, scanner, options, matches, 2);
+    }
+
+    for (size_t j = 0; j < ids.size(); ++j) {
+        const GeneratedSignature& signature = signatures[ids[j]];
+        LocatedSignature& result = located[ids[j]];
+        result.matchCount = static_cast<uint32_t>(matches[j].count);
+        if (matches[j].count != 1) continue;
+
+        const uint8_t* site = matches[j].candidates[0];
+        for (const CodeRange& range : ranges) {
+            if (site < range.data || site >= range.data + range.size) continue;
+
+            result.siteRva = range.rva + static_cast<uint32_t>(site - range.data);
+            uint64_t targetRva = 0;
+            if (!X86Decoder::ResolveRipOperand(site, static_cast<size_t>(range.data + range.size - site),
+                                               signature.bytes.size(), result.siteRva, 0, targetRva)) {
+                break;
+            }
+
+            const PESection* section = target.FindSectionByRva(static_cast<uint32_t>(targetRva));
+            result.targetRva = static_cast<uint32_t>(targetRva);
+            result.resolved = section && (!signature.targetSection || section->kind == signature.targetSection);
+            break;
+        }
+    }
+}
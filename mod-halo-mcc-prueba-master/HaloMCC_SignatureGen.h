@@ -0,0 +1,87 @@
+// HaloMCC_SignatureGen.h
+// Generación automática de firmas para sitios conocidos (instrucciones que tocan un global) y
+// búsqueda de esas firmas en otra versión del módulo. Con esto tools/halo_sig_migrate pasa un
+// perfil de offsets de una versión de MCC a la siguiente sin rehacer a mano las firmas de
+// HaloMCC_OffsetProfile.
+// Sin windows.h: solo lo usan las herramientas.
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "HaloMCC_PatternScanner.h"
+#include "HaloMCC_PEImage.h"
+#include "HaloMCC_XrefIndex.h"
+
+class ScanThreadPool;
+
+// Firma de un sitio. Empieza en la instrucción del sitio, así que el operando a resolver es
+// siempre el primero (operandIndex 0 en OffsetSignature)
+struct GeneratedSignature {
+    uint32_t field = 0;                 // OffsetField
+    uint32_t siteRva = 0;               // instrucción con el [rip + disp32] al global
+    uint32_t targetRva = 0;             // 0 = el del operando del sitio
+    uint32_t targetSection = 0;         // SectionKind del global (lo rellena Generate)
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> mask;          // mask[i] != 0 => byte significativo
+    bool unique = false;                // false = se repite aun con MaxLength bytes
+
+    PatternView View() const { return PatternView{ bytes.data(), mask.data(), bytes.size() }; }
+    size_t GetFixedCount() const;
+    // Estilo IDA: "48 8B 05 ?? ?? ?? ?? 85 C0"
+    std::string ToString() const;
+};
+
+// Una firma buscada en otra imagen
+struct LocatedSignature {
+    uint32_t matchCount = 0;
+    bool resolved = false;              // un solo match y su destino cae en la misma clase de sección
+    uint32_t siteRva = 0;
+    uint32_t targetRva = 0;
+};
+
+class SignatureGenerator {
+public:
+    static const size_t MaxLength = 64;
+
+    // Secciones de código y relocaciones de la imagen, que debe seguir viva
+    bool Build(const PEImage& image);
+
+    // Sitios con un operando [rip + disp32] a alguno de 'targets' (mismo barrido lineal que
+    // XrefIndex, por chunks en paralelo). En orden de RVA
+    void FindSites(const std::vector<uint32_t>& targets, std::vector<XrefEntry>& sites,
+                   ScanThreadPool* pool = nullptr) const;
+
+    // Firma más corta, en instrucciones enteras, que solo casa en su sitio. Comodines en los
+    // disp32 RIP-relative, en los desplazamientos de call/jmp/jcc y en los bytes con
+    // relocación. Todas a la vez y en una sola pasada multi-patrón por chunks: la semilla es
+    // la primera instrucción de cada sitio y de cada match ajeno solo se apunta hasta qué
+    // instrucción sigue casando; la firma acaba una instrucción después del más largo
+    void Generate(std::vector<GeneratedSignature>& signatures, ScanThreadPool* pool = nullptr) const;
+
+    // Busca las firmas únicas en otra imagen (una pasada para todas) y resuelve su operando.
+    // located[i] corresponde a signatures[i]
+    static void Locate(const PEImage& image, const std::vector<GeneratedSignature>& signatures,
+                       std::vector<LocatedSignature>& located, ScanThreadPool* pool = nullptr);
+
+private:
+    struct CodeRange {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        uint32_t rva = 0;
+    };
+
+    struct Relocation {
+        uint32_t rva = 0;
+        uint32_t size = 0;
+    };
+
+    // Bytes del sitio hasta MaxLength con los comodines puestos y dónde acaba cada instrucción
+    bool BuildTemplate(GeneratedSignature& signature, std::vector<size_t>& ends) const;
+    const uint8_t* GetCode(uint32_t rva, size_t& available) const;
+    bool IsRelocated(uint32_t rva) const;
+
+    const PEImage* image = nullptr;
+    std::vector<CodeRange> code;
+    std::vector<Relocation> relocations;    // ordenadas por RVA
+};
@@ -0,0 +1,116 @@
+// HaloMCC_StringIndex.cpp
+#include "HaloMCC_StringIndex.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool IsPrintable(uint8_t value) {
+    return (value >= 0x20 && value <= 0x7E) || value == '\t' || value == '\n' || value == '\r';
+}
+
+} // namespace
+
+// ============================================================================
+// Construcción
+// ============================================================================
+
+void StringIndex::Clear() {
+    text.clear();
+    entries.clear();
+    finalized = false;
+}
+
+void StringIndex::AddEntry(uint32_t rva, const char* begin, size_t length) {
+    Entry entry;
+    entry.rva = rva;
+    entry.textOffset = static_cast<uint32_t>(text.size());
+    entry.length = static_cast<uint32_t>(length);
+    text.append(begin, length);
+    entries.push_back(entry);
+}
+
+void StringIndex::AddData(const uint8_t* data, size_t size, uint32_t rva) {
+    finalized = false;
+
+    // ASCII: tramo imprimible terminado en cero
+    size_t start = 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (IsPrintable(data[i])) continue;
+
+        if (data[i] == 0 && i - start >= MinLength) {
+            AddEntry(rva + static_cast<uint32_t>(start), reinterpret_cast<const char*>(data + start), i - start);
+        }
+        start = i + 1;
+    }
+
+    // UTF-16LE: solo el rango ASCII, que es lo que usan las cadenas de depuración
+    std::string converted;
+    const size_t first = (rva & 1) ? 1 : 0;
+    size_t wideStart = first;
+    for (size_t i = first; i + 1 < size; i += 2) {
+        if (data[i + 1] == 0 && IsPrintable(data[i])) {
+            converted.push_back(static_cast<char>(data[i]));
+            continue;
+        }
+
+        if (data[i] == 0 && data[i + 1] == 0 && converted.size() >= MinLength) {
+            AddEntry(rva + static_cast<uint32_t>(wideStart), converted.data(), converted.size());
+        }
+        converted.clear();
+        wideStart = i + 2;
+    }
+}
+
+void StringIndex::Finalize() {
+    std::sort(entries.begin(), entries.end(), [this](const Entry& a, const Entry& b) {
+        const int order = Compare(a, text.data() + b.textOffset, b.length);
+        return order != 0 ? order < 0 : a.rva < b.rva;
+    });
+    finalized = true;
+}
+
+bool StringIndex::Build(const PEImage& image) {
+    Clear();
+    if (!image.IsValid()) return false;
+
+    for (const PESection& section : image.GetSections()) {
+        if (!(section.kind & SECTION_RDATA)) continue;
+
+        size_t size = 0;
+        const uint8_t* data = image.GetSectionData(section, size);
+        if (!data || size == 0) continue;
+
+        AddData(data, size, section.virtualAddress);
+    }
+
+    Finalize();
+    return true;
+}
+
+// ============================================================================
+// Consultas
+// ============================================================================
+
+int StringIndex::Compare(const Entry& entry, const char* other, size_t otherLength) const {
+    const size_t common = entry.length < otherLength ? entry.length : otherLength;
+    const int order = common ? std::memcmp(text.data() + entry.textOffset, other, common) : 0;
+    if (order != 0) return order;
+    if (entry.length == otherLength) return 0;
+    return entry.length < otherLength ? -1 : 1;
+}
+
+void StringIndex::Find(const char* value, std::vector<uint32_t>& rvas) const {
+    rvas.clear();
+    if (!finalized || !value) return;
+
+    const size_t length = std::strlen(value);
+    auto it = std::lower_bound(entries.begin(), entries.end(), value, [&](const Entry& entry, const char* key) {
+        return Compare(entry, key, length) < 0;
+    });
+
+    for (; it != entries.end() && Compare(*it, value, length) == 0; ++it) {
+        rvas.push_back(it->rva);
+    }
+    std::sort(rvas.begin(), rvas.end());
+}
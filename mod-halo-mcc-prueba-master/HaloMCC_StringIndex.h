@@ -0,0 +1,46 @@
+// HaloMCC_StringIndex.h
+// Índice de las cadenas ASCII y UTF-16LE de las secciones de solo lectura (.rdata). Sirve
+// para anclar firmas en las cadenas de depuración que usan las funciones del juego.
+// Sin windows.h: lo usan el DLL y las herramientas de tools/.
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "HaloMCC_PEImage.h"
+
+class StringIndex {
+public:
+    static const size_t MinLength = 5;      // caracteres; lo más corto suele ser ruido
+
+    void Clear();
+
+    // Recorre [data, data + size), que empieza en 'rva', y añade cada cadena terminada en
+    // cero de al menos MinLength caracteres imprimibles (ASCII o UTF-16LE alineada a 2)
+    void AddData(const uint8_t* data, size_t size, uint32_t rva);
+    // Ordena por texto; tras el último AddData y antes de consultar
+    void Finalize();
+
+    // Secciones .rdata de una imagen que está entera en el buffer
+    bool Build(const PEImage& image);
+
+    bool IsReady() const { return finalized; }
+    size_t GetCount() const { return entries.size(); }
+
+    // RVAs de todas las copias exactas de 'value' (en ASCII o en UTF-16), en orden de RVA
+    void Find(const char* value, std::vector<uint32_t>& rvas) const;
+
+private:
+    struct Entry {
+        uint32_t rva = 0;
+        uint32_t textOffset = 0;    // en 'text' (las UTF-16 se guardan ya en ASCII)
+        uint32_t length = 0;
+    };
+
+    void AddEntry(uint32_t rva, const char* begin, size_t length);
+    int Compare(const Entry& entry, const char* other, size_t otherLength) const;
+
+    std::string text;               // todas las cadenas seguidas, sin terminador
+    std::vector<Entry> entries;     // ordenadas por texto tras Finalize
+    bool finalized = false;
+};
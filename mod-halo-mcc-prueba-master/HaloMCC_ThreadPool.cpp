@@ -0,0 +1,124 @@
+// HaloMCC_ThreadPool.cpp
+#include "HaloMCC_ThreadPool.h"
+
+ScanThreadPool::ScanThreadPool(unsigned requestedWorkers)
+    : workerCount(requestedWorkers ? requestedWorkers : DefaultWorkerCount()) {
+    for (unsigned i = 0; i < workerCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    // El worker 0 es el hilo que llama a ParallelFor
+    for (unsigned i = 1; i < workerCount; ++i) {
+        threads.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+ScanThreadPool::~ScanThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    for (auto& thread : threads) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+unsigned ScanThreadPool::DefaultWorkerCount() {
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware ? hardware : 1;
+}
+
+void ScanThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+
+    std::lock_guard<std::mutex> batchLock(batchMutex);
+
+    if (workerCount == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    // Reparto en bloques contiguos: cada worker avanza en orden ascendente por su bloque
+    pending.store(count);
+    const size_t perWorker = (count + workerCount - 1) / workerCount;
+    for (unsigned w = 0; w < workerCount; ++w) {
+        const size_t first = w * perWorker;
+        const size_t last = first + perWorker < count ? first + perWorker : count;
+
+        std::lock_guard<std::mutex> lock(queues[w]->mutex);
+        for (size_t i = first; i < last; ++i) {
+            queues[w]->items.push_back(WorkItem{ &task, i });
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        ++generation;
+    }
+    workAvailable.notify_all();
+
+    Drain(0);
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    workDone.wait(lock, [this]() { return pending.load() == 0; });
+}
+
+void ScanThreadPool::WorkerLoop(unsigned index) {
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            workAvailable.wait(lock, [&]() { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        Drain(index);
+    }
+}
+
+void ScanThreadPool::Drain(unsigned index) {
+    WorkItem item;
+    while (TryPop(index, item) || TrySteal(index, item)) {
+        try {
+            (*item.task)(item.index);
+        }
+        catch (...) {
+            // Una tarea fallida no debe dejar el lote colgado
+        }
+
+        if (pending.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            workDone.notify_all();
+        }
+    }
+}
+
+bool ScanThreadPool::TryPop(unsigned index, WorkItem& item) {
+    WorkerQueue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.items.empty()) return false;
+
+    item = queue.items.front();
+    queue.items.pop_front();
+    return true;
+}
+
+bool ScanThreadPool::TrySteal(unsigned thief, WorkItem& item) {
+    for (unsigned offset = 1; offset < workerCount; ++offset) {
+        WorkerQueue& victim = *queues[(thief + offset) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.items.empty()) continue;
+
+        // Se roba del final: lo más alejado de lo que el dueño va a procesar a continuación
+        item = victim.items.back();
+        victim.items.pop_back();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,61 @@
+// HaloMCC_ThreadPool.h
+// Pool de workers con work-stealing para los escaneos pesados (patrones, snapshots...).
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ScanThreadPool {
+public:
+    // workerCount == 0 => hardware_concurrency. Con 1 no se crean hilos: todo se ejecuta
+    // en el hilo llamador y en orden (modo determinista para tests).
+    explicit ScanThreadPool(unsigned workerCount = 0);
+    ~ScanThreadPool();
+
+    ScanThreadPool(const ScanThreadPool&) = delete;
+    ScanThreadPool& operator=(const ScanThreadPool&) = delete;
+
+    unsigned GetWorkerCount() const { return workerCount; }
+
+    // Ejecuta task(i) para i en [0, count) y espera a que terminen todas. Cada worker
+    // recibe un bloque contiguo de índices y, al vaciarlo, roba del final de los demás.
+    // El hilo llamador participa como worker 0.
+    void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+    static unsigned DefaultWorkerCount();
+
+private:
+    struct WorkItem {
+        const std::function<void(size_t)>* task;
+        size_t index;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<WorkItem> items;
+    };
+
+    void WorkerLoop(unsigned index);
+    void Drain(unsigned index);
+    bool TryPop(unsigned index, WorkItem& item);
+    bool TrySteal(unsigned thief, WorkItem& item);
+
+    unsigned workerCount;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex batchMutex;          // ParallelFor no es reentrante entre hilos
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workDone;
+    std::atomic<size_t> pending{ 0 };
+    uint64_t generation = 0;
+    bool stopping = false;
+};
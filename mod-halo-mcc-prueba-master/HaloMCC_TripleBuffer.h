@@ -0,0 +1,57 @@
+// HaloMCC_TripleBuffer.h
+// Triple buffer de un escritor a un lector, sin esperas en ningún lado: el escritor rellena su
+// buffer y lo intercambia por el del medio; el lector, si el del medio es nuevo, lo intercambia
+// por el suyo. Ninguno toca nunca el buffer del otro, así que el lector siempre ve una
+// publicación entera (la última) y nunca reintenta. Cada buffer ocupa sus propias líneas de
+// caché para que escritor y lector no se pisen.
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), back(0), front(2) {}
+
+    // --- Escritor (un solo hilo) ---
+    T& GetWriteBuffer() { return slots[back].value; }
+
+    void Publish() {
+        const uint8_t previous = middle.exchange(static_cast<uint8_t>(back | FreshBit), std::memory_order_acq_rel);
+        back = previous & IndexMask;
+    }
+
+    void Write(const T& value) {
+        GetWriteBuffer() = value;
+        Publish();
+    }
+
+    // --- Lector (un solo hilo) ---
+    // Coge la última publicación si hay una nueva. true si cambió
+    bool Update() {
+        if (!(middle.load(std::memory_order_relaxed) & FreshBit)) return false;
+
+        const uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & IndexMask;
+        return true;
+    }
+
+    // Válido hasta el siguiente Read/Update del lector
+    const T& Read() {
+        Update();
+        return slots[front].value;
+    }
+
+private:
+    static const uint8_t IndexMask = 0x3;
+    static const uint8_t FreshBit = 0x4;
+
+    struct alignas(64) Slot {
+        T value{};
+    };
+
+    Slot slots[3];
+    alignas(64) std::atomic<uint8_t> middle;    // índice del buffer del medio | FreshBit
+    alignas(64) uint8_t back;                   // solo el escritor
+    alignas(64) uint8_t front;                  // solo el lector
+};
@@ -0,0 +1,294 @@
+// HaloMCC_X86Decoder.cpp
+#include "HaloMCC_X86Decoder.h"
+
+// ============================================================================
+// Tablas de opcodes
+// ============================================================================
+
+namespace {
+
+bool IsLegacyPrefix(uint8_t value) {
+    switch (value) {
+    case 0x66: case 0x67:
+    case 0xF0: case 0xF2: case 0xF3:
+    case 0x2E: case 0x36: case 0x3E: case 0x26: case 0x64: case 0x65:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Opcodes de un byte que no existen en modo 64 bits
+bool IsInvalidOneByte(uint8_t op) {
+    switch (op) {
+    case 0x06: case 0x07: case 0x0E: case 0x16: case 0x17: case 0x1E: case 0x1F:
+    case 0x27: case 0x2F: case 0x37: case 0x3F:
+    case 0x60: case 0x61: case 0x82: case 0x9A:
+    case 0xCE: case 0xD4: case 0xD5: case 0xD6: case 0xEA:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool OneByteHasModRM(uint8_t op) {
+    if (op < 0x40) return (op & 0x07) < 4;
+    switch (op) {
+    case 0x63: case 0x69: case 0x6B:
+    case 0xC0: case 0xC1: case 0xC6: case 0xC7:
+    case 0xD0: case 0xD1: case 0xD2: case 0xD3:
+    case 0xF6: case 0xF7: case 0xFE: case 0xFF:
+        return true;
+    default:
+        return (op >= 0x80 && op <= 0x8F) || (op >= 0xD8 && op <= 0xDF);
+    }
+}
+
+// z = 2 con prefijo 66, si no 4
+size_t OneByteImmediateSize(uint8_t op, uint8_t modrm, bool operandSize16, bool addressSize32, bool rexW) {
+    const size_t z = operandSize16 ? 2 : 4;
+    const uint8_t reg = (modrm >> 3) & 0x07;
+
+    if (op < 0x40) {
+        if ((op & 0x07) == 4) return 1;
+        if ((op & 0x07) == 5) return z;
+        return 0;
+    }
+    if (op >= 0x70 && op <= 0x7F) return 1;
+    if (op >= 0xB0 && op <= 0xB7) return 1;
+    if (op >= 0xB8 && op <= 0xBF) return rexW ? 8 : z;
+    if (op >= 0xA0 && op <= 0xA3) return addressSize32 ? 4 : 8;
+    if (op >= 0xE0 && op <= 0xE7) return 1;
+
+    switch (op) {
+    case 0x68: case 0x69: case 0x81: case 0xA9: case 0xC7:
+        return z;
+    case 0x6A: case 0x6B: case 0x80: case 0x83: case 0xA8:
+    case 0xC0: case 0xC1: case 0xC6: case 0xCD: case 0xEB:
+        return 1;
+    case 0xC2: case 0xCA:
+        return 2;
+    case 0xC8:
+        return 3;
+    case 0xE8: case 0xE9:
+        return 4;
+    case 0xF6:
+        return reg < 2 ? 1 : 0;
+    case 0xF7:
+        return reg < 2 ? z : 0;
+    default:
+        return 0;
+    }
+}
+
+bool OneByteIsRelativeBranch(uint8_t op) {
+    return (op >= 0x70 && op <= 0x7F) || (op >= 0xE0 && op <= 0xE3) || op == 0xE8 || op == 0xE9 || op == 0xEB;
+}
+
+bool TwoByteHasModRM(uint8_t op) {
+    if (op >= 0x30 && op <= 0x37) return false;
+    if (op >= 0x80 && op <= 0x8F) return false;
+    if (op >= 0xC8 && op <= 0xCF) return false;
+    switch (op) {
+    case 0x05: case 0x06: case 0x07: case 0x08: case 0x09: case 0x0B: case 0x0E:
+    case 0x77: case 0xA0: case 0xA1: case 0xA2: case 0xA8: case 0xA9: case 0xAA:
+        return false;
+    default:
+        return true;
+    }
+}
+
+size_t TwoByteImmediateSize(uint8_t op) {
+    if (op >= 0x80 && op <= 0x8F) return 4;
+    if (op >= 0x70 && op <= 0x73) return 1;
+    switch (op) {
+    case 0x0F: case 0xA4: case 0xAC: case 0xBA: case 0xC2: case 0xC4: case 0xC5: case 0xC6:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+int32_t ReadSigned(const uint8_t* data, size_t size) {
+    switch (size) {
+    case 1:
+        return static_cast<int8_t>(data[0]);
+    case 2:
+        return static_cast<int16_t>(static_cast<uint16_t>(data[0] | (data[1] << 8)));
+    case 4:
+        return static_cast<int32_t>(static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+            (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24));
+    default:
+        return 0;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Decodificación
+// ============================================================================
+
+bool X86Decoder::Decode(const uint8_t* code, size_t available, X86Instruction& instruction) {
+    instruction = X86Instruction{};
+    const size_t limit = available < MaxInstructionLength ? available : MaxInstructionLength;
+
+    size_t pos = 0;
+    bool operandSize16 = false;
+    bool addressSize32 = false;
+    bool rexW = false;
+
+    while (pos < limit && IsLegacyPrefix(code[pos])) {
+        if (code[pos] == 0x66) operandSize16 = true;
+        if (code[pos] == 0x67) addressSize32 = true;
+        pos++;
+    }
+
+    // REX va justo antes del opcode
+    if (pos < limit && (code[pos] & 0xF0) == 0x40) {
+        rexW = (code[pos] & 0x08) != 0;
+        pos++;
+    }
+    if (pos >= limit) return false;
+
+    uint8_t opcode = code[pos++];
+    uint8_t map = 0;
+    bool hasModRM = false;
+    size_t immediateSize = 0;
+    bool relativeBranch = false;
+    bool needsModRMForImmediate = false;
+
+    if (opcode == 0xC4 || opcode == 0xC5 || opcode == 0x62) {
+        // VEX/EVEX: en 64 bits C4/C5/62 siempre lo son. El disp8*N de EVEX no cambia la longitud
+        const bool evex = opcode == 0x62;
+        if (evex) {
+            if (pos + 3 >= limit) return false;
+            map = code[pos] & 0x07;
+            pos += 3;
+        }
+        else if (opcode == 0xC4) {
+            if (pos + 2 >= limit) return false;
+            map = code[pos] & 0x1F;
+            pos += 2;
+        }
+        else {
+            if (pos + 1 >= limit) return false;
+            map = 1;
+            pos += 1;
+        }
+        if (map < 1 || map > (evex ? 6 : 3) || map == 4) return false;
+
+        opcode = code[pos++];
+        hasModRM = evex || !(map == 1 && opcode == 0x77);   // vzeroupper/vzeroall
+        if (map == 3) immediateSize = 1;
+        else if (map == 1) immediateSize = (opcode >= 0x70 && opcode <= 0x73) || opcode == 0xC2 ||
+                                           (opcode >= 0xC4 && opcode <= 0xC6) ? 1 : 0;
+    }
+    else if (opcode == 0x0F) {
+        if (pos >= limit) return false;
+        opcode = code[pos++];
+
+        if (opcode == 0x38 || opcode == 0x3A) {
+            map = opcode == 0x38 ? 2 : 3;
+            if (pos >= limit) return false;
+            opcode = code[pos++];
+            hasModRM = true;
+            immediateSize = map == 3 ? 1 : 0;
+        }
+        else {
+            map = 1;
+            hasModRM = TwoByteHasModRM(opcode);
+            immediateSize = TwoByteImmediateSize(opcode);
+            relativeBranch = opcode >= 0x80 && opcode <= 0x8F;
+        }
+    }
+    else {
+        if (IsInvalidOneByte(opcode)) return false;
+        hasModRM = OneByteHasModRM(opcode);
+        relativeBranch = OneByteIsRelativeBranch(opcode);
+        needsModRMForImmediate = true;
+    }
+
+    instruction.opcodeMap = map;
+    instruction.opcode = opcode;
+    instruction.hasModRM = hasModRM;
+
+    if (hasModRM) {
+        if (pos >= limit) return false;
+        const uint8_t modrm = code[pos++];
+        const uint8_t mod = modrm >> 6;
+        const uint8_t rm = modrm & 0x07;
+        instruction.modrm = modrm;
+
+        size_t displacementSize = 0;
+        if (mod != 3) {
+            if (rm == 4) {
+                if (pos >= limit) return false;
+                const uint8_t sib = code[pos++];
+                if (mod == 0 && (sib & 0x07) == 5) displacementSize = 4;
+            }
+            else if (mod == 0 && rm == 5) {
+                displacementSize = 4;
+                instruction.ripRelative = true;
+            }
+
+            if (mod == 1) displacementSize = 1;
+            else if (mod == 2) displacementSize = 4;
+        }
+
+        if (displacementSize) {
+            if (pos + displacementSize > limit) return false;
+            instruction.displacementOffset = static_cast<uint8_t>(pos);
+            instruction.displacementSize = static_cast<uint8_t>(displacementSize);
+            instruction.displacement = ReadSigned(code + pos, displacementSize);
+            pos += displacementSize;
+        }
+    }
+
+    if (needsModRMForImmediate) {
+        immediateSize = OneByteImmediateSize(opcode, instruction.modrm, operandSize16, addressSize32, rexW);
+    }
+
+    if (immediateSize) {
+        if (pos + immediateSize > limit) return false;
+        instruction.immediateOffset = static_cast<uint8_t>(pos);
+        instruction.immediateSize = static_cast<uint8_t>(immediateSize);
+        if (relativeBranch) {
+            instruction.relativeBranch = true;
+            instruction.branchDisplacement = ReadSigned(code + pos, immediateSize);
+        }
+        pos += immediateSize;
+    }
+
+    instruction.length = static_cast<uint8_t>(pos);
+    return true;
+}
+
+uint64_t X86Decoder::GetRipTarget(uint64_t address, const X86Instruction& instruction) {
+    return address + instruction.length + static_cast<int64_t>(instruction.displacement);
+}
+
+uint64_t X86Decoder::GetBranchTarget(uint64_t address, const X86Instruction& instruction) {
+    return address + instruction.length + static_cast<int64_t>(instruction.branchDisplacement);
+}
+
+bool X86Decoder::ResolveRipOperand(const uint8_t* code, size_t available, size_t span, uint64_t address,
+                                   unsigned operandIndex, uint64_t& target) {
+    size_t offset = 0;
+    unsigned seen = 0;
+
+    while (offset < span && offset < available) {
+        X86Instruction instruction;
+        if (!Decode(code + offset, available - offset, instruction)) return false;
+
+        if (instruction.ripRelative) {
+            if (seen == operandIndex) {
+                target = GetRipTarget(address + offset, instruction);
+                return true;
+            }
+            seen++;
+        }
+        offset += instruction.length;
+    }
+    return false;
+}
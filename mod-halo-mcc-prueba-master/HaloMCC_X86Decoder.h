@@ -0,0 +1,47 @@
+// HaloMCC_X86Decoder.h
+// Decodificador mínimo de longitud de instrucciones x86-64 (prefijos, REX, VEX, mapas
+// 0F/0F38/0F3A, ModRM/SIB, desplazamientos e inmediatos). No desensambla: solo lo justo
+// para saber dónde acaba cada instrucción y resolver operandos RIP-relative.
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+struct X86Instruction {
+    uint8_t length = 0;
+    uint8_t opcodeMap = 0;              // 0 = un byte, 1 = 0F, 2 = 0F38, 3 = 0F3A
+    uint8_t opcode = 0;
+    bool hasModRM = false;
+    uint8_t modrm = 0;
+
+    // [rip + disp32]
+    bool ripRelative = false;
+    uint8_t displacementOffset = 0;     // posición del disp dentro de la instrucción
+    uint8_t displacementSize = 0;
+    int32_t displacement = 0;
+
+    uint8_t immediateOffset = 0;
+    uint8_t immediateSize = 0;
+
+    // call/jmp/jcc rel8/rel32: el inmediato es relativo al final de la instrucción
+    bool relativeBranch = false;
+    int32_t branchDisplacement = 0;
+};
+
+class X86Decoder {
+public:
+    static const size_t MaxInstructionLength = 15;
+
+    // false si el opcode no es válido en 64 bits o faltan bytes
+    static bool Decode(const uint8_t* code, size_t available, X86Instruction& instruction);
+
+    // Dirección (o RVA) de destino de un operando RIP-relative / salto relativo.
+    // Se calcula respecto al final de la instrucción, con el desplazamiento con signo
+    static uint64_t GetRipTarget(uint64_t address, const X86Instruction& instruction);
+    static uint64_t GetBranchTarget(uint64_t address, const X86Instruction& instruction);
+
+    // Recorre instrucciones desde 'code' mientras empiecen antes de 'span' bytes y devuelve
+    // el destino del operando RIP-relative número 'operandIndex' (0 = el primero).
+    // available puede ser mayor que span para decodificar la última instrucción entera
+    static bool ResolveRipOperand(const uint8_t* code, size_t available, size_t span, uint64_t address,
+                                  unsigned operandIndex, uint64_t& target);
+};
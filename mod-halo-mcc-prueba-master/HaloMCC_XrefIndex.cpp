@@ -0,0 +1,249 @@
+// HaloMCC_XrefIndex.cpp
+#include "HaloMCC_XrefIndex.h"
+#include "HaloMCC_X86Decoder.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+// ============================================================================
+// Serialización (little-endian; los arrays van en bloque)
+// ============================================================================
+
+namespace {
+
+// Tope de referencias al cargar: un fichero corrupto no debe pedir gigas
+const uint32_t MaxStoredReferences = 64 * 1024 * 1024;
+
+void WriteU32(std::ofstream& out, uint32_t value) {
+    uint8_t bytes[4] = {
+        static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+        static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24)
+    };
+    out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+bool ReadU32(std::ifstream& in, uint32_t& value) {
+    uint8_t bytes[4];
+    if (!in.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) return false;
+    value = static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+        (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    return true;
+}
+
+void WriteArray(std::ofstream& out, const std::vector<uint32_t>& values) {
+    std::vector<uint8_t> bytes(values.size() * 4);
+    for (size_t i = 0; i < values.size(); ++i) {
+        bytes[i * 4 + 0] = static_cast<uint8_t>(values[i]);
+        bytes[i * 4 + 1] = static_cast<uint8_t>(values[i] >> 8);
+        bytes[i * 4 + 2] = static_cast<uint8_t>(values[i] >> 16);
+        bytes[i * 4 + 3] = static_cast<uint8_t>(values[i] >> 24);
+    }
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+bool ReadArray(std::ifstream& in, size_t count, std::vector<uint32_t>& values) {
+    std::vector<uint8_t> bytes(count * 4);
+    if (!in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) return false;
+
+    values.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = static_cast<uint32_t>(bytes[i * 4]) | (static_cast<uint32_t>(bytes[i * 4 + 1]) << 8) |
+            (static_cast<uint32_t>(bytes[i * 4 + 2]) << 16) | (static_cast<uint32_t>(bytes[i * 4 + 3]) << 24);
+    }
+    return true;
+}
+
+// (clave, valor) empaquetados en 64 bits para ordenar con un solo std::sort
+uint64_t Pack(uint32_t key, uint32_t value) {
+    return (static_cast<uint64_t>(key) << 32) | value;
+}
+
+} // namespace
+
+// ============================================================================
+// Construcción
+// ============================================================================
+
+void XrefIndex::Clear() {
+    siteRvas.clear();
+    siteTargets.clear();
+    targetRvas.clear();
+    targetSites.clear();
+    finalized = false;
+}
+
+size_t XrefIndex::AddCode(const uint8_t* code, size_t size, uint32_t rva, uint32_t imageSize) {
+    finalized = false;
+
+    size_t decoded = 0;
+    size_t pos = 0;
+    while (pos < size) {
+        X86Instruction instruction;
+        if (!X86Decoder::Decode(code + pos, size - pos, instruction)) {
+            pos++;
+            continue;
+        }
+        decoded++;
+
+        if (instruction.ripRelative) {
+            const uint32_t siteRva = rva + static_cast<uint32_t>(pos);
+            const uint32_t targetRva = static_cast<uint32_t>(X86Decoder::GetRipTarget(siteRva, instruction));
+            if (targetRva < imageSize) {
+                siteRvas.push_back(siteRva);
+                siteTargets.push_back(targetRva);
+            }
+        }
+        pos += instruction.length;
+    }
+    return decoded;
+}
+
+void XrefIndex::Finalize() {
+    std::vector<uint64_t> pairs(siteRvas.size());
+
+    // Por sitio: ya viene ordenado si las secciones se añadieron en orden de RVA
+    if (!std::is_sorted(siteRvas.begin(), siteRvas.end())) {
+        for (size_t i = 0; i < siteRvas.size(); ++i) pairs[i] = Pack(siteRvas[i], siteTargets[i]);
+        std::sort(pairs.begin(), pairs.end());
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            siteRvas[i] = static_cast<uint32_t>(pairs[i] >> 32);
+            siteTargets[i] = static_cast<uint32_t>(pairs[i]);
+        }
+    }
+
+    for (size_t i = 0; i < siteRvas.size(); ++i) pairs[i] = Pack(siteTargets[i], siteRvas[i]);
+    std::sort(pairs.begin(), pairs.end());
+
+    targetRvas.resize(pairs.size());
+    targetSites.resize(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        targetRvas[i] = static_cast<uint32_t>(pairs[i] >> 32);
+        targetSites[i] = static_cast<uint32_t>(pairs[i]);
+    }
+    finalized = true;
+}
+
+bool XrefIndex::Build(const PEImage& image) {
+    Clear();
+    if (!image.IsValid()) return false;
+
+    for (const PESection& section : image.GetSections()) {
+        if (!(section.kind & SECTION_CODE)) continue;
+
+        size_t size = 0;
+        const uint8_t* data = image.GetSectionData(section, size);
+        if (!data || size == 0) continue;
+
+        AddCode(data, size, section.virtualAddress, image.GetSizeOfImage());
+    }
+
+    Finalize();
+    return true;
+}
+
+// ============================================================================
+// Consultas
+// ============================================================================
+
+XrefSpan XrefIndex::FindReferencesTo(uint32_t targetRva) const {
+    XrefSpan span;
+    if (!finalized) return span;
+
+    const auto range = std::equal_range(targetRvas.begin(), targetRvas.end(), targetRva);
+    span.begin = targetSites.data() + (range.first - targetRvas.begin());
+    span.end = targetSites.data() + (range.second - targetRvas.begin());
+    return span;
+}
+
+void XrefIndex::FindReferencesToRange(uint32_t targetBegin, uint32_t targetEnd, std::vector<XrefEntry>& results) const {
+    results.clear();
+    if (!finalized) return;
+
+    const auto first = std::lower_bound(targetRvas.begin(), targetRvas.end(), targetBegin);
+    const auto last = std::lower_bound(first, targetRvas.end(), targetEnd);
+    for (auto it = first; it != last; ++it) {
+        XrefEntry entry;
+        entry.targetRva = *it;
+        entry.siteRva = targetSites[static_cast<size_t>(it - targetRvas.begin())];
+        results.push_back(entry);
+    }
+}
+
+void XrefIndex::FindReferencesFrom(uint32_t siteBegin, uint32_t siteEnd, std::vector<XrefEntry>& results) const {
+    results.clear();
+    if (!finalized) return;
+
+    const auto first = std::lower_bound(siteRvas.begin(), siteRvas.end(), siteBegin);
+    const auto last = std::lower_bound(first, siteRvas.end(), siteEnd);
+    for (auto it = first; it != last; ++it) {
+        XrefEntry entry;
+        entry.siteRva = *it;
+        entry.targetRva = siteTargets[static_cast<size_t>(it - siteRvas.begin())];
+        results.push_back(entry);
+    }
+}
+
+// ============================================================================
+// Fichero
+// ============================================================================
+
+bool XrefIndex::Save(const std::string& path, const OffsetCacheKey& key) const {
+    if (!finalized) return false;
+
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+
+        WriteU32(out, FileMagic);
+        WriteU32(out, FileVersion);
+        WriteU32(out, key.timeDateStamp);
+        WriteU32(out, key.sizeOfImage);
+        WriteU32(out, key.checkSum);
+        WriteU32(out, key.gameVersion);
+        WriteU32(out, key.gamePlatform);
+        WriteU32(out, static_cast<uint32_t>(siteRvas.size()));
+
+        WriteArray(out, siteRvas);
+        WriteArray(out, siteTargets);
+        WriteArray(out, targetRvas);
+        WriteArray(out, targetSites);
+
+        if (!out.good()) return false;
+    }
+
+    std::remove(path.c_str());
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+bool XrefIndex::Load(const std::string& path, const OffsetCacheKey& key) {
+    Clear();
+
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in.is_open()) return false;
+
+    uint32_t magic = 0, version = 0, count = 0;
+    OffsetCacheKey stored;
+    if (!ReadU32(in, magic) || magic != FileMagic) return false;
+    if (!ReadU32(in, version) || version != FileVersion) return false;
+    if (!ReadU32(in, stored.timeDateStamp) || !ReadU32(in, stored.sizeOfImage) || !ReadU32(in, stored.checkSum) ||
+        !ReadU32(in, stored.gameVersion) || !ReadU32(in, stored.gamePlatform) || stored != key) {
+        return false;
+    }
+    if (!ReadU32(in, count) || count > MaxStoredReferences) return false;
+
+    if (!ReadArray(in, count, siteRvas) || !ReadArray(in, count, siteTargets) ||
+        !ReadArray(in, count, targetRvas) || !ReadArray(in, count, targetSites)) {
+        Clear();
+        return false;
+    }
+
+    // Las búsquedas binarias dependen del orden: un fichero desordenado no se usa
+    if (!std::is_sorted(siteRvas.begin(), siteRvas.end()) || !std::is_sorted(targetRvas.begin(), targetRvas.end())) {
+        Clear();
+        return false;
+    }
+
+    finalized = true;
+    return true;
+}
@@ -0,0 +1,66 @@
+// HaloMCC_XrefIndex.h
+// Índice de referencias cruzadas: todos los operandos [rip + disp32] del código del módulo,
+// sacados en una pasada del decodificador. Responde "¿qué instrucciones tocan el global X?"
+// y "¿qué globales toca el código cerca de Y?" con búsquedas binarias, sin re-escanear.
+// Sin windows.h: lo usan el DLL y las herramientas de tools/.
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "HaloMCC_PEImage.h"
+#include "HaloMCC_OffsetCache.h"
+
+struct XrefEntry {
+    uint32_t siteRva = 0;       // instrucción con el operando RIP-relative
+    uint32_t targetRva = 0;     // dirección a la que apunta
+};
+
+// Sitios de una misma dirección de destino (vista al índice, ordenados)
+struct XrefSpan {
+    const uint32_t* begin = nullptr;
+    const uint32_t* end = nullptr;
+
+    size_t Size() const { return static_cast<size_t>(end - begin); }
+    bool Empty() const { return begin == end; }
+};
+
+class XrefIndex {
+public:
+    static const uint32_t FileMagic = 0x58524D48;     // "HMRX"
+    static const uint32_t FileVersion = 1;
+
+    void Clear();
+
+    // Barrido lineal de [code, code + size), que empieza en 'rva'. Cada operando RIP-relative
+    // con destino por debajo de imageSize entra en el índice; los bytes que no decodifican se
+    // saltan de uno en uno (padding, tablas de saltos). Devuelve instrucciones decodificadas
+    size_t AddCode(const uint8_t* code, size_t size, uint32_t rva, uint32_t imageSize);
+    // Ordena por destino; tras el último AddCode y antes de consultar
+    void Finalize();
+
+    // Todas las secciones de código de una imagen que está entera en el buffer
+    bool Build(const PEImage& image);
+
+    bool IsReady() const { return finalized; }
+    size_t GetCount() const { return siteRvas.size(); }
+
+    // Sitios que referencian exactamente targetRva
+    XrefSpan FindReferencesTo(uint32_t targetRva) const;
+    // Referencias con destino en [targetBegin, targetEnd), p.ej. campos de una estructura global
+    void FindReferencesToRange(uint32_t targetBegin, uint32_t targetEnd, std::vector<XrefEntry>& results) const;
+    // Referencias hechas desde instrucciones en [siteBegin, siteEnd)
+    void FindReferencesFrom(uint32_t siteBegin, uint32_t siteEnd, std::vector<XrefEntry>& results) const;
+
+    // Mismo esquema que OffsetCache: el fichero solo vale para el módulo de 'key'
+    bool Save(const std::string& path, const OffsetCacheKey& key) const;
+    bool Load(const std::string& path, const OffsetCacheKey& key);
+
+private:
+    // Arrays planos: por sitio (orden del barrido) y por destino (tras Finalize)
+    std::vector<uint32_t> siteRvas;
+    std::vector<uint32_t> siteTargets;
+    std::vector<uint32_t> targetRvas;
+    std::vector<uint32_t> targetSites;
+    bool finalized = false;
+};
@@ -1,8 +1,22 @@
 #pragma once
 #include <windows.h>
+#include <psapi.h>
 #include <cstdint>
 #include <cstddef>
+#include <cctype>
 #include <cstring>
+#include <memory>
+#include <vector>
+#include "HaloMCC_PatternScanner.h"
+#include "HaloMCC_PEImage.h"
+#include "HaloMCC_ParallelScan.h"
+#include "HaloMCC_XrefIndex.h"
+#include "HaloMCC_StringIndex.h"
+#include "HaloMCC_PageHash.h"
+#include "HaloMCC_MemorySnapshot.h"
+#include "HaloMCC_ProcessMemory.h"
+#include "HaloMCC_MemoryWriter.h"
+#include "HaloMCC_RegionIndex.h"
 
 // SEH helpers as inline functions so they can be included in multiple TUs without duplicate symbols.
 static inline bool SEH_MemReadRaw(uintptr_t address, void* out, size_t size) {
@@ -38,3 +52,405 @@ static inline bool SEH_PatternMatchRaw(uintptr_t address, const uint8_t* pattern
         return false;
     }
 }
+
+static inline const uint8_t* SEH_FindPatternRaw(const uint8_t* begin, size_t size, const PreparedPattern& pattern) {
+    __try {
+        return PatternScanner::FindFirst(begin, size, pattern);
+    }
+    __except (EXCEPTION_EXECUTE_HANDLER) {
+        return nullptr;
+    }
+}
+
+static inline bool SEH_IsReadableRegion(const MEMORY_BASIC_INFORMATION& mbi) {
+    const DWORD readable = PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY |
+        PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+    return mbi.State == MEM_COMMIT &&
+        (mbi.Protect & readable) != 0 &&
+        (mbi.Protect & (PAGE_GUARD | PAGE_NOACCESS)) == 0;
+}
+
+static inline bool SEH_FindPatternsRaw(const uint8_t* begin, size_t size, const MultiPatternScanner& scanner,
+                                       std::vector<const uint8_t*>& results, size_t& remaining) {
+    __try {
+        remaining = scanner.FindFirstAll(begin, size, results);
+        return true;
+    }
+    __except (EXCEPTION_EXECUTE_HANDLER) {
+        return false;
+    }
+}
+
+static inline bool SEH_EnumeratePatternsRaw(const uint8_t* begin, size_t size, size_t candidateEnd,
+                                            const MultiPatternScanner& scanner, std::vector<PatternMatches>& results,
+                                            size_t maxCandidates) {
+    __try {
+        scanner.FindAll(begin, size, results, maxCandidates, candidateEnd);
+        return true;
+    }
+    __except (EXCEPTION_EXECUTE_HANDLER) {
+        return false;
+    }
+}
+
+// Parsea las cabeceras PE de un módulo cargado. Primero se copian con SEH y se valida la
+// copia; solo entonces se parsea sobre la base real (el parser no sale de las cabeceras).
+static inline bool SEH_ParseLoadedImage(uintptr_t moduleBase, size_t moduleSize, PEImage& image) {
+    uint8_t probe[0x1000];
+    const size_t probeSize = moduleSize < sizeof(probe) ? moduleSize : sizeof(probe);
+    if (!SEH_MemReadRaw(moduleBase, probe, probeSize)) return false;
+
+    if (!image.Parse(probe, probeSize, PEImage::Layout::MAPPED)) return false;
+
+    return image.Parse(reinterpret_cast<const uint8_t*>(moduleBase), moduleSize, PEImage::Layout::MAPPED);
+}
+
+// ============================================================================
+// Índice de regiones del proceso (AddressSpaceIndex::GetProcessIndex)
+// ============================================================================
+
+static inline bool SEH_QueryRegion(void*, uintptr_t address, AddressRegion& region) {
+    MEMORY_BASIC_INFORMATION mbi = {};
+    if (VirtualQuery(reinterpret_cast<LPCVOID>(address), &mbi, sizeof(mbi)) != sizeof(mbi)) return false;
+
+    region.base = reinterpret_cast<uintptr_t>(mbi.BaseAddress);
+    region.size = mbi.RegionSize;
+    region.allocationBase = reinterpret_cast<uintptr_t>(mbi.AllocationBase);
+    region.allocationProtect = mbi.AllocationProtect;
+    region.state = mbi.State;
+    region.protect = mbi.Protect;
+    region.type = mbi.Type;
+    return true;
+}
+
+// Módulos cargados con su identidad (la misma que OffsetCacheKey)
+static inline bool SEH_EnumerateModules(void*, std::vector<ProcessModule>& modules) {
+    modules.clear();
+
+    HANDLE process = GetCurrentProcess();
+    std::vector<HMODULE> handles(512);
+    DWORD needed = 0;
+    if (!EnumProcessModules(process, handles.data(), static_cast<DWORD>(handles.size() * sizeof(HMODULE)), &needed)) {
+        return false;
+    }
+    handles.resize(std::min<size_t>(handles.size(), needed / sizeof(HMODULE)));
+
+    for (HMODULE handle : handles) {
+        char name[MAX_PATH] = {};
+        MODULEINFO info = {};
+        if (!GetModuleBaseNameA(process, handle, name, MAX_PATH) ||
+            !GetModuleInformation(process, handle, &info, sizeof(info))) {
+            continue;
+        }
+
+        ProcessModule module;
+        for (const char* c = name; *c; ++c) module.name.push_back(static_cast<char>(tolower(static_cast<unsigned char>(*c))));
+        module.base = reinterpret_cast<uintptr_t>(info.lpBaseOfDll);
+        module.size = info.SizeOfImage;
+
+        PEImage image;
+        if (SEH_ParseLoadedImage(module.base, module.size, image)) {
+            module.timeDateStamp = image.GetTimeDateStamp();
+            module.sizeOfImage = image.GetSizeOfImage();
+            module.checkSum = image.GetCheckSum();
+        }
+        modules.push_back(module);
+    }
+    return true;
+}
+
+// El índice del proceso, con el backend de VirtualQuery puesto
+static inline AddressSpaceIndex& SEH_GetRegionIndex() {
+    AddressSpaceIndex& index = AddressSpaceIndex::GetProcessIndex();
+    if (!index.HasBackend()) {
+        RegionBackend backend;
+        backend.query = &SEH_QueryRegion;
+        backend.modules = &SEH_EnumerateModules;
+        index.SetBackend(backend);
+    }
+    return index;
+}
+
+// Tabla actual; con refresh (o si aún no hay) antes se re-consulta lo que haya cambiado
+static inline std::shared_ptr<const RegionTable> SEH_GetRegionTable(bool refresh = false) {
+    AddressSpaceIndex& index = SEH_GetRegionIndex();
+    std::shared_ptr<const RegionTable> table = index.Get();
+    if (!table || refresh) {
+        index.Refresh();
+        table = index.Get();
+    }
+    return table;
+}
+
+// Tramos legibles de [start, start + size) según el índice. Antes se vuelve a consultar solo
+// ese rango (una consulta por región, igual que recorrerlo a mano), así un módulo recién
+// cargado ya está y el resto de scanners lo ve sin consultarlo otra vez. Las regiones
+// legibles contiguas se unen en un solo tramo para no perder matches que cruzan el límite.
+// 'visit(runStart, runSize)' devuelve true para detener el recorrido.
+template <typename Visitor>
+static inline void SEH_ForEachReadableRun(uintptr_t start, size_t size, Visitor visit) {
+    AddressSpaceIndex& index = SEH_GetRegionIndex();
+    index.RefreshRange(start, size);
+
+    const std::shared_ptr<const RegionTable> table = index.Get();
+    if (table) {
+        table->ForEachReadableRun(start, size, visit);
+    }
+}
+
+static inline uintptr_t SEH_FindPatternInRange(uintptr_t start, size_t size, const PreparedPattern& pattern) {
+    uintptr_t result = 0;
+    SEH_ForEachReadableRun(start, size, [&](uintptr_t runStart, size_t runSize) {
+        const uint8_t* match = SEH_FindPatternRaw(reinterpret_cast<const uint8_t*>(runStart), runSize, pattern);
+        result = reinterpret_cast<uintptr_t>(match);
+        return match != nullptr;
+    });
+    return result;
+}
+
+// Acumula en 'matches' los patrones aún no encontrados dentro de [start, start + size).
+// Cada tramo legible se reparte en chunks entre los workers de 'options'; cada chunk va
+// protegido por su propio frame SEH.
+static inline bool SEH_AccumulatePatternsInRange(uintptr_t start, size_t size, const MultiPatternScanner& scanner,
+                                                 std::vector<const uint8_t*>& matches,
+                                                 const ScanOptions& options = ScanOptions()) {
+    bool done = false;
+    SEH_ForEachReadableRun(start, size, [&](uintptr_t runStart, size_t runSize) {
+        const size_t remaining = ParallelPatternScanner::FindFirstAll(reinterpret_cast<const uint8_t*>(runStart), runSize,
+            scanner, options, matches, SEH_FindPatternsRaw);
+        done = remaining == 0;
+        return done;
+    });
+    return done;
+}
+
+static inline void SEH_StoreMatches(const std::vector<const uint8_t*>& matches, std::vector<uintptr_t>& results) {
+    results.assign(matches.size(), 0);
+    for (size_t id = 0; id < matches.size(); ++id) {
+        results[id] = reinterpret_cast<uintptr_t>(matches[id]);
+    }
+}
+
+// Una sola pasada para todos los patrones del scanner; results[id] = dirección o 0.
+static inline void SEH_FindPatternsInRange(uintptr_t start, size_t size, const MultiPatternScanner& scanner,
+                                           std::vector<uintptr_t>& results,
+                                           const ScanOptions& options = ScanOptions()) {
+    std::vector<const uint8_t*> matches(scanner.GetPatternCount(), nullptr);
+    SEH_AccumulatePatternsInRange(start, size, scanner, matches, options);
+    SEH_StoreMatches(matches, results);
+}
+
+// Modo enumeración: cuenta todos los matches de cada patrón en [start, start + size) y guarda
+// hasta maxCandidates direcciones por patrón. Se suma a lo que ya haya en 'results'.
+static inline void SEH_EnumeratePatternsInRange(uintptr_t start, size_t size, const MultiPatternScanner& scanner,
+                                                std::vector<PatternMatches>& results, size_t maxCandidates,
+                                                const ScanOptions& options = ScanOptions()) {
+    results.resize(scanner.GetPatternCount());
+    SEH_ForEachReadableRun(start, size, [&](uintptr_t runStart, size_t runSize) {
+        ParallelPatternScanner::FindAll(reinterpret_cast<const uint8_t*>(runStart), runSize,
+            scanner, options, results, maxCandidates, SEH_EnumeratePatternsRaw);
+        return false;
+    });
+}
+
+// Escanea solo las secciones cuyo tipo está en 'sectionMask' (p.ej. SECTION_CODE para
+// firmas de código). La protección se valida una vez por región de cada sección.
+static inline void SEH_FindPatternsInSections(uintptr_t moduleBase, const PEImage& image, uint32_t sectionMask,
+                                              const MultiPatternScanner& scanner, std::vector<uintptr_t>& results,
+                                              const ScanOptions& options = ScanOptions()) {
+    std::vector<const uint8_t*> matches(scanner.GetPatternCount(), nullptr);
+    for (const PESection& section : image.GetSections()) {
+        if (!(section.kind & sectionMask)) continue;
+
+        if (SEH_AccumulatePatternsInRange(moduleBase + section.virtualAddress, section.virtualSize, scanner, matches, options)) {
+            break;
+        }
+    }
+    SEH_StoreMatches(matches, results);
+}
+
+static inline bool SEH_AddXrefsRaw(XrefIndex& index, const uint8_t* code, size_t size, uint32_t rva, uint32_t imageSize) {
+    __try {
+        index.AddCode(code, size, rva, imageSize);
+        return true;
+    }
+    __except (EXCEPTION_EXECUTE_HANDLER) {
+        return false;
+    }
+}
+
+// Índice de xrefs de las secciones de código de un módulo cargado: un barrido por tramo
+// legible. false si algún tramo falló a medias (el índice queda con lo que se leyó)
+static inline bool SEH_BuildXrefIndex(uintptr_t moduleBase, const PEImage& image, XrefIndex& index) {
+    index.Clear();
+
+    bool complete = true;
+    for (const PESection& section : image.GetSections()) {
+        if (!(section.kind & SECTION_CODE)) continue;
+
+        SEH_ForEachReadableRun(moduleBase + section.virtualAddress, section.virtualSize, [&](uintptr_t runStart, size_t runSize) {
+            if (!SEH_AddXrefsRaw(index, reinterpret_cast<const uint8_t*>(runStart), runSize,
+                                 static_cast<uint32_t>(runStart - moduleBase), image.GetSizeOfImage())) {
+                complete = false;
+            }
+            return false;
+        });
+    }
+
+    index.Finalize();
+    return complete;
+}
+
+static inline bool SEH_AddStringsRaw(StringIndex& index, const uint8_t* data, size_t size, uint32_t rva) {
+    __try {
+        index.AddData(data, size, rva);
+        return true;
+    }
+    __except (EXCEPTION_EXECUTE_HANDLER) {
+        return false;
+    }
+}
+
+// Índice de cadenas de las secciones .rdata de un módulo cargado
+static inline bool SEH_BuildStringIndex(uintptr_t moduleBase, const PEImage& image, StringIndex& index) {
+    index.Clear();
+
+    bool complete = true;
+    for (const PESection& section : image.GetSections()) {
+        if (!(section.kind & SECTION_RDATA)) continue;
+
+        SEH_ForEachReadableRun(moduleBase + section.virtualAddress, section.virtualSize, [&](uintptr_t runStart, size_t runSize) {
+            if (!SEH_AddStringsRaw(index, reinterpret_cast<const uint8_t*>(runStart), runSize,
+                                   static_cast<uint32_t>(runStart - moduleBase))) {
+                complete = false;
+            }
+            return false;
+        });
+    }
+
+    index.Finalize();
+    return complete;
+}
+
+static inline bool SEH_HashPagesRaw(PageHashSet& pages, const uint8_t* data, size_t size, uint32_t rva) {
+    __try {
+        pages.HashPages(data, size, rva);
+        return true;
+    }
+    __except (EXCEPTION_EXECUTE_HANDLER) {
+        return false;
+    }
+}
+
+// Hashes por página de las secciones cuyo tipo está en 'sectionMask', un tramo por sección
+// hasheado por tramos legibles. Las páginas que no se pueden leer (o que fallan a medias)
+// quedan desconocidas y Diff las da por sucias; el resto de la sección vale.
+// false si quedó alguna desconocida
+static inline bool SEH_HashSections(uintptr_t moduleBase, const PEImage& image, uint32_t sectionMask, PageHashSet& pages) {
+    pages.Clear();
+
+    for (const PESection& section : image.GetSections()) {
+        if (!(section.kind & sectionMask)) continue;
+
+        pages.BeginRange(section.virtualAddress, section.virtualSize);
+        SEH_ForEachReadableRun(moduleBase + section.virtualAddress, section.virtualSize, [&](uintptr_t runStart, size_t runSize) {
+            SEH_HashPagesRaw(pages, reinterpret_cast<const uint8_t*>(runStart), runSize,
+                             static_cast<uint32_t>(runStart - moduleBase));
+            return false;
+        });
+    }
+    return pages.GetUnknownPageCount() == 0;
+}
+
+// Lectura para MemorySnapshot, cadenas de punteros y el estado por frame (context sin usar).
+// Lo que el índice de regiones da por legible se lee directamente (bajo SEH por si se liberó
+// después). Lo demás se vuelve a consultar (solo ese rango) y se mete en el índice: el heap
+// reservado después del último refresco (el de un nivel recién cargado) cuesta una consulta
+// en la primera lectura y ninguna en las siguientes. Un puntero colgando sigue costando una
+// consulta y no una excepción; uno nulo (los primeros 64 KB nunca se mapean) ni eso
+static inline bool SEH_ReadSnapshotMemory(void*, uintptr_t address, void* buffer, size_t size) {
+    if (address < 0x10000) return false;
+
+    AddressSpaceIndex& index = AddressSpaceIndex::GetProcessIndex();
+    std::shared_ptr<const RegionTable> table = index.Get();
+    if (table && !table->IsReadable(address, size)) {
+        index.RefreshRange(address, size);
+        table = index.Get();
+        if (!table || !table->IsReadable(address, size)) return false;
+    }
+    return SEH_MemReadRaw(address, buffer, size);
+}
+
+// Regiones comprometidas y escribibles del proceso (privadas o de imagen), para la búsqueda de
+// valores. Todo el espacio de usuario (el heap del juego vive muy por encima de 2 GB), sacado
+// del índice tras refrescar lo que cambió
+static inline void SEH_CollectWritableRanges(std::vector<SnapshotRange>& ranges) {
+    ranges.clear();
+
+    const std::shared_ptr<const RegionTable> table = SEH_GetRegionTable(true);
+    if (!table) return;
+
+    for (const AddressRegion& region : table->GetRegions()) {
+        if (region.IsWritable() && (region.type == MEM_PRIVATE || region.type == MEM_IMAGE)) {
+            SnapshotRange range;
+            range.base = region.base;
+            range.size = region.size;
+            ranges.push_back(range);
+        }
+    }
+}
+
+// Regiones comprometidas y legibles del proceso (privadas o de imagen; las de ficheros
+// mapeados no) para el scanner de punteros y los volcados. Se leen con SEH_ReadSnapshotMemory
+// Con 'withModules' también los módulos del índice (ya con su identidad)
+static inline void SEH_CollectProcessRegions(ProcessMemory& memory, bool withModules = false) {
+    const std::shared_ptr<const RegionTable> table = SEH_GetRegionTable(true);
+    if (table) {
+        for (const AddressRegion& source : table->GetRegions()) {
+            if (!source.IsReadable() || (source.type != MEM_PRIVATE && source.type != MEM_IMAGE)) continue;
+
+            ProcessRegion region;
+            region.base = source.base;
+            region.size = source.size;
+            region.protect = source.protect;
+            if (source.IsWritable()) region.flags |= REGION_WRITABLE;
+            if (source.IsExecutable()) region.flags |= REGION_EXECUTABLE;
+            if (source.type == MEM_IMAGE) region.flags |= REGION_IMAGE;
+            memory.AddRegion(region);
+        }
+
+        if (withModules) {
+            for (const ProcessModule& module : table->GetModules()) memory.AddModule(module);
+        }
+    }
+
+    memory.SetReader(&SEH_ReadSnapshotMemory, nullptr);
+}
+
+// Backend de BatchedMemoryWriter sobre VirtualQuery/VirtualProtect; la copia va bajo SEH
+static inline bool SEH_WriterQuery(void*, uintptr_t page, uint32_t& protect) {
+    MEMORY_BASIC_INFORMATION mbi = {};
+    if (VirtualQuery(reinterpret_cast<LPCVOID>(page), &mbi, sizeof(mbi)) != sizeof(mbi)) return false;
+    if (mbi.State != MEM_COMMIT) return false;
+    protect = mbi.Protect;
+    return true;
+}
+
+static inline bool SEH_WriterProtect(void*, uintptr_t address, size_t size, uint32_t newProtect, uint32_t& oldProtect) {
+    DWORD previous = 0;
+    if (!VirtualProtect(reinterpret_cast<LPVOID>(address), size, newProtect, &previous)) return false;
+    oldProtect = previous;
+    return true;
+}
+
+static inline bool SEH_WriterWrite(void*, uintptr_t address, const void* buffer, size_t size) {
+    return SEH_MemWriteRaw(address, buffer, size);
+}
+
+static inline MemoryWriterBackend SEH_GetWriterBackend() {
+    MemoryWriterBackend backend;
+    backend.query = &SEH_WriterQuery;
+    backend.protect = &SEH_WriterProtect;
+    backend.write = &SEH_WriterWrite;
+    return backend;
+}
@@ -3,18 +3,27 @@
 #include <windows.h>
 #include <vector>
 #include <string>
+#include "HaloMCC_PatternScanner.h"
+#include "UWP_StoreSignatures.h"
+#include "HaloMCC_PEImage.h"
+#include "SEHHelpers.h"
 
 class UWPMemoryScanner {
 public:
     struct MemoryPattern {
-        std::vector<uint8_t> pattern;
-        std::vector<bool> mask;
+        PreparedPattern pattern;            // vista a una Signature constexpr (ver HaloMCC_Signature.h)
         size_t offset;
-        std::string description;
+        const char* description;
+        uint32_t sections = SECTION_CODE;   // SectionKind en los que buscar (firmas de código por defecto)
     };
     
     static DWORD_PTR FindPattern(const std::string& moduleName, const MemoryPattern& pattern);
     static DWORD_PTR FindPatternInRange(DWORD_PTR start, size_t size, const MemoryPattern& pattern);
+
+    // Varios patrones en una sola pasada; resultado[i] corresponde a patterns[i] (0 = no encontrado)
+    static std::vector<DWORD_PTR> FindPatterns(const std::string& moduleName, const std::vector<MemoryPattern>& patterns);
+    static std::vector<DWORD_PTR> FindPatternsInRange(DWORD_PTR start, size_t size, const std::vector<MemoryPattern>& patterns);
+    static std::vector<DWORD_PTR> FindPatternsInModule(DWORD_PTR moduleBase, size_t moduleSize, const std::vector<MemoryPattern>& patterns);
     static bool IsUWPMemoryProtected(DWORD_PTR address);
     static std::vector<MEMORY_BASIC_INFORMATION> GetMemoryRegions();
     
@@ -23,9 +32,9 @@ public:
     static MemoryPattern GetSwapChainPresentPattern();
     static MemoryPattern GetXInputPattern();
     static MemoryPattern GetGameStatePattern();
+    static std::vector<MemoryPattern> GetStorePatterns();
     
 private:
-    static bool PatternMatch(const uint8_t* data, const MemoryPattern& pattern);
     static MODULEINFO GetModuleInfo(const std::string& moduleName);
 };
 
@@ -35,40 +44,92 @@ private:
 #include <iostream>
 
 DWORD_PTR UWPMemoryScanner::FindPattern(const std::string& moduleName, const MemoryPattern& pattern) {
+    return FindPatterns(moduleName, { pattern })[0];
+}
+
+DWORD_PTR UWPMemoryScanner::FindPatternInRange(DWORD_PTR start, size_t size, const MemoryPattern& pattern) {
+    if (pattern.pattern.view.length == 0) return 0;
+
+    // VirtualQuery una vez por región en lugar de IsUWPMemoryProtected por cada byte
+    uintptr_t match = SEH_FindPatternInRange(start, size, pattern.pattern);
+    return match ? match + pattern.offset : 0;
+}
+
+std::vector<DWORD_PTR> UWPMemoryScanner::FindPatterns(const std::string& moduleName, const std::vector<MemoryPattern>& patterns) {
     MODULEINFO modInfo = GetModuleInfo(moduleName);
-    if (modInfo.lpBaseOfDll == nullptr) return 0;
-    
-    return FindPatternInRange(
+    if (modInfo.lpBaseOfDll == nullptr) return std::vector<DWORD_PTR>(patterns.size(), 0);
+
+    return FindPatternsInModule(
         reinterpret_cast<DWORD_PTR>(modInfo.lpBaseOfDll),
         modInfo.SizeOfImage,
-        pattern
+        patterns
     );
 }
 
-DWORD_PTR UWPMemoryScanner::FindPatternInRange(DWORD_PTR start, size_t size, const MemoryPattern& pattern) {
-    for (size_t i = 0; i <= size - pattern.pattern.size(); ++i) {
-        const uint8_t* current = reinterpret_cast<const uint8_t*>(start + i);
-        
-        // Verificar si podemos leer esta memoria
-        if (!IsUWPMemoryProtected(start + i)) {
-            if (PatternMatch(current, pattern)) {
-                return start + i + pattern.offset;
-            }
+std::vector<DWORD_PTR> UWPMemoryScanner::FindPatternsInRange(DWORD_PTR start, size_t size, const std::vector<MemoryPattern>& patterns) {
+    MultiPatternScanner scanner;
+    for (const auto& pattern : patterns) {
+        scanner.AddPattern(pattern.pattern);
+    }
+
+    std::vector<uintptr_t> matches;
+    SEH_FindPatternsInRange(start, size, scanner, matches);
+
+    std::vector<DWORD_PTR> results(patterns.size(), 0);
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        if (matches[i] && patterns[i].pattern.view.length) {
+            results[i] = matches[i] + patterns[i].offset;
         }
     }
-    return 0;
+    return results;
 }
 
-bool UWPMemoryScanner::PatternMatch(const uint8_t* data, const MemoryPattern& pattern) {
-    for (size_t i = 0; i < pattern.pattern.size(); ++i) {
-        if (pattern.mask[i] && data[i] != pattern.pattern[i]) {
-            return false;
+std::vector<DWORD_PTR> UWPMemoryScanner::FindPatternsInModule(DWORD_PTR moduleBase, size_t moduleSize, const std::vector<MemoryPattern>& patterns) {
+    PEImage image;
+    if (!SEH_ParseLoadedImage(moduleBase, moduleSize, image)) {
+        return FindPatternsInRange(moduleBase, moduleSize, patterns);
+    }
+
+    // Un scanner (una pasada) por cada combinación de secciones pedida
+    std::vector<DWORD_PTR> results(patterns.size(), 0);
+    std::vector<bool> done(patterns.size(), false);
+
+    for (size_t first = 0; first < patterns.size(); ++first) {
+        if (done[first]) continue;
+
+        const uint32_t sections = patterns[first].sections;
+        MultiPatternScanner scanner;
+        std::vector<size_t> ids;
+        for (size_t i = first; i < patterns.size(); ++i) {
+            if (!done[i] && patterns[i].sections == sections) {
+                scanner.AddPattern(patterns[i].pattern);
+                ids.push_back(i);
+                done[i] = true;
+            }
+        }
+
+        std::vector<uintptr_t> matches;
+        SEH_FindPatternsInSections(moduleBase, image, sections, scanner, matches);
+
+        for (size_t k = 0; k < ids.size(); ++k) {
+            if (matches[k] && patterns[ids[k]].pattern.view.length) {
+                results[ids[k]] = matches[k] + patterns[ids[k]].offset;
+            }
         }
     }
-    return true;
+
+    return results;
 }
 
 bool UWPMemoryScanner::IsUWPMemoryProtected(DWORD_PTR address) {
+    // Lo que el índice de regiones da por accesible no cuesta un VirtualQuery; lo demás se
+    // confirma en vivo (puede haberse comprometido después del último refresco)
+    const std::shared_ptr<const RegionTable> table = SEH_GetRegionTable();
+    const AddressRegion* region = table ? table->Find(address) : nullptr;
+    if (region && region->IsCommitted() && !(region->protect & (PAGE_GUARD | PAGE_NOACCESS))) {
+        return false;
+    }
+
     MEMORY_BASIC_INFORMATION mbi;
     if (VirtualQuery(reinterpret_cast<LPCVOID>(address), &mbi, sizeof(mbi))) {
         // Las aplicaciones UWP tienen protecciones especiales
@@ -92,57 +153,53 @@ MODULEINFO UWPMemoryScanner::GetModuleInfo(const std::string& moduleName) {
 
 std::vector<MEMORY_BASIC_INFORMATION> UWPMemoryScanner::GetMemoryRegions() {
     std::vector<MEMORY_BASIC_INFORMATION> regions;
-    MEMORY_BASIC_INFORMATION mbi;
-    DWORD_PTR address = 0;
-    
-    while (VirtualQuery(reinterpret_cast<LPCVOID>(address), &mbi, sizeof(mbi))) {
+
+    // Todo el espacio de usuario desde el índice (refrescado solo donde cambió)
+    const std::shared_ptr<const RegionTable> table = SEH_GetRegionTable(true);
+    if (!table) return regions;
+
+    regions.reserve(table->GetRegions().size());
+    for (const AddressRegion& region : table->GetRegions()) {
+        MEMORY_BASIC_INFORMATION mbi = {};
+        mbi.BaseAddress = reinterpret_cast<PVOID>(region.base);
+        mbi.AllocationBase = reinterpret_cast<PVOID>(region.allocationBase);
+        mbi.AllocationProtect = region.allocationProtect;
+        mbi.RegionSize = region.size;
+        mbi.State = region.state;
+        mbi.Protect = region.protect;
+        mbi.Type = region.type;
         regions.push_back(mbi);
-        address = reinterpret_cast<DWORD_PTR>(mbi.BaseAddress) + mbi.RegionSize;
-        
-        // Límite de seguridad para evitar loops infinitos
-        if (address >= 0x7FFFFFFF) break;
     }
-    
+
     return regions;
 }
 
 // Patrones específicos para encontrar funciones en Microsoft Store version
 UWPMemoryScanner::MemoryPattern UWPMemoryScanner::GetD3D11DevicePattern() {
     // Patrón para encontrar D3D11Device en UWP
-    return {
-        {0x48, 0x89, 0x5C, 0x24, 0x00, 0x57, 0x48, 0x83, 0xEC, 0x00, 0x48, 0x8B, 0xFA},
-        {true, true, true, true, false, true, true, true, true, false, true, true, true},
-        0,
-        "D3D11Device Creation Pattern"
-    };
+    return { kD3D11DeviceSignature.Prepared(), 0, "D3D11Device Creation Pattern" };
 }
 
 UWPMemoryScanner::MemoryPattern UWPMemoryScanner::GetSwapChainPresentPattern() {
     // Patrón más específico para Present en UWP
-    return {
-        {0x48, 0x89, 0x74, 0x24, 0x00, 0x48, 0x89, 0x7C, 0x24, 0x00, 0x41, 0x56},
-        {true, true, true, true, false, true, true, true, true, false, true, true},
-        0,
-        "SwapChain Present Pattern"
-    };
+    return { kSwapChainPresentSignature.Prepared(), 0, "SwapChain Present Pattern" };
 }
 
 UWPMemoryScanner::MemoryPattern UWPMemoryScanner::GetXInputPattern() {
     // Patrón para XInputGetState en UWP context
-    return {
-        {0x85, 0xC9, 0x0F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x83, 0xF9, 0x04},
-        {true, true, true, true, false, false, false, false, true, true, true},
-        0,
-        "XInputGetState Pattern"
-    };
+    return { kXInputSignature.Prepared(), 0, "XInputGetState Pattern" };
 }
 
 UWPMemoryScanner::MemoryPattern UWPMemoryScanner::GetGameStatePattern() {
     // Patrón para detectar el estado actual del juego
+    return { kGameStateSignature.Prepared(), 0, "Game State Pattern" };
+}
+
+std::vector<UWPMemoryScanner::MemoryPattern> UWPMemoryScanner::GetStorePatterns() {
     return {
-        {0x48, 0x8B, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xC9, 0x74},
-        {true, true, true, false, false, false, false, true, true, true, true},
-        0,
-        "Game State Pattern"
+        GetD3D11DevicePattern(),
+        GetSwapChainPresentPattern(),
+        GetXInputPattern(),
+        GetGameStatePattern()
     };
 }
\ No newline at end of file
@@ -12,6 +12,16 @@
 #include <tlhelp32.h>
 #include <psapi.h>
 #include "HaloMCC_OffsetScanner.h"
+#include "HaloMCC_MemorySnapshot.h"
+#include "HaloMCC_PointerChain.h"
+#include "HaloMCC_MemoryWriter.h"
+#include "HaloMCC_FrameState.h"
+#include "HaloMCC_SeqLock.h"
+#include "HaloMCC_TripleBuffer.h"
+#include "HaloMCC_PointerScan.h"
+#include "HaloMCC_ProcessMemory.h"
+#include "HaloMCC_ThreadPool.h"
+#include "HaloMCC_AsyncLog.h"
 
 
 #include <array>
@@ -24,6 +34,7 @@
 #include <sstream>
 #include <atomic>
 #include <mutex>
+#include <memory>
 #include <iomanip>
 #include <unordered_map>
 #include <queue>
@@ -102,12 +113,20 @@ struct CameraState {
     }
 };
 
+// Lo que el render escribe en el juego, publicado por CameraUpdateLoop
+struct RenderCamera {
+    XMMATRIX viewMatrix;
+    XMMATRIX projMatrix;
+    XMFLOAT3 position;
+};
+
 struct PlayerState {
     int playerSlot;
     int controllerIndex;
-    CameraState camera;
+    CameraState camera;                         // solo CameraUpdateLoop (e InitializePlayers)
     bool active;
-    XINPUT_STATE lastInput;
+    SeqLock<XINPUT_STATE> lastInput;            // hook de XInput -> CameraUpdateLoop
+    TripleBuffer<RenderCamera> renderCamera;    // CameraUpdateLoop -> Present
     float movementSpeed;
     float rotationSpeed;
 
@@ -126,7 +145,15 @@ struct PlayerState {
         depthStencil(nullptr),
         renderTexture(nullptr),
         shaderResourceView(nullptr) {
-        ZeroMemory(&lastInput, sizeof(XINPUT_STATE));
+    }
+
+    // Publica las matrices actuales para el render
+    void PublishCamera() {
+        RenderCamera& published = renderCamera.GetWriteBuffer();
+        published.viewMatrix = camera.viewMatrix;
+        published.projMatrix = camera.projMatrix;
+        published.position = camera.position;
+        renderCamera.Publish();
     }
 
     ~PlayerState() {
@@ -207,7 +234,8 @@ private:
     RenderPipeline renderPipeline;
     std::mutex renderMutex;
 
-    // Nuevas variables para offsets
+    // Nuevas variables para offsets. gameOffsets es la copia de trabajo del escaneo y del
+    // watcher (con offsetMutex); los demás hilos leen activeOffsets
     GameOffsets gameOffsets;
     bool offsetsScanned = false;
     std::mutex offsetMutex;
@@ -215,6 +243,39 @@ private:
     bool lastKnownSplitScreenState = false;
     std::chrono::steady_clock::time_point lastOffsetScanTime;
 
+    // Offsets del ejecutable; los de un título los sustituyen mientras su DLL está cargada
+    GameOffsets mainGameOffsets;
+    GameVersion mainGame = GameVersion::UNKNOWN_GAME;
+    uintptr_t activeTitleModule = 0;
+
+    // Búsqueda de valores en memoria (F5-F8) para sacar offsets sin Cheat Engine
+    MemorySnapshot memorySearch;
+
+    // Offsets del módulo activo y la dirección de cada campo (hueco = OffsetField): la cadena
+    // de punteros del perfil si trae una, si no la estática del escaneo. Al cambiar de título
+    // se monta uno nuevo con las cadenas ya resueltas y se cambia el puntero de golpe; quien
+    // lo lee coge el puntero una vez y usa esa copia entera (nunca offsets viejos con cadenas
+    // nuevas ni un Get() a 0 a medio rehacer)
+    struct ActiveOffsets {
+        GameOffsets offsets;            // no cambia una vez publicado
+        PointerChainCache fields;       // se re-resuelven al cambiar de nivel (CameraUpdateLoop)
+    };
+    std::shared_ptr<ActiveOffsets> activeOffsets = std::make_shared<ActiveOffsets>();
+
+    std::shared_ptr<ActiveOffsets> GetActiveOffsets() const {
+        return std::atomic_load(&activeOffsets);
+    }
+
+    // Escrituras al juego agrupadas por página: las cámaras se encolan y se vuelcan una vez
+    // por frame; VirtualProtect solo para páginas que no son escribibles
+    BatchedMemoryWriter memoryWriter;
+
+    // Estado del juego muestreado en cada Present; el resto de hilos lee esta copia. Si lleva
+    // más de MaxFrameStateAgeMs sin muestrearse (no hay Present) lee su propia copia, que no
+    // se publica: solo Present publica y nunca espera por otro hilo
+    FrameStateSampler frameState;
+    static const int64_t MaxFrameStateAgeMs = 100;
+
     // Hook management
     typedef HRESULT(STDMETHODCALLTYPE* Present_t)(IDXGISwapChain*, UINT, UINT);
     typedef HRESULT(STDMETHODCALLTYPE* ResizeBuffers_t)(IDXGISwapChain*, UINT, UINT, UINT, DXGI_FORMAT, UINT);
@@ -246,20 +307,28 @@ private:
     std::thread hotkeyThread;
     std::atomic<bool> stopThreads{ false };
 
+    // Workers de los escaneos pesados (offsets, búsqueda de valores, cadenas de punteros): uno
+    // para todo el mod, creado en Initialize. ParallelFor se serializa entre hilos, así que un
+    // título escaneándose y una búsqueda se turnan en vez de crear workers por llamada
+    std::unique_ptr<ScanThreadPool> scanPool;
+
+    // Volcado del proceso (Ctrl+F11): son varios GB, va en su propio hilo
+    std::thread dumpThread;
+    std::atomic<bool> dumpInProgress{ false };
+
     // Logging
-    std::mutex logMutex;
-    std::ofstream logFile;
     std::atomic<uint64_t> frameCounter{ 0 };
 
     // Performance metrics
     std::chrono::high_resolution_clock::time_point lastFrameTime;
-    float deltaTime = 0.016f;
+    std::atomic<float> deltaTime{ 0.016f };     // Present -> CameraUpdateLoop
 
     // ========================================
     // MÉTODOS PARA MANEJO DE OFFSETS
     // ========================================
 
-    bool ScanGameOffsetsOnce() {
+    // forceFullScan = ignorar la caché de offsets (rescan manual)
+    bool ScanGameOffsetsOnce(bool forceFullScan = false) {
         std::lock_guard<std::mutex> lock(offsetMutex);
 
         if (offsetsScanned) {
@@ -272,8 +341,9 @@ private:
 
         lastOffsetScanTime = std::chrono::steady_clock::now();
 
-        // Usar el scanner automático
-        gameOffsets = HaloMCCOffsetScanner::ScanForOffsets();
+        // Usar el scanner automático (con caché por versión del ejecutable)
+        gameOffsets = HaloMCCOffsetScanner::LoadOrScanOffsets(
+            static_cast<uint32_t>(currentGame), static_cast<uint32_t>(platform), forceFullScan);
         offsetsScanned = true;
 
         if (gameOffsets.valid) {
@@ -288,6 +358,97 @@ private:
         }
     }
 
+    // Guarda los offsets del ejecutable recién escaneados y vuelve a aplicar el título que
+    // esté cargado (si lo hay), que tiene prioridad
+    void SyncTitleOffsets() {
+        {
+            std::lock_guard<std::mutex> lock(offsetMutex);
+            mainGameOffsets = gameOffsets;
+            mainGame = currentGame;
+            activeTitleModule = 0;
+            LoadMainFieldAddresses();
+        }
+
+        for (const TitleOffsets& title : HaloMCCOffsetScanner::GetLoadedTitles()) {
+            OnTitleOffsets(title, true);
+        }
+    }
+
+    // Hilo del watcher de módulos: un título nuevo con offsets válidos pasa a ser el activo;
+    // al descargarse se vuelve a los del ejecutable
+    void OnTitleOffsets(const TitleOffsets& title, bool loaded) {
+        std::lock_guard<std::mutex> lock(offsetMutex);
+
+        if (loaded) {
+            if (!title.offsets.valid) {
+                Log("✗ Título sin offsets válidos (módulo 0x" + ToHexString(title.moduleBase) + "), se mantienen los actuales");
+                return;
+            }
+
+            gameOffsets = title.offsets;
+            if (title.gameVersion < static_cast<uint32_t>(GameVersion::UNKNOWN_GAME)) {
+                currentGame = static_cast<GameVersion>(title.gameVersion);
+            }
+            activeTitleModule = title.moduleBase;
+
+            Log("✓ Offsets del título activos: " + GameVersionToString(currentGame));
+            LogFoundOffsets();
+            LoadFieldAddresses(title.moduleBase, title.moduleSize, title.gameVersion);
+        }
+        else if (title.moduleBase == activeTitleModule) {
+            gameOffsets = mainGameOffsets;
+            currentGame = mainGame;
+            activeTitleModule = 0;
+            Log("Título descargado: vuelven los offsets del ejecutable");
+            LoadMainFieldAddresses();
+        }
+    }
+
+    // Publica gameOffsets con las direcciones de sus campos para el módulo activo (con
+    // offsetMutex tomado). El anterior sigue valiendo para quien ya lo tenga
+    void LoadFieldAddresses(uintptr_t moduleBase, size_t moduleSize, uint32_t gameVersion) {
+        std::shared_ptr<ActiveOffsets> next = std::make_shared<ActiveOffsets>();
+        next->offsets = gameOffsets;
+        PointerChainCache& fieldAddresses = next->fields;
+        fieldAddresses.SetReader(&SEH_ReadSnapshotMemory, nullptr);
+
+        // Una cadena sin offsets es la dirección tal cual: mismo camino de lectura para todos
+        fieldAddresses.SetChain(OFFSET_SPLIT_SCREEN_ENABLED, gameOffsets.splitScreenEnabledOffset, {});
+        fieldAddresses.SetChain(OFFSET_PLAYER_COUNT, gameOffsets.playerCountOffset, {});
+        fieldAddresses.SetChain(OFFSET_CAMERA_BASE, gameOffsets.cameraBaseOffset, {});
+
+        const std::vector<OffsetCachePointerPath> paths = HaloMCCOffsetScanner::GetPointerPaths(
+            moduleBase, moduleSize, gameVersion, static_cast<uint32_t>(platform));
+        for (const OffsetCachePointerPath& path : paths) {
+            if (path.baseRva >= moduleSize) continue;
+
+            fieldAddresses.SetChain(path.field, moduleBase + path.baseRva, path.offsets);
+            Log("  " + std::string(OffsetScanCore::FieldToString(path.field)) + ": cadena de punteros desde RVA 0x" +
+                ToHexString(path.baseRva) + " (" + std::to_string(path.offsets.size()) + " niveles)");
+        }
+
+        // Cambio de nivel = cambia el estado de juego o el de menú
+        fieldAddresses.AddWatch(gameOffsets.gameStateOffset);
+        fieldAddresses.AddWatch(gameOffsets.menuStateOffset);
+        fieldAddresses.Refresh();
+
+        std::atomic_store(&activeOffsets, next);
+        memoryWriter.InvalidatePages();
+    }
+
+    void LoadMainFieldAddresses() {
+        MODULEINFO info = {};
+        HMODULE exe = GetModuleHandleA(nullptr);
+        if (!exe || !GetModuleInformation(GetCurrentProcess(), exe, &info, sizeof(info))) return;
+
+        LoadFieldAddresses(reinterpret_cast<uintptr_t>(info.lpBaseOfDll), info.SizeOfImage,
+            static_cast<uint32_t>(mainGame));
+    }
+
+    static void TitleOffsetsChanged(const TitleOffsets& title, bool loaded) {
+        GetInstance().OnTitleOffsets(title, loaded);
+    }
+
     void LogFoundOffsets() {
         Log("=== OFFSETS ENCONTRADOS ===");
 
@@ -333,7 +494,7 @@ private:
 
         gameOffsets = GameOffsets{};
 
-        // AQUÍ PONES LOS OFFSETS QUE ENCUENTRES CON CHEAT ENGINE
+        // AQUÍ PONES LOS OFFSETS QUE ENCUENTRES CON CHEAT ENGINE (o con la búsqueda de F5-F8)
         if (platform == GamePlatform::MICROSOFT_STORE) {
 
             if (currentGame == GameVersion::HALO_CE) {
@@ -397,49 +558,75 @@ private:
     // MÉTODOS PARA LEER/ESCRIBIR MEMORIA
     // ========================================
 
-    int ReadPlayerCount() {
-        if (!gameOffsets.valid || !gameOffsets.playerCountOffset) {
-            return 1;
+    // Direcciones de este momento: las cadenas de punteros ya resueltas y los globales tal cual
+    static FrameStateAddresses GetFrameStateAddresses(const ActiveOffsets& active) {
+        const GameOffsets& offsets = active.offsets;
+
+        FrameStateAddresses addresses;
+        addresses.valid = offsets.valid;
+        if (!addresses.valid) {
+            return addresses;
         }
 
-        return ReadMemoryValue<int>(gameOffsets.playerCountOffset, 1);
+        addresses.fields[FRAME_PLAYER_COUNT] = active.fields.Get(OFFSET_PLAYER_COUNT);
+        addresses.fields[FRAME_MAX_PLAYERS] = offsets.maxPlayersOffset;
+        addresses.fields[FRAME_LOCAL_PLAYERS] = offsets.localPlayersOffset;
+        addresses.fields[FRAME_SPLIT_SCREEN_ENABLED] = active.fields.Get(OFFSET_SPLIT_SCREEN_ENABLED);
+        addresses.fields[FRAME_COOP_MODE] = offsets.coopModeOffset;
+        addresses.fields[FRAME_MENU_STATE] = offsets.menuStateOffset;
+        addresses.fields[FRAME_GAME_STATE] = offsets.gameStateOffset;
+        addresses.cameraBase = active.fields.Get(OFFSET_CAMERA_BASE);
+        return addresses;
     }
 
-    bool ReadSplitScreenEnabled() {
-        if (!gameOffsets.valid || !gameOffsets.splitScreenEnabledOffset) {
-            return false;
+    // Lectura a demanda fuera de Present (no publica)
+    FrameState ReadFrameStateNow() {
+        return frameState.Read(frameCounter.load(), GetFrameStateAddresses(*GetActiveOffsets()));
+    }
+
+    // La copia del último Present, o una nueva si se quedó vieja
+    FrameState GetFrameState() {
+        FrameState state = frameState.Get();
+        if (FrameStateSampler::GetAgeMs(state) > MaxFrameStateAgeMs) {
+            state = ReadFrameStateNow();
         }
+        return state;
+    }
+
+    static int GetStatePlayerCount(const FrameState& state) {
+        return state.valid ? state.Get(FRAME_PLAYER_COUNT, 1) : 1;
+    }
 
-        int value = ReadMemoryValue<int>(gameOffsets.splitScreenEnabledOffset, 1);
-        return value > 1;
+    static bool GetStateSplitScreen(const FrameState& state) {
+        return state.valid && state.Get(FRAME_SPLIT_SCREEN_ENABLED, 1) > 1;
+    }
+
+    int ReadPlayerCount() {
+        return GetStatePlayerCount(GetFrameState());
+    }
+
+    bool ReadSplitScreenEnabled() {
+        return GetStateSplitScreen(GetFrameState());
     }
 
     bool WritePlayerCount(int count) {
-        if (!gameOffsets.valid || !gameOffsets.playerCountOffset) {
+        const std::shared_ptr<ActiveOffsets> active = GetActiveOffsets();
+        const uintptr_t address = active->fields.Get(OFFSET_PLAYER_COUNT);
+        if (!active->offsets.valid || !address) {
             return false;
         }
 
-        return WriteMemoryValue<int>(gameOffsets.playerCountOffset, count);
+        return WriteMemoryValue<int>(address, count);
     }
 
     bool WriteSplitScreenEnabled(int playerCount) {
-        if (!gameOffsets.valid || !gameOffsets.splitScreenEnabledOffset) {
+        const std::shared_ptr<ActiveOffsets> active = GetActiveOffsets();
+        const uintptr_t address = active->fields.Get(OFFSET_SPLIT_SCREEN_ENABLED);
+        if (!active->offsets.valid || !address) {
             return false;
         }
 
-        return WriteMemoryValue<int>(gameOffsets.splitScreenEnabledOffset, playerCount);
-    }
-
-    template<typename T>
-    T ReadMemoryValue(uintptr_t address, T defaultValue) {
-        T out{};
-        if (SEH_MemReadRaw(address, &out, sizeof(T))) {
-            return out;
-        }
-        else {
-            Log("Error leyendo memoria en: 0x" + ToHexString(address));
-            return defaultValue;
-        }
+        return WriteMemoryValue<int>(address, playerCount);
     }
 
     template<typename T>
@@ -448,23 +635,10 @@ private:
     }
 
     bool WriteProtectedMemory(uintptr_t address, const void* buffer, size_t size) {
-        DWORD oldProtect;
-        if (!VirtualProtect(reinterpret_cast<void*>(address), size,
-            PAGE_EXECUTE_READWRITE, &oldProtect)) {
-            Log("VirtualProtect falló para: 0x" + ToHexString(address));
-            return false;
-        }
-
-        if (!SEH_MemWriteRaw(address, buffer, size)) {
-            Log("Excepción escribiendo memoria en: 0x" + ToHexString(address));
-
-            DWORD temp;
-            VirtualProtect(reinterpret_cast<void*>(address), size, oldProtect, &temp);
+        if (!memoryWriter.Write(address, buffer, size)) {
+            Log("Fallo escribiendo memoria en: 0x" + ToHexString(address));
             return false;
         }
-
-        DWORD temp;
-        VirtualProtect(reinterpret_cast<void*>(address), size, oldProtect, &temp);
         return true;
     }
 
@@ -492,12 +666,32 @@ public:
         Log("Platform: " + PlatformToString(platform));
         Log("Game: " + GameVersionToString(currentGame));
 
+        memoryWriter.SetBackend(SEH_GetWriterBackend());
+        frameState.SetReader(&SEH_ReadSnapshotMemory, nullptr);
+
+        scanPool = std::make_unique<ScanThreadPool>();
+        ScanOptions scanOptions = HaloMCCOffsetScanner::GetScanOptions();
+        scanOptions.pool = scanPool.get();
+        HaloMCCOffsetScanner::SetScanOptions(scanOptions);
+        Log("Workers de escaneo: " + std::to_string(scanPool->GetWorkerCount()));
+
+        // Índice de regiones de todo el proceso; los scanners y las lecturas lo comparten
+        if (SEH_GetRegionIndex().Rebuild()) {
+            const std::shared_ptr<const RegionTable> regions = SEH_GetRegionTable();
+            Log("Índice de regiones: " + std::to_string(regions->GetRegions().size()) + " regiones, " +
+                std::to_string(regions->GetModules().size()) + " módulos");
+        }
+
         // Escanear offsets antes de continuar
         if (!ScanGameOffsetsOnce()) {
             Log("ADVERTENCIA: No se pudieron encontrar offsets válidos");
             Log("El mod continuará pero la funcionalidad será limitada");
         }
 
+        // Las DLL de cada juego se escanean según se cargan, sin bloquear el arranque
+        SyncTitleOffsets();
+        HaloMCCOffsetScanner::StartTitleWatcher(static_cast<uint32_t>(platform), &UWPSplitScreenMod::TitleOffsetsChanged);
+
         MH_STATUS st = MH_Initialize();
         if (st != MH_OK && st != MH_ERROR_ALREADY_INITIALIZED) {
             Log("MH_Initialize failed: " + MhStatusToStr(st));
@@ -526,10 +720,20 @@ public:
 
         stopThreads.store(true);
 
+        HaloMCCOffsetScanner::StopTitleWatcher();
+
         if (hookThread.joinable()) hookThread.join();
         if (controllerWatchThread.joinable()) controllerWatchThread.join();
         if (cameraUpdateThread.joinable()) cameraUpdateThread.join();
         if (hotkeyThread.joinable()) hotkeyThread.join();
+        // Un volcado a medias mira stopThreads entre bloques: se corta y borra su temporal
+        if (dumpThread.joinable()) dumpThread.join();
+
+        // Ya no queda ningún escaneo: el scanner vuelve a crear su pool si se reinicia
+        ScanOptions scanOptions = HaloMCCOffsetScanner::GetScanOptions();
+        scanOptions.pool = nullptr;
+        HaloMCCOffsetScanner::SetScanOptions(scanOptions);
+        scanPool.reset();
 
         MH_DisableHook(MH_ALL_HOOKS);
         MH_Uninitialize();
@@ -542,6 +746,9 @@ public:
 
         initialized.store(false);
         Log("Cleanup: completado");
+
+        // Lo que quede en la cola se escribe antes de descargar el DLL
+        AsyncLogger::Get().Stop();
     }
 
     // ========================================
@@ -549,7 +756,7 @@ public:
     // ========================================
 
     void ToggleSplitScreen() {
-        if (!gameOffsets.valid) {
+        if (!GetActiveOffsets()->offsets.valid) {
             Log("No se puede cambiar split-screen - no hay offsets válidos");
             return;
         }
@@ -574,8 +781,10 @@ public:
         }
 
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        bool newState = ReadSplitScreenEnabled();
-        int newCount = ReadPlayerCount();
+        // Muestreo nuevo: la copia de antes de escribir no sirve para comprobarlo
+        const FrameState after = ReadFrameStateNow();
+        bool newState = GetStateSplitScreen(after);
+        int newCount = GetStatePlayerCount(after);
 
         Log("Nuevo estado - Jugadores: " + std::to_string(newCount) +
             ", Split-screen: " + (newState ? "ON" : "OFF"));
@@ -590,7 +799,7 @@ public:
     }
 
     void TestOffsets() {
-        if (!gameOffsets.valid) {
+        if (!GetActiveOffsets()->offsets.valid) {
             Log("=== TEST DE OFFSETS - SIN OFFSETS VÁLIDOS ===");
             return;
         }
@@ -631,7 +840,8 @@ public:
     }
 
     void ExportOffsets() {
-        if (!gameOffsets.valid) {
+        const GameOffsets offsets = GetActiveOffsets()->offsets;
+        if (!offsets.valid) {
             Log("No hay offsets válidos para exportar");
             return;
         }
@@ -655,18 +865,18 @@ public:
 
         exportFile << "// Offsets absolutos (para código C++):\n";
         exportFile << std::hex << std::uppercase;
-        exportFile << "playerCountOffset = 0x" << gameOffsets.playerCountOffset << ";\n";
-        exportFile << "splitScreenEnabledOffset = 0x" << gameOffsets.splitScreenEnabledOffset << ";\n";
-        exportFile << "cameraBaseOffset = 0x" << gameOffsets.cameraBaseOffset << "\n\n";
+        exportFile << "playerCountOffset = 0x" << offsets.playerCountOffset << ";\n";
+        exportFile << "splitScreenEnabledOffset = 0x" << offsets.splitScreenEnabledOffset << ";\n";
+        exportFile << "cameraBaseOffset = 0x" << offsets.cameraBaseOffset << "\n\n";
 
         uintptr_t moduleBase = GetModuleBaseAddress();
         if (moduleBase) {
             exportFile << "// Offsets relativos (para Cheat Engine):\n";
             exportFile << "MCCWinStore-Win64-Shipping.exe+" << std::hex
-                << (gameOffsets.playerCountOffset - moduleBase)
+                << (offsets.playerCountOffset - moduleBase)
                 << " = Player Count\n";
             exportFile << "MCCWinStore-Win64-Shipping.exe+" << std::hex
-                << (gameOffsets.splitScreenEnabledOffset - moduleBase)
+                << (offsets.splitScreenEnabledOffset - moduleBase)
                 << " = Split Screen Flag\n\n";
         }
 
@@ -690,6 +900,7 @@ private:
             players[i].camera.position.z = -5.0f;
 
             players[i].camera.UpdateMatrices();
+            players[i].PublishCamera();
         }
         Log("Players initialized");
     }
@@ -729,15 +940,22 @@ private:
         }
         lastFrameTime = currentTime;
 
+        // Una lectura de cada campo por frame; todo lo demás usa esta copia (y los offsets
+        // con los que se leyó, aunque el watcher publique otros a mitad de frame)
+        const std::shared_ptr<ActiveOffsets> active = GetActiveOffsets();
+        const FrameState state = frameState.Sample(fc, GetFrameStateAddresses(*active));
+
         if (fc % 300 == 0) {
-            Log("Frame " + std::to_string(fc) + " | FPS: " + std::to_string(1.0f / deltaTime));
+            Log("Frame " + std::to_string(fc) + " | FPS: " + std::to_string(1.0f / deltaTime.load()));
 
-            if (gameOffsets.valid) {
-                int players = GetCurrentPlayerCount();
-                bool splitEnabled = IsSplitScreenCurrentlyEnabled();
+            if (state.valid) {
+                int players = GetStatePlayerCount(state);
+                bool splitEnabled = GetStateSplitScreen(state);
 
                 Log("Estado juego - Jugadores: " + std::to_string(players) +
-                    " | Split: " + (splitEnabled ? "ON" : "OFF"));
+                    " | Split: " + (splitEnabled ? "ON" : "OFF") +
+                    " | Menú: " + std::to_string(state.Get(FRAME_MENU_STATE, 0)) +
+                    " | Juego: " + std::to_string(state.Get(FRAME_GAME_STATE, 0)));
 
                 lastKnownPlayerCount = players;
                 lastKnownSplitScreenState = splitEnabled;
@@ -746,20 +964,20 @@ private:
 
         bool shouldRenderSplitScreen = false;
 
-        if (gameOffsets.valid && !renderingInProgress.exchange(true)) {
-            int currentPlayers = GetCurrentPlayerCount();
-            bool gameHasSplitScreen = IsSplitScreenCurrentlyEnabled();
+        if (state.valid && !renderingInProgress.exchange(true)) {
+            int currentPlayers = GetStatePlayerCount(state);
+            bool gameHasSplitScreen = GetStateSplitScreen(state);
 
             shouldRenderSplitScreen = gameHasSplitScreen && currentPlayers > 1;
             splitScreenActive.store(shouldRenderSplitScreen);
         }
-        else if (!gameOffsets.valid && !renderingInProgress.exchange(true)) {
+        else if (!state.valid && !renderingInProgress.exchange(true)) {
             shouldRenderSplitScreen = splitScreenActive.load();
         }
 
         if (shouldRenderSplitScreen) {
             try {
-                RenderSplitScreen(pSwapChain);
+                RenderSplitScreen(pSwapChain, state, active->offsets);
             }
             catch (...) {
                 Log("Excepción en RenderSplitScreen");
@@ -822,7 +1040,8 @@ private:
 
         for (int i = 0; i < numPlayers; ++i) {
             if (players[i].controllerIndex == (int)dwUserIndex && result == ERROR_SUCCESS) {
-                players[i].lastInput = *pState;
+                // Si otro hilo está publicando la de este jugador se pierde esta muestra
+                players[i].lastInput.TryStore(*pState);
                 break;
             }
         }
@@ -834,40 +1053,46 @@ private:
     // RENDERIZADO SIMPLIFICADO
     // ========================================
 
-    void RenderSplitScreen(IDXGISwapChain* pSwapChain) {
+    void RenderSplitScreen(IDXGISwapChain* pSwapChain, const FrameState& state, const GameOffsets& offsets) {
         // Implementación simplificada para evitar errores complejos
         // Solo modifica las cámaras directamente en memoria del juego
         for (int i = 0; i < numPlayers; ++i) {
             if (players[i].active) {
-                InjectPlayerCamera(i);
+                InjectPlayerCamera(i, state.cameraBase, offsets);
             }
         }
+
+        // Todas las cámaras del frame de una vez
+        uintptr_t firstFailed = 0;
+        const size_t failed = memoryWriter.Flush(&firstFailed);
+        if (failed) {
+            Log("Fallaron " + std::to_string(failed) + " escrituras de cámara (primera: 0x" + ToHexString(firstFailed) + ")");
+        }
     }
 
-    void InjectPlayerCamera(int playerIndex) {
-        if (!gameOffsets.valid || !gameOffsets.cameraBaseOffset) {
+    void InjectPlayerCamera(int playerIndex, uintptr_t cameraBase, const GameOffsets& offsets) {
+        // Con cadena de punteros, 0 hasta que resuelva (p.ej. en menús)
+        if (!offsets.valid || !cameraBase) {
             return;
         }
 
-        PlayerState& player = players[playerIndex];
-        player.camera.UpdateMatrices();
-
-        uintptr_t cameraBase = gameOffsets.cameraBaseOffset;
+        // Última cámara entera que publicó CameraUpdateLoop; no espera ni reintenta
+        const RenderCamera& camera = players[playerIndex].renderCamera.Read();
 
         try {
-            if (gameOffsets.viewMatrixOffset) {
-                uintptr_t viewMatrixAddr = cameraBase + gameOffsets.viewMatrixOffset;
-                WriteProtectedMemory(viewMatrixAddr, &player.camera.viewMatrix, sizeof(XMMATRIX));
+            if (offsets.viewMatrixOffset) {
+                uintptr_t viewMatrixAddr = cameraBase + offsets.viewMatrixOffset;
+                memoryWriter.Queue(viewMatrixAddr, &camera.viewMatrix, sizeof(XMMATRIX));
             }
 
-            if (gameOffsets.projMatrixOffset) {
-                uintptr_t projMatrixAddr = cameraBase + gameOffsets.projMatrixOffset;
-                WriteProtectedMemory(projMatrixAddr, &player.camera.projMatrix, sizeof(XMMATRIX));
+            if (offsets.projMatrixOffset) {
+                uintptr_t projMatrixAddr = cameraBase + offsets.projMatrixOffset;
+                memoryWriter.Queue(projMatrixAddr, &camera.projMatrix, sizeof(XMMATRIX));
             }
 
-            if (gameOffsets.positionOffset) {
-                uintptr_t positionAddr = cameraBase + gameOffsets.positionOffset;
-                WriteProtectedMemory(positionAddr, &player.camera.position, sizeof(XMFLOAT3));
+            if (offsets.positionOffset) {
+                uintptr_t positionAddr = cameraBase + offsets.positionOffset;
+                memoryWriter.Queue(positionAddr, &camera.position, sizeof(XMFLOAT3));
             }
         }
         catch (...) {
@@ -930,6 +1155,11 @@ private:
         Log("CameraUpdateLoop: started");
 
         while (!stopThreads.load()) {
+            // Las cadenas de punteros se revalidan aquí y no en cada lectura
+            const std::shared_ptr<ActiveOffsets> active = GetActiveOffsets();
+            active->fields.Poll();
+            active->fields.Refresh();
+
             UpdatePlayerCameras();
             std::this_thread::sleep_for(std::chrono::milliseconds(16)); // ~60 FPS
         }
@@ -942,15 +1172,80 @@ private:
         Log("Hotkeys disponibles:");
         Log("  F9 - Toggle Split-Screen");
         Log("  F10 - Test Offsets");
-        Log("  F11 - Export Offsets");
+        Log("  F11 - Export Offsets | Ctrl+F11 - Volcado del proceso (halo_pointer_scan)");
         Log("  F12 - Rescan Offsets");
-
+        Log("  F5 - Nueva búsqueda de valor (int32) | Ctrl+0..4 - Igual a N");
+        Log("  F6 - Cambió | F7 - No cambió | F8 - Aumentó | Shift+F8 - Disminuyó");
+        Log("  Ctrl+F5 - Cadenas de punteros hacia los candidatos de la búsqueda");
+
+        bool f5Pressed = false;
+        bool f6Pressed = false;
+        bool f7Pressed = false;
+        bool f8Pressed = false;
+        std::array<bool, 5> digitPressed = {};
         bool f9Pressed = false;
         bool f10Pressed = false;
         bool f11Pressed = false;
         bool f12Pressed = false;
 
         while (!stopThreads.load()) {
+            const bool ctrl = (GetAsyncKeyState(VK_CONTROL) & 0x8000) != 0;
+
+            // F5-F8 y Ctrl+N para la búsqueda de valores
+            if (GetAsyncKeyState(VK_F5) & 0x8000) {
+                if (!f5Pressed) {
+                    f5Pressed = true;
+                    if (ctrl) ScanPointersToCandidates();
+                    else StartMemorySearch();
+                }
+            }
+            else {
+                f5Pressed = false;
+            }
+
+            if (GetAsyncKeyState(VK_F6) & 0x8000) {
+                if (!f6Pressed) {
+                    f6Pressed = true;
+                    FilterMemorySearch(SnapshotPredicate::CHANGED, 0);
+                }
+            }
+            else {
+                f6Pressed = false;
+            }
+
+            if (GetAsyncKeyState(VK_F7) & 0x8000) {
+                if (!f7Pressed) {
+                    f7Pressed = true;
+                    FilterMemorySearch(SnapshotPredicate::UNCHANGED, 0);
+                }
+            }
+            else {
+                f7Pressed = false;
+            }
+
+            if (GetAsyncKeyState(VK_F8) & 0x8000) {
+                if (!f8Pressed) {
+                    f8Pressed = true;
+                    const bool shift = (GetAsyncKeyState(VK_SHIFT) & 0x8000) != 0;
+                    FilterMemorySearch(shift ? SnapshotPredicate::DECREASED : SnapshotPredicate::INCREASED, 0);
+                }
+            }
+            else {
+                f8Pressed = false;
+            }
+
+            for (size_t digit = 0; digit < digitPressed.size(); ++digit) {
+                if (ctrl && (GetAsyncKeyState('0' + static_cast<int>(digit)) & 0x8000)) {
+                    if (!digitPressed[digit]) {
+                        digitPressed[digit] = true;
+                        FilterMemorySearch(SnapshotPredicate::EQUALS, static_cast<uint32_t>(digit));
+                    }
+                }
+                else {
+                    digitPressed[digit] = false;
+                }
+            }
+
             // F9 para toggle split-screen
             if (GetAsyncKeyState(VK_F9) & 0x8000) {
                 if (!f9Pressed) {
@@ -979,8 +1274,14 @@ private:
             if (GetAsyncKeyState(VK_F11) & 0x8000) {
                 if (!f11Pressed) {
                     f11Pressed = true;
-                    Log("F11 pressed - exporting offsets");
-                    ExportOffsets();
+                    if (ctrl) {
+                        Log("Ctrl+F11 pressed - dumping process");
+                        StartProcessDump();
+                    }
+                    else {
+                        Log("F11 pressed - exporting offsets");
+                        ExportOffsets();
+                    }
                 }
             }
             else {
@@ -1008,15 +1309,193 @@ private:
     void RescanOffsets() {
         Log("=== RESCAN DE OFFSETS ===");
 
+        // Los offsets actuales siguen valiendo hasta que el re-escaneo (incremental: solo las
+        // páginas que cambiaron) los sustituya
         offsetsScanned = false;
-        gameOffsets = GameOffsets{};
 
-        if (ScanGameOffsetsOnce()) {
+        if (ScanGameOffsetsOnce(true)) {
             Log("✓ Rescan exitoso");
         }
         else {
             Log("✗ Rescan falló");
         }
+        SyncTitleOffsets();
+    }
+
+    // ========================================
+    // BÚSQUEDA DE VALORES EN MEMORIA
+    // ========================================
+
+    // Primera búsqueda con valor desconocido: foto de todas las regiones escribibles
+    void StartMemorySearch() {
+        Log("=== NUEVA BÚSQUEDA DE VALOR (int32) ===");
+
+        std::vector<SnapshotRange> ranges;
+        SEH_CollectWritableRanges(ranges);
+
+        size_t totalBytes = 0;
+        for (const SnapshotRange& range : ranges) totalBytes += range.size;
+        Log("  Regiones escribibles: " + std::to_string(ranges.size()) + " (" +
+            std::to_string(totalBytes / (1024 * 1024)) + " MB)");
+
+        const auto start = std::chrono::steady_clock::now();
+        if (!memorySearch.Start(ranges, SnapshotValueType::I32, &SEH_ReadSnapshotMemory, nullptr, scanPool.get())) {
+            Log("✗ No cabe en el presupuesto de memoria; empieza con Ctrl+N (igual a N)");
+            return;
+        }
+        LogMemorySearch(start);
+    }
+
+    // Siguiente búsqueda. Ctrl+N sin búsqueda activa empieza una con 'igual a N'
+    void FilterMemorySearch(SnapshotPredicate predicate, uint32_t value) {
+        const auto start = std::chrono::steady_clock::now();
+
+        if (!memorySearch.IsActive()) {
+            if (predicate != SnapshotPredicate::EQUALS) {
+                Log("⚠ No hay búsqueda activa (F5 para empezar)");
+                return;
+            }
+
+            Log("=== NUEVA BÚSQUEDA: igual a " + std::to_string(value) + " ===");
+            std::vector<SnapshotRange> ranges;
+            SEH_CollectWritableRanges(ranges);
+            if (!memorySearch.StartEquals(ranges, SnapshotValueType::I32, value, &SEH_ReadSnapshotMemory, nullptr, scanPool.get())) {
+                Log("✗ Búsqueda fallida (presupuesto de memoria)");
+                return;
+            }
+            LogMemorySearch(start);
+            return;
+        }
+
+        std::string description = MemorySnapshot::PredicateToString(predicate);
+        if (predicate == SnapshotPredicate::EQUALS) description += " " + std::to_string(value);
+        Log("→ Filtro: " + description);
+
+        if (!memorySearch.Filter(predicate, value, scanPool.get())) {
+            Log("✗ Filtro fallido");
+            return;
+        }
+        LogMemorySearch(start);
+    }
+
+    void LogMemorySearch(std::chrono::steady_clock::time_point start) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        const size_t count = memorySearch.GetCandidateCount();
+        Log("  Candidatos: " + std::to_string(count) + " (" +
+            std::to_string(memorySearch.GetMemoryUsage() / (1024 * 1024)) + " MB, " + std::to_string(elapsed) + " ms)");
+
+        const size_t maxListed = 50;
+        if (count == 0 || count > maxListed) return;
+
+        std::vector<SnapshotCandidate> candidates;
+        memorySearch.GetCandidates(maxListed, candidates);
+
+        uintptr_t moduleBase = reinterpret_cast<uintptr_t>(GetModuleHandleA(nullptr));
+        MODULEINFO info = {};
+        GetModuleInformation(GetCurrentProcess(), GetModuleHandleA(nullptr), &info, sizeof(info));
+
+        for (const SnapshotCandidate& candidate : candidates) {
+            std::stringstream line;
+            line << "    0x" << std::hex << std::uppercase << candidate.address;
+            if (candidate.address >= moduleBase && candidate.address < moduleBase + info.SizeOfImage) {
+                line << " (exe+0x" << (candidate.address - moduleBase) << ")";
+            }
+            line << std::dec << " = " << static_cast<int32_t>(candidate.value);
+            Log(line.str());
+        }
+    }
+
+    // ========================================
+    // CADENAS DE PUNTEROS
+    // ========================================
+
+    // Regiones + módulos del proceso vivo (leídos bajo SEH), sacados del índice de regiones.
+    // Los módulos llevan su identidad para que halo_pointer_scan pueda guardar en el perfil
+    void CollectProcessMemory(ProcessMemory& memory) {
+        memory.Clear();
+        SEH_CollectProcessRegions(memory, true);
+        memory.Finalize();
+    }
+
+    // Cadenas módulo+rva -> ... hacia los candidatos de la búsqueda de valores (pocos: cada
+    // objetivo es una búsqueda entera). Para cadenas estables: Ctrl+F11 en dos partidas y
+    // halo_pointer_scan --verify
+    void ScanPointersToCandidates() {
+        Log("=== CADENAS DE PUNTEROS ===");
+
+        const size_t maxTargets = 4;
+        std::vector<SnapshotCandidate> candidates;
+        if (memorySearch.IsActive()) memorySearch.GetCandidates(maxTargets + 1, candidates);
+        if (candidates.empty() || candidates.size() > maxTargets) {
+            Log("⚠ Hacen falta entre 1 y " + std::to_string(maxTargets) + " candidatos de la búsqueda (F5-F8)");
+            return;
+        }
+
+        ProcessMemory memory;
+        CollectProcessMemory(memory);
+
+        const auto start = std::chrono::steady_clock::now();
+        PointerMap map;
+        if (!map.Build(memory, scanPool.get())) {
+            Log("✗ Demasiados punteros para el mapa");
+            return;
+        }
+        Log("  Mapa de punteros: " + std::to_string(map.GetCount()) + " punteros (" +
+            std::to_string(map.GetMemoryUsage() / (1024 * 1024)) + " MB, " +
+            std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count()) + " ms)");
+
+        PointerScanOptions options;
+        options.maxResults = 10;
+        options.pool = scanPool.get();
+        for (const SnapshotCandidate& candidate : candidates) {
+            std::vector<PointerPath> paths;
+            PointerScanner::Scan(memory, map, candidate.address, options, paths);
+
+            std::stringstream header;
+            header << "→ 0x" << std::hex << std::uppercase << candidate.address << std::dec << ": " << paths.size() << " cadenas";
+            Log(header.str());
+            for (const PointerPath& path : paths) Log("    " + path.ToString());
+        }
+    }
+
+    // El volcado en segundo plano: el resto de hotkeys siguen funcionando mientras se escribe
+    void StartProcessDump() {
+        bool expected = false;
+        if (!dumpInProgress.compare_exchange_strong(expected, true)) {
+            Log("⚠ Ya hay un volcado en curso");
+            return;
+        }
+
+        if (dumpThread.joinable()) dumpThread.join();   // el anterior ya terminó
+        dumpThread = std::thread([this]() {
+            DumpProcess();
+            dumpInProgress.store(false);
+        });
+    }
+
+    // Volcado para halo_pointer_scan (y para diagnosticar offsets rotos en otra máquina)
+    void DumpProcess() {
+        const std::string cachePath = HaloMCCOffsetScanner::GetCachePath();
+        const size_t slash = cachePath.find_last_of("\\/");
+        const std::string dumpPath = (slash == std::string::npos ? std::string() : cachePath.substr(0, slash + 1)) +
+            "HaloMCC_ProcessDump.hmcd";
+
+        ProcessMemory memory;
+        CollectProcessMemory(memory);
+        Log("Volcando " + std::to_string(memory.GetRegions().size()) + " regiones (" +
+            std::to_string(memory.GetTotalSize() / (1024 * 1024)) + " MB) en " + dumpPath);
+
+        if (memory.SaveDump(dumpPath, &stopThreads)) {
+            Log("✓ Volcado escrito");
+        }
+        else if (stopThreads.load()) {
+            Log("⚠ Volcado cancelado (descargando el mod)");
+        }
+        else {
+            Log("✗ No se pudo escribir el volcado");
+        }
     }
 
     // ========================================
@@ -1231,14 +1710,16 @@ private:
     }
 
     void UpdatePlayerCameras() {
+        const float dt = deltaTime.load();
+
         for (int i = 0; i < numPlayers; ++i) {
             if (!players[i].active) continue;
 
             PlayerState& player = players[i];
-            XINPUT_STATE& input = player.lastInput;
+            const XINPUT_STATE input = player.lastInput.Load();
 
-            float moveSpeed = player.movementSpeed * deltaTime;
-            float rotSpeed = player.rotationSpeed * deltaTime;
+            float moveSpeed = player.movementSpeed * dt;
+            float rotSpeed = player.rotationSpeed * dt;
 
             float rx = input.Gamepad.sThumbRX / 32768.0f;
             float ry = input.Gamepad.sThumbRY / 32768.0f;
@@ -1285,6 +1766,7 @@ private:
 
             if (player.camera.isDirty) {
                 UpdateCameraVectors(player.camera);
+                player.PublishCamera();
             }
         }
     }
@@ -1337,27 +1819,19 @@ private:
         return ss.str();
     }
 
-    void Log(const std::string& message) {
-        std::lock_guard<std::mutex> lock(logMutex);
-
-        if (!logFile.is_open()) {
-            logFile.open("UWPSplitScreen_Extended.log", std::ios::out | std::ios::app);
-        }
-
-        if (logFile.is_open()) {
-            auto now = std::chrono::system_clock::now();
-            auto time_t = std::chrono::system_clock::to_time_t(now);
-
-            char timeStr[100];
-            struct tm timeInfo;
-            localtime_s(&timeInfo, &time_t);
-            strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", &timeInfo);
+    static void DebugOutputSink(void*, const char* line) {
+        OutputDebugStringA(line);
+    }
 
-            logFile << "[" << timeStr << "] " << message << std::endl;
-            logFile.flush();
-        }
+    static uint16_t OpenLogChannel() {
+        AsyncLogger::Get().SetDebugSink(&DebugOutputSink, nullptr);
+        return AsyncLogger::Get().OpenChannel("UWPSplitScreen_Extended.log", "[UWP_SPLITSCREEN] ");
+    }
 
-        OutputDebugStringA(("[UWP_SPLITSCREEN] " + message + "\n").c_str());
+    // Solo encola: la fecha, el fichero y OutputDebugString los hace el hilo del logger
+    void Log(const std::string& message) {
+        static const uint16_t channel = OpenLogChannel();
+        AsyncLogger::Get().Log(channel, message);
     }
 
     std::string MhStatusToStr(MH_STATUS status) {
@@ -1475,16 +1949,6 @@ static std::string ToHexString(uintptr_t value) {
 }
 
 static void LogToFile(const std::string& message) {
-    std::ofstream logFile("HaloMCC_OffsetScanner.log", std::ios::out | std::ios::app);
-    if (logFile.is_open()) {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        char timeStr[100];
-        struct tm timeInfo;
-        localtime_s(&timeInfo, &time_t);
-        strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", &timeInfo);
-
-        logFile << "[" << timeStr << "] " << message << std::endl;
-        logFile.close();
-    }
+    static const uint16_t channel = AsyncLogger::Get().OpenChannel("HaloMCC_OffsetScanner.log");
+    AsyncLogger::Get().Log(channel, message);
 }
\ No newline at end of file
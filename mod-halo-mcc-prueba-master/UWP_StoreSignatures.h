@@ -0,0 +1,10 @@
+// UWP_StoreSignatures.h
+// Firmas de la versión Microsoft Store. Portable (sin windows.h) para poder usarlas
+// también desde tools/ (benchmark).
+#pragma once
+#include "HaloMCC_Signature.h"
+
+inline constexpr auto kD3D11DeviceSignature = MakeSignature("48 89 5C 24 ?? 57 48 83 EC ?? 48 8B FA");
+inline constexpr auto kSwapChainPresentSignature = MakeSignature("48 89 74 24 ?? 48 89 7C 24 ?? 41 56");
+inline constexpr auto kXInputSignature = MakeSignature("85 C9 0F 84 ?? ?? ?? ?? 83 F9 04");
+inline constexpr auto kGameStateSignature = MakeSignature("48 8B 0D ?? ?? ?? ?? 48 85 C9 74");
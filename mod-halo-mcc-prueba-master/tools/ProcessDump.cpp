@@ -0,0 +1,46 @@
+// ProcessDump.cpp
+#include "ProcessDump.h"
+#include "HaloMCC_Minidump.h"
+#include <cstdio>
+#include <cstring>
+
+bool ProcessDump::IsDump(const uint8_t* data, size_t size) {
+    if (Minidump::IsMinidump(data, size)) return true;
+
+    uint32_t magic = 0;
+    if (size >= sizeof(magic)) std::memcpy(&magic, data, sizeof(magic));
+    return magic == ProcessMemory::DumpMagic;
+}
+
+bool ProcessDump::Open(const std::string& path) {
+    if (!file.Open(path)) {
+        std::fprintf(stderr, "ERROR: no se pudo mapear %s\n", path.c_str());
+        return false;
+    }
+    return Open(file, path);
+}
+
+bool ProcessDump::Open(const MappedFile& mapped, const std::string& path) {
+    const bool opened = Minidump::IsMinidump(mapped.Data(), mapped.Size())
+        ? Minidump::Open(mapped.Data(), mapped.Size(), memory)
+        : memory.OpenDump(mapped.Data(), mapped.Size());
+    if (!opened) {
+        std::fprintf(stderr, "ERROR: %s no es un volcado válido (.hmcd o minidump con memoria)\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+const uint8_t* GetModuleImage(const ProcessMemory& memory, const ProcessModule& module, std::vector<uint8_t>& copy) {
+    if (const uint8_t* direct = memory.GetData(module.base, module.size)) return direct;
+
+    // Página a página: un minidump sin memoria completa deja huecos dentro de la imagen
+    const size_t pageSize = 0x1000;
+    copy.assign(module.size, 0);
+    size_t pages = 0;
+    for (size_t offset = 0; offset < module.size; offset += pageSize) {
+        const size_t length = module.size - offset < pageSize ? module.size - offset : pageSize;
+        if (memory.Read(module.base + offset, copy.data() + offset, length)) pages++;
+    }
+    return pages ? copy.data() : nullptr;
+}
@@ -0,0 +1,26 @@
+// ProcessDump.h
+// Volcados de proceso para las herramientas: el propio del DLL (.hmcd, Ctrl+F11) o un minidump
+// de Windows (.dmp). Los dos se mapean y se ven como una ProcessMemory.
+#pragma once
+#include "HaloMCC_ProcessMemory.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Volcado mapeado + vista de su memoria (la vista apunta dentro del mapeo)
+struct ProcessDump {
+    MappedFile file;
+    ProcessMemory memory;
+
+    static bool IsDump(const uint8_t* data, size_t size);
+
+    // Mensaje de error por stderr si no se puede
+    bool Open(const std::string& path);
+    // Sobre un fichero ya mapeado por quien llama
+    bool Open(const MappedFile& mapped, const std::string& path);
+};
+
+// Imagen de un módulo del volcado tal como estaba cargada (Layout::MAPPED). Directa al mapeo si
+// sus páginas van seguidas en el fichero; si no, copiada en 'copy' con las páginas que falten a cero
+const uint8_t* GetModuleImage(const ProcessMemory& memory, const ProcessModule& module, std::vector<uint8_t>& copy);
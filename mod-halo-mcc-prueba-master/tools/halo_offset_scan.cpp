@@ -0,0 +1,288 @@
+// halo_offset_scan.cpp
+// Escaneo offline de un ejecutable de MCC (copia en disco) sin inyectar nada.
+// Genera el mismo fichero de caché que escribe el DLL (HaloMCC_OffsetCache.bin), así que
+// basta con copiarlo junto al DLL para que arranque sin escanear.
+//
+// Uso: halo_offset_scan <MCC*-Win64-Shipping.exe | halo3.dll ... | volcado.dmp|.hmcd> [-o perfil.bin]
+//                       [--game h3] [--platform store] [--workers N] [--deterministic] [--xrefs indice.bin]
+//                       [--module halo3.dll]
+//
+// Con la DLL de un título (halo1.dll, halo3.dll...) se usan solo las firmas de ese título y,
+// si no se indica --game, el juego que corresponde a la DLL.
+//
+// Con un volcado (minidump de un usuario o el .hmcd de Ctrl+F11) se escanea la imagen cargada
+// del módulo indicado con --module (por defecto el ejecutable), tal cual estaba en memoria.
+//
+// --xrefs escribe también el índice de xrefs RIP-relative (HaloMCC_XrefIndex.bin) que el DLL
+// construiría en el primer arranque.
+#include "HaloMCC_OffsetProfile.h"
+#include "HaloMCC_XrefIndex.h"
+#include "MappedFile.h"
+#include "ProcessDump.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Mismo orden que GameVersion / GamePlatform en UWP_Detection.h
+const char* const kGameNames[] = { "ce", "h2", "h2a", "h3", "reach", "h4", "unknown" };
+const char* const kPlatformNames[] = { "steam", "store", "unknown" };
+const uint32_t kUnknownGame = 6;
+const uint32_t kUnknownPlatform = 2;
+
+bool ParseEnumArg(const char* value, const char* const* names, uint32_t count, uint32_t& result) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (std::strcmp(value, names[i]) == 0) {
+            result = i;
+            return true;
+        }
+    }
+
+    char* end = nullptr;
+    const unsigned long number = std::strtoul(value, &end, 10);
+    if (end == value || *end != '\0' || number >= count) return false;
+    result = static_cast<uint32_t>(number);
+    return true;
+}
+
+std::string ToLower(std::string text) {
+    for (char& c : text) c = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    return text;
+}
+
+// Plataforma a partir del nombre del ejecutable si no se indica (en los volcados el nombre
+// del módulo va en minúsculas)
+uint32_t GuessPlatform(const std::string& path) {
+    const std::string lower = ToLower(path);
+    if (lower.find("mccwinstore") != std::string::npos) return 1;
+    if (lower.find("mcc-win64") != std::string::npos) return 0;
+    return kUnknownPlatform;
+}
+
+// Módulo a escanear dentro de un volcado: el pedido o, si no, el ejecutable de MCC
+const ProcessModule* FindDumpModule(const ProcessMemory& memory, const std::string& name) {
+    if (!name.empty()) return memory.FindModuleByName(name.c_str());
+    if (const ProcessModule* module = memory.FindModuleByName("mccwinstore-win64-shipping.exe")) return module;
+    return memory.FindModuleByName("mcc-win64-shipping.exe");
+}
+
+// Nombre del fichero sin directorio, para buscar el título
+std::string GetFileName(const std::string& path) {
+    const size_t slash = path.find_last_of("\\/");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+        "Uso: %s <exe> [-o perfil.bin] [--game ce|h2|h2a|h3|reach|h4|unknown] [--platform steam|store|unknown]\n"
+        "          [--workers N] [--deterministic] [--xrefs indice.bin] [--module halo3.dll (volcados)]\n", program);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    std::string inputPath;
+    std::string outputPath = "HaloMCC_OffsetCache.bin";
+    std::string xrefPath;
+    std::string moduleName;
+    uint32_t gameVersion = kUnknownGame;
+    uint32_t gamePlatform = kUnknownPlatform;
+    bool platformGiven = false;
+    bool gameGiven = false;
+    ScanOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if ((arg == "-o" || arg == "--output") && hasValue) {
+            outputPath = argv[++i];
+        }
+        else if (arg == "--game" && hasValue) {
+            if (!ParseEnumArg(argv[++i], kGameNames, 7, gameVersion)) {
+                std::fprintf(stderr, "Juego no válido: %s\n", argv[i]);
+                return 2;
+            }
+            gameGiven = true;
+        }
+        else if (arg == "--platform" && hasValue) {
+            if (!ParseEnumArg(argv[++i], kPlatformNames, 3, gamePlatform)) {
+                std::fprintf(stderr, "Plataforma no válida: %s\n", argv[i]);
+                return 2;
+            }
+            platformGiven = true;
+        }
+        else if (arg == "--workers" && hasValue) {
+            options.workerCount = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--xrefs" && hasValue) {
+            xrefPath = argv[++i];
+        }
+        else if (arg == "--module" && hasValue) {
+            moduleName = argv[++i];
+        }
+        else if (arg == "--deterministic") {
+            options.deterministic = true;
+        }
+        else if (!arg.empty() && arg[0] != '-' && inputPath.empty()) {
+            inputPath = arg;
+        }
+        else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (inputPath.empty()) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    MappedFile file;
+    if (!file.Open(inputPath)) {
+        std::fprintf(stderr, "ERROR: no se pudo mapear %s\n", inputPath.c_str());
+        return 1;
+    }
+
+    // Fichero PE en disco o imagen cargada sacada de un volcado
+    std::string imageName = GetFileName(inputPath);
+    const uint8_t* imageData = file.Data();
+    size_t imageSize = file.Size();
+    PEImage::Layout layout = PEImage::Layout::FILE;
+    ProcessDump dump;
+    std::vector<uint8_t> imageCopy;
+    if (ProcessDump::IsDump(file.Data(), file.Size())) {
+        if (!dump.Open(file, inputPath)) return 1;
+
+        const ProcessModule* module = FindDumpModule(dump.memory, moduleName);
+        if (!module) {
+            std::fprintf(stderr, "ERROR: el volcado no tiene el módulo %s\n",
+                moduleName.empty() ? "del ejecutable de MCC (usa --module)" : moduleName.c_str());
+            return 1;
+        }
+
+        imageName = module->name;
+        imageData = GetModuleImage(dump.memory, *module, imageCopy);
+        imageSize = module->size;
+        layout = PEImage::Layout::MAPPED;
+        if (!imageData) {
+            std::fprintf(stderr, "ERROR: el volcado no tiene memoria de %s\n", imageName.c_str());
+            return 1;
+        }
+        std::printf("Volcado: %s (%zu regiones, %zu MB) -> %s en 0x%llX%s\n", inputPath.c_str(),
+            dump.memory.GetRegions().size(), dump.memory.GetTotalSize() / (1024 * 1024), imageName.c_str(),
+            static_cast<unsigned long long>(module->base), imageCopy.empty() ? "" : " (con huecos, copiada)");
+    }
+
+    if (!platformGiven) gamePlatform = GuessPlatform(imageName);
+
+    // Un nombre que no es de ningún título se trata como el ejecutable (copias renombradas)
+    const OffsetTitleInfo* titleInfo = OffsetScanCore::FindTitleByModule(imageName.c_str());
+    const uint32_t title = titleInfo ? titleInfo->title : TITLE_MCC;
+    if (titleInfo && title != TITLE_MCC && !gameGiven) gameVersion = titleInfo->gameVersion;
+
+    PEImage image;
+    if (!image.Parse(imageData, imageSize, layout)) {
+        std::fprintf(stderr, "ERROR: %s no es un PE válido\n", imageName.c_str());
+        return 1;
+    }
+
+    std::printf("Imagen: %s (%zu bytes, %s)\n", imageName.c_str(), imageSize, image.Is64Bit() ? "PE32+" : "PE32");
+    std::printf("TimeDateStamp 0x%08X  SizeOfImage 0x%08X  CheckSum 0x%08X\n",
+        image.GetTimeDateStamp(), image.GetSizeOfImage(), image.GetCheckSum());
+    for (const PESection& section : image.GetSections()) {
+        std::printf("  %-8s %-5s RVA 0x%08X tamaño 0x%08X raw 0x%08X\n", section.name,
+            PEImage::SectionKindToString(section.kind), section.virtualAddress, section.virtualSize, section.rawOffset);
+    }
+
+    std::printf("Título: %s\n", OffsetScanCore::FindTitle(title)->name);
+    const std::vector<OffsetMatch> matches = OffsetScanCore::ScanImage(image, options, title);
+
+    const std::vector<OffsetSignature>& signatures = OffsetScanCore::GetSignatures();
+    for (size_t id = 0; id < matches.size(); ++id) {
+        if (!OffsetScanCore::AppliesTo(signatures[id], title)) continue;
+
+        const OffsetMatch& match = matches[id];
+        const char* name = signatures[id].name;
+        if (match.found) {
+            std::printf("✓ %-28s sitio RVA 0x%08X -> RVA 0x%08X", name, match.siteRva, match.targetRva);
+            if (match.matchCount > 1) std::printf("  (%u matches, %u válidos)", match.matchCount, match.candidateCount);
+            std::printf("\n");
+        }
+        else if (match.ambiguous) {
+            std::printf("✗ %-28s ambigua: %u matches, %u válidos con destinos distintos\n", name,
+                match.matchCount, match.candidateCount);
+        }
+        else if (match.matchCount) {
+            std::printf("✗ %-28s %u matches, ninguno cumple las restricciones\n", name, match.matchCount);
+        }
+        else {
+            std::printf("✗ %-28s no encontrado\n", name);
+        }
+    }
+
+    // Un resultado por campo a partir de sus firmas alternativas
+    const std::vector<OffsetResolution> resolutions = OffsetScanCore::ScoreMatches(matches);
+    size_t found = 0;
+    for (const OffsetResolution& resolution : resolutions) {
+        const char* field = OffsetScanCore::FieldToString(resolution.field);
+        if (resolution.contested) {
+            std::printf("✗ %-18s firmas en conflicto (%u de acuerdo, %u en conflicto), sin resolver\n", field,
+                resolution.agreeing, resolution.conflicting);
+            continue;
+        }
+        if (!resolution.found) {
+            std::printf("→ %-18s sin resolver\n", field);
+            continue;
+        }
+        std::printf("→ %-18s RVA 0x%08X  firma '%s'  confianza %u%% (%u de acuerdo, %u en conflicto)\n", field,
+            resolution.targetRva, signatures[resolution.signatureIndex].name, resolution.confidence,
+            resolution.agreeing, resolution.conflicting);
+        found++;
+    }
+
+    if (!xrefPath.empty()) {
+        XrefIndex xrefs;
+        xrefs.Build(image);
+        std::printf("Índice de xrefs: %zu referencias RIP-relative\n", xrefs.GetCount());
+        for (const OffsetResolution& resolution : resolutions) {
+            if (!resolution.found) continue;
+            std::printf("  %-18s %zu referencias en código\n", OffsetScanCore::FieldToString(resolution.field),
+                xrefs.FindReferencesTo(resolution.targetRva).Size());
+        }
+
+        // Misma clave que usa el DLL: solo depende del ejecutable
+        if (!xrefs.Save(xrefPath, OffsetScanCore::MakeKey(image, 0, 0))) {
+            std::fprintf(stderr, "ERROR: no se pudo escribir %s\n", xrefPath.c_str());
+            return 1;
+        }
+    }
+
+    const OffsetCacheKey key = OffsetScanCore::MakeKey(image, gameVersion, gamePlatform);
+    const OffsetCacheRecord record = OffsetScanCore::BuildRecord(key, resolutions);
+    if (record.entries.empty()) {
+        std::fprintf(stderr, "ERROR: ninguna firma encontrada, no se escribe perfil\n");
+        return 1;
+    }
+
+    // Se añade al perfil existente (una entrada por ejecutable/juego/plataforma)
+    OffsetCache cache;
+    cache.Load(outputPath);
+    cache.Store(record);
+    if (!cache.Save(outputPath)) {
+        std::fprintf(stderr, "ERROR: no se pudo escribir %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    std::printf("Perfil: %s (juego %s, plataforma %s, %zu/%zu offsets, %zu registros)\n", outputPath.c_str(),
+        kGameNames[gameVersion], kPlatformNames[gamePlatform], found, resolutions.size(), cache.GetRecords().size());
+    return found == resolutions.size() ? 0 : 3;
+}
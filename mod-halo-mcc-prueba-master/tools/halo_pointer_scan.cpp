@@ -0,0 +1,251 @@
+// halo_pointer_scan.cpp
+// Búsqueda offline de cadenas de punteros sobre volcados del proceso (los que escribe el DLL
+// con Ctrl+F11 o minidumps de Windows). Los volcados se mapean, no se cargan: el mapa de
+// punteros solo toca las regiones escribibles.
+//
+// Uso: halo_pointer_scan <volcado.hmcd|.dmp> <objetivo> [--depth 4] [--max-offset 0x1000] [--max-results 50]
+//                        [--module halo3.dll]... [--workers N] [--verify otro.hmcd|.dmp objetivo]...
+//                        [--field camera|players|splitscreen -o perfil.bin [--game h3] [--platform store]]
+//
+// --verify se queda con las cadenas que en otro volcado (otra partida, otro nivel) llevan a la
+// dirección que tiene allí el mismo objeto: son las estables. Con --field la mejor cadena se
+// guarda en el perfil de offsets (HaloMCC_OffsetCache.bin), en el registro del módulo en el
+// que empieza, y el DLL la usa en lugar de la dirección estática del campo.
+#include "HaloMCC_OffsetProfile.h"
+#include "HaloMCC_PointerScan.h"
+#include "HaloMCC_ProcessMemory.h"
+#include "HaloMCC_ThreadPool.h"
+#include "ProcessDump.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace {
+
+// Mismo orden que GameVersion / GamePlatform en UWP_Detection.h
+const char* const kGameNames[] = { "ce", "h2", "h2a", "h3", "reach", "h4", "unknown" };
+const char* const kPlatformNames[] = { "steam", "store", "unknown" };
+const char* const kFieldNames[] = { "splitscreen", "players", "camera" };
+const uint32_t kUnknownGame = 6;
+const uint32_t kUnknownPlatform = 2;
+
+bool ParseEnumArg(const char* value, const char* const* names, uint32_t count, uint32_t& result) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (std::strcmp(value, names[i]) == 0) {
+            result = i;
+            return true;
+        }
+    }
+
+    char* end = nullptr;
+    const unsigned long number = std::strtoul(value, &end, 10);
+    if (end == value || *end != '\0' || number >= count) return false;
+    result = static_cast<uint32_t>(number);
+    return true;
+}
+
+bool ParseAddress(const char* text, uintptr_t& address) {
+    char* end = nullptr;
+    const unsigned long long value = std::strtoull(text, &end, 16);
+    if (end == text || *end != '\0') return false;
+    address = static_cast<uintptr_t>(value);
+    return true;
+}
+
+// Plataforma a partir del ejecutable que aparece en el volcado
+uint32_t GuessPlatform(const ProcessMemory& memory) {
+    if (memory.FindModuleByName("mccwinstore-win64-shipping.exe")) return 1;
+    if (memory.FindModuleByName("mcc-win64-shipping.exe")) return 0;
+    return kUnknownPlatform;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+        "Uso: %s <volcado.hmcd|.dmp> <objetivo> [--depth 4] [--max-offset 0x1000] [--max-results 50]\n"
+        "          [--module halo3.dll]... [--workers N] [--verify otro.hmcd|.dmp objetivo]...\n"
+        "          [--field camera|players|splitscreen -o perfil.bin [--game h3] [--platform store]]\n", program);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string dumpPath;
+    std::string targetText;
+    std::string outputPath = "HaloMCC_OffsetCache.bin";
+    std::vector<std::pair<std::string, std::string>> verify;
+    uint32_t field = 0;
+    bool fieldGiven = false;
+    uint32_t gameVersion = kUnknownGame;
+    uint32_t gamePlatform = kUnknownPlatform;
+    bool gameGiven = false;
+    bool platformGiven = false;
+    unsigned workers = 0;
+    PointerScanOptions options;
+    options.maxResults = 50;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--depth" && hasValue) {
+            options.maxDepth = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            if (options.maxDepth == 0 || options.maxDepth > OffsetCachePointerPath::MaxDepth) {
+                std::fprintf(stderr, "Profundidad no válida (1-%zu)\n", OffsetCachePointerPath::MaxDepth);
+                return 2;
+            }
+        }
+        else if (arg == "--max-offset" && hasValue) {
+            options.maxOffset = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 16));
+        }
+        else if (arg == "--max-results" && hasValue) {
+            options.maxResults = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--module" && hasValue) {
+            std::string name = argv[++i];
+            for (char& c : name) c = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+            options.modules.push_back(name);
+        }
+        else if (arg == "--workers" && hasValue) {
+            workers = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--verify" && i + 2 < argc) {
+            verify.emplace_back(argv[i + 1], argv[i + 2]);
+            i += 2;
+        }
+        else if (arg == "--field" && hasValue) {
+            if (!ParseEnumArg(argv[++i], kFieldNames, 3, field)) {
+                std::fprintf(stderr, "Campo no válido: %s\n", argv[i]);
+                return 2;
+            }
+            field += OFFSET_SPLIT_SCREEN_ENABLED;
+            fieldGiven = true;
+        }
+        else if ((arg == "-o" || arg == "--output") && hasValue) {
+            outputPath = argv[++i];
+        }
+        else if (arg == "--game" && hasValue) {
+            if (!ParseEnumArg(argv[++i], kGameNames, 7, gameVersion)) {
+                std::fprintf(stderr, "Juego no válido: %s\n", argv[i]);
+                return 2;
+            }
+            gameGiven = true;
+        }
+        else if (arg == "--platform" && hasValue) {
+            if (!ParseEnumArg(argv[++i], kPlatformNames, 3, gamePlatform)) {
+                std::fprintf(stderr, "Plataforma no válida: %s\n", argv[i]);
+                return 2;
+            }
+            platformGiven = true;
+        }
+        else if (!arg.empty() && arg[0] != '-' && dumpPath.empty()) {
+            dumpPath = arg;
+        }
+        else if (!arg.empty() && arg[0] != '-' && targetText.empty()) {
+            targetText = arg;
+        }
+        else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    ProcessDump dump;
+    uintptr_t target = 0;
+    if (dumpPath.empty() || !ParseAddress(targetText.c_str(), target)) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    if (!dump.Open(dumpPath)) return 1;
+
+    const ProcessMemory& memory = dump.memory;
+    std::printf("Volcado: %s (%zu regiones, %zu MB, %zu módulos)\n", dumpPath.c_str(), memory.GetRegions().size(),
+        memory.GetTotalSize() / (1024 * 1024), memory.GetModules().size());
+    if (!memory.FindRegion(target)) {
+        std::fprintf(stderr, "ERROR: 0x%llX no está en ninguna región del volcado\n",
+            static_cast<unsigned long long>(target));
+        return 1;
+    }
+
+    ScanThreadPool pool(workers);
+    options.pool = &pool;
+
+    auto start = std::chrono::steady_clock::now();
+    PointerMap map;
+    if (!map.Build(memory, &pool)) {
+        std::fprintf(stderr, "ERROR: demasiados punteros para el mapa\n");
+        return 1;
+    }
+    std::printf("Mapa de punteros: %zu punteros (%zu MB) en %.2f s con %u workers\n", map.GetCount(),
+        map.GetMemoryUsage() / (1024 * 1024), SecondsSince(start), pool.GetWorkerCount());
+
+    start = std::chrono::steady_clock::now();
+    std::vector<PointerPath> paths;
+    PointerScanner::Scan(memory, map, target, options, paths);
+    std::printf("Cadenas hacia 0x%llX (profundidad <= %u, offset <= 0x%X): %zu en %.2f s\n",
+        static_cast<unsigned long long>(target), options.maxDepth, options.maxOffset, paths.size(),
+        SecondsSince(start));
+
+    for (const auto& other : verify) {
+        ProcessDump verifyDump;
+        uintptr_t verifyTarget = 0;
+        if (!ParseAddress(other.second.c_str(), verifyTarget)) {
+            std::fprintf(stderr, "Objetivo no válido: %s\n", other.second.c_str());
+            return 2;
+        }
+        if (!verifyDump.Open(other.first)) return 1;
+
+        const size_t before = paths.size();
+        PointerScanner::Filter(verifyDump.memory, verifyTarget, paths);
+        std::printf("→ Verificadas contra %s (0x%llX): %zu de %zu siguen valiendo\n", other.first.c_str(),
+            static_cast<unsigned long long>(verifyTarget), paths.size(), before);
+    }
+
+    for (const PointerPath& path : paths) std::printf("  %s\n", path.ToString().c_str());
+    if (paths.empty()) {
+        std::fprintf(stderr, "✗ Ninguna cadena\n");
+        return 3;
+    }
+    if (!fieldGiven) return 0;
+
+    // La mejor (la primera) va al registro de su módulo
+    const PointerPath& best = paths.front();
+    const ProcessModule* module = memory.FindModuleByName(best.module.c_str());
+    const OffsetTitleInfo* titleInfo = OffsetScanCore::FindTitleByModule(best.module.c_str());
+    if (!gameGiven && titleInfo && titleInfo->title != TITLE_MCC) gameVersion = titleInfo->gameVersion;
+    if (!platformGiven) gamePlatform = GuessPlatform(memory);
+
+    OffsetCacheKey key;
+    key.timeDateStamp = module->timeDateStamp;
+    key.sizeOfImage = module->sizeOfImage;
+    key.checkSum = module->checkSum;
+    key.gameVersion = gameVersion;
+    key.gamePlatform = gamePlatform;
+
+    OffsetCache cache;
+    cache.Load(outputPath);
+    OffsetCacheRecord record;
+    record.key = key;
+    if (const OffsetCacheRecord* existing = cache.Find(key)) record = *existing;
+
+    OffsetCachePointerPath stored;
+    stored.field = field;
+    stored.baseRva = best.baseRva;
+    stored.offsets = best.offsets;
+    record.SetPointerPath(stored);
+    cache.Store(record);
+
+    if (!cache.Save(outputPath)) {
+        std::fprintf(stderr, "ERROR: no se pudo escribir %s\n", outputPath.c_str());
+        return 1;
+    }
+    std::printf("Perfil: %s (%s = %s, juego %s, plataforma %s)\n", outputPath.c_str(),
+        OffsetScanCore::FieldToString(field), best.ToString().c_str(), kGameNames[gameVersion], kPlatformNames[gamePlatform]);
+    return 0;
+}
@@ -0,0 +1,478 @@
+// halo_scan_bench.cpp
+// Benchmark del escaneo de firmas sobre imágenes sintéticas (64 MB / 256 MB / 1 GB).
+// Mide las mismas rutas que usa el DLL:
+//   offsets      -> firmas de HaloMCCOffsetScanner, multi-patrón + chunks en paralelo
+//   store        -> firmas de UWPMemoryScanner::FindPatterns, multi-patrón + chunks en paralelo
+//   store-single -> UWPMemoryScanner::FindPatternInRange, un PatternScanner::FindFirst por firma
+//   page-hash    -> CRC32C por página (PageHashSet) del re-escaneo incremental; "matches/s" son páginas/s
+//   snapshot     -> MemorySnapshot: "cambió" sobre una foto de toda la imagen (int32); "matches/s" son
+//                   candidatos restantes/s
+//
+// Cada imagen lleva las firmas reales plantadas al final y near-misses (firma con un byte
+// fijo cambiado) repartidos por todo el buffer. "sparse" = bytes de ancla casi ausentes,
+// "dense" = bytes de ancla muy frecuentes (código real), que es lo que castiga la verificación.
+//
+// Uso: halo_scan_bench [--sizes 64,256,1024] [--repeat 3] [--workers N]
+//                      [--backend scalar|sse2|avx2] [--path offsets|offsets-enum|store|store-single|page-hash|snapshot|all]
+#include "HaloMCC_MemorySnapshot.h"
+#include "HaloMCC_OffsetProfile.h"
+#include "HaloMCC_ThreadPool.h"
+#include "UWP_StoreSignatures.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Contador de asignaciones (operator new global)
+// ============================================================================
+
+namespace {
+std::atomic<uint64_t> g_allocCount{ 0 };
+std::atomic<uint64_t> g_allocBytes{ 0 };
+}
+
+void* operator new(size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+// ============================================================================
+// Imagen sintética
+// ============================================================================
+
+struct XorShift {
+    uint64_t state;
+    uint64_t Next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+enum class AnchorDensity { SPARSE, DENSE };
+
+const char* DensityToString(AnchorDensity density) {
+    return density == AnchorDensity::SPARSE ? "sparse" : "dense";
+}
+
+// SINGLE = FindFirst por firma, MULTI = FindFirstAll, ENUMERATE = FindAll (todos los matches)
+enum class PathMode { SINGLE, MULTI, ENUMERATE };
+
+struct BenchPath {
+    const char* name;
+    std::vector<PreparedPattern> patterns;
+    PathMode mode;
+    size_t plantedFrom;     // ruta cuyas firmas plantadas comparte (las mismas firmas solo se plantan una vez)
+};
+
+// Bytes de ancla de todas las firmas: los que el filtro SIMD busca
+std::vector<uint8_t> CollectAnchorBytes(const std::vector<BenchPath>& paths) {
+    bool seen[256] = {};
+    std::vector<uint8_t> anchors;
+    for (const BenchPath& path : paths) {
+        for (const PreparedPattern& pattern : path.patterns) {
+            const uint8_t values[2] = { pattern.anchorByte, pattern.anchor2Byte };
+            for (uint8_t value : values) {
+                if (!seen[value]) {
+                    seen[value] = true;
+                    anchors.push_back(value);
+                }
+            }
+        }
+    }
+    return anchors;
+}
+
+void WritePattern(uint8_t* dest, const PatternView& view, XorShift& rng) {
+    for (size_t i = 0; i < view.length; ++i) {
+        dest[i] = view.mask[i] ? view.bytes[i] : static_cast<uint8_t>(rng.Next());
+    }
+}
+
+// Near-miss: la firma entera salvo el último byte fijo que no sea ancla (pasa el filtro SIMD
+// y obliga a verificar casi toda la firma)
+void WriteNearMiss(uint8_t* dest, const PreparedPattern& pattern, XorShift& rng) {
+    WritePattern(dest, pattern.view, rng);
+    for (size_t i = pattern.view.length; i-- > 0;) {
+        if (pattern.view.mask[i] && i != pattern.anchorIndex && i != pattern.anchor2Index) {
+            dest[i] = static_cast<uint8_t>(pattern.view.bytes[i] ^ 0xA5);
+            return;
+        }
+    }
+}
+
+// Rellena el buffer y devuelve, por ruta y firma, el offset donde se plantó
+std::vector<std::vector<size_t>> BuildImage(std::vector<uint8_t>& image, AnchorDensity density,
+                                            const std::vector<BenchPath>& paths) {
+    XorShift rng{ 0x9E3779B97F4A7C15ull ^ image.size() ^ static_cast<uint64_t>(density) };
+    const std::vector<uint8_t> anchors = CollectAnchorBytes(paths);
+
+    bool isAnchor[256] = {};
+    for (uint8_t value : anchors) isAnchor[value] = true;
+
+    for (size_t i = 0; i < image.size(); i += 8) {
+        uint64_t word = rng.Next();
+        for (size_t k = 0; k < 8 && i + k < image.size(); ++k, word >>= 8) {
+            uint8_t value = static_cast<uint8_t>(word);
+            if (density == AnchorDensity::SPARSE) {
+                // Los bytes de ancla se desplazan a un valor que no lo sea
+                while (isAnchor[value]) value = static_cast<uint8_t>(value + 1);
+            }
+            else if ((word & 0x7) == 0) {
+                // ~1 de cada 8 bytes es un ancla
+                value = anchors[(word >> 3) % anchors.size()];
+            }
+            image[i + k] = value;
+        }
+    }
+
+    // Near-misses cada 64 KB (sparse) o cada 4 KB (dense)
+    const size_t nearMissStride = density == AnchorDensity::SPARSE ? 64 * 1024 : 4 * 1024;
+    size_t rotation = 0;
+    for (size_t offset = 512; offset + 64 < image.size(); offset += nearMissStride) {
+        const BenchPath& path = paths[rotation % paths.size()];
+        const PreparedPattern& pattern = path.patterns[(rotation / paths.size()) % path.patterns.size()];
+        WriteNearMiss(image.data() + offset, pattern, rng);
+        rotation++;
+    }
+
+    // Firmas reales en el último 1%: el escaneo tiene que recorrer la imagen completa
+    std::vector<std::vector<size_t>> planted;
+    size_t cursor = image.size() - image.size() / 100;
+    for (size_t p = 0; p < paths.size(); ++p) {
+        const BenchPath& path = paths[p];
+        if (path.plantedFrom != p) {
+            planted.push_back(planted[path.plantedFrom]);
+            continue;
+        }
+
+        std::vector<size_t> offsets;
+        for (const PreparedPattern& pattern : path.patterns) {
+            cursor = (cursor + 256 + rng.Next() % 4096) & ~static_cast<size_t>(0xF);
+            cursor += 3;    // sin alinear a propósito
+            WritePattern(image.data() + cursor, pattern.view, rng);
+            offsets.push_back(cursor);
+        }
+        planted.push_back(offsets);
+    }
+    return planted;
+}
+
+// ============================================================================
+// Ejecución
+// ============================================================================
+
+struct BenchResult {
+    double seconds = 0;
+    size_t found = 0;
+    bool correct = true;
+    uint64_t allocCount = 0;
+    uint64_t allocBytes = 0;
+};
+
+BenchResult RunPath(const std::vector<uint8_t>& image, const BenchPath& path, const std::vector<size_t>& planted,
+                    const ScanOptions& options, unsigned repeat) {
+    BenchResult best;
+    best.seconds = 1e30;
+
+    // Igual que en el DLL: el scanner se construye por escaneo, así que entra en la medición
+    std::vector<const uint8_t*> results;
+    std::vector<PatternMatches> enumerated;
+    for (unsigned run = 0; run < repeat; ++run) {
+        results.assign(path.patterns.size(), nullptr);
+        enumerated.clear();
+
+        const uint64_t allocCountBefore = g_allocCount.load();
+        const uint64_t allocBytesBefore = g_allocBytes.load();
+        const auto start = std::chrono::steady_clock::now();
+
+        if (path.mode == PathMode::MULTI) {
+            MultiPatternScanner scanner;
+            for (const PreparedPattern& pattern : path.patterns) scanner.AddPattern(pattern);
+            ParallelPatternScanner::FindFirstAll(image.data(), image.size(), scanner, options, results);
+        }
+        else if (path.mode == PathMode::ENUMERATE) {
+            MultiPatternScanner scanner;
+            for (const PreparedPattern& pattern : path.patterns) scanner.AddPattern(pattern);
+            ParallelPatternScanner::FindAll(image.data(), image.size(), scanner, options, enumerated,
+                OffsetScanCore::MaxCandidates);
+            for (size_t id = 0; id < enumerated.size(); ++id) {
+                if (!enumerated[id].candidates.empty()) results[id] = enumerated[id].candidates.front();
+            }
+        }
+        else {
+            for (size_t id = 0; id < path.patterns.size(); ++id) {
+                results[id] = PatternScanner::FindFirst(image.data(), image.size(), path.patterns[id]);
+            }
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const uint64_t allocCount = g_allocCount.load() - allocCountBefore;
+        const uint64_t allocBytes = g_allocBytes.load() - allocBytesBefore;
+
+        if (seconds < best.seconds) {
+            best.seconds = seconds;
+            best.allocCount = allocCount;
+            best.allocBytes = allocBytes;
+        }
+    }
+
+    for (size_t id = 0; id < path.patterns.size(); ++id) {
+        if (results[id]) best.found++;
+        if (results[id] != image.data() + planted[id]) best.correct = false;
+    }
+    return best;
+}
+
+// Hashes de toda la imagen página a página. Correcto = la versión por hardware (si la hay)
+// coincide con la de tablas
+BenchResult RunPageHash(const std::vector<uint8_t>& image, unsigned repeat) {
+    BenchResult best;
+    best.seconds = 1e30;
+
+    PageHashSet pages;
+    for (unsigned run = 0; run < repeat; ++run) {
+        pages.Clear();
+
+        const uint64_t allocCountBefore = g_allocCount.load();
+        const uint64_t allocBytesBefore = g_allocBytes.load();
+        const auto start = std::chrono::steady_clock::now();
+
+        pages.AddRange(image.data(), image.size(), 0);
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds < best.seconds) {
+            best.seconds = seconds;
+            best.allocCount = g_allocCount.load() - allocCountBefore;
+            best.allocBytes = g_allocBytes.load() - allocBytesBefore;
+        }
+    }
+
+    const std::vector<uint32_t>& hashes = pages.GetRanges().front().hashes;
+    best.found = hashes.size();
+    for (size_t page = 0; page < hashes.size(); ++page) {
+        const size_t offset = page * PageHashSet::PageSize;
+        const size_t length = image.size() - offset < PageHashSet::PageSize ? image.size() - offset : PageHashSet::PageSize;
+        if (hashes[page] != PageHasher::Crc32cSoftware(image.data() + offset, length)) best.correct = false;
+    }
+    return best;
+}
+
+bool ReadBuffer(void*, uintptr_t address, void* buffer, size_t size) {
+    std::memcpy(buffer, reinterpret_cast<const void*>(address), size);
+    return true;
+}
+
+// Primera búsqueda (sin medir) + "cambió" tras tocar un int32 de cada página. Correcto = quedan
+// justo los tocados. La imagen se deja como estaba
+BenchResult RunSnapshot(std::vector<uint8_t>& image, ScanThreadPool& pool, unsigned repeat) {
+    BenchResult best;
+    best.seconds = 1e30;
+
+    std::vector<SnapshotRange> ranges(1);
+    ranges[0].base = reinterpret_cast<uintptr_t>(image.data());
+    ranges[0].size = image.size();
+
+    const size_t stride = PageHashSet::PageSize;
+    MemorySnapshot snapshot;
+    snapshot.SetMemoryBudget(image.size() * 2);
+    for (unsigned run = 0; run < repeat; ++run) {
+        if (!snapshot.Start(ranges, SnapshotValueType::I32, &ReadBuffer, nullptr, &pool)) {
+            best.correct = false;
+            return best;
+        }
+        for (size_t offset = stride / 2; offset + 4 <= image.size(); offset += stride) image[offset] ^= 0x5A;
+
+        const uint64_t allocCountBefore = g_allocCount.load();
+        const uint64_t allocBytesBefore = g_allocBytes.load();
+        const auto start = std::chrono::steady_clock::now();
+
+        snapshot.Filter(SnapshotPredicate::CHANGED, 0, &pool);
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds < best.seconds) {
+            best.seconds = seconds;
+            best.allocCount = g_allocCount.load() - allocCountBefore;
+            best.allocBytes = g_allocBytes.load() - allocBytesBefore;
+        }
+        for (size_t offset = stride / 2; offset + 4 <= image.size(); offset += stride) image[offset] ^= 0x5A;
+    }
+
+    std::vector<SnapshotCandidate> candidates;
+    snapshot.GetCandidates(snapshot.GetCandidateCount(), candidates);
+    best.found = candidates.size();
+    if (candidates.size() != image.size() / stride) best.correct = false;
+    for (size_t i = 0; i < candidates.size() && best.correct; ++i) {
+        if (candidates[i].address != ranges[0].base + i * stride + stride / 2) best.correct = false;
+    }
+    return best;
+}
+
+bool ParseBackend(const std::string& name, ScanBackend& backend) {
+    if (name == "scalar") backend = ScanBackend::SCALAR;
+    else if (name == "sse2") backend = ScanBackend::SSE2;
+    else if (name == "avx2") backend = ScanBackend::AVX2;
+    else return false;
+    return true;
+}
+
+std::vector<size_t> ParseSizes(const std::string& list) {
+    std::vector<size_t> sizes;
+    size_t start = 0;
+    while (start < list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) comma = list.size();
+        const unsigned long megabytes = std::strtoul(list.substr(start, comma - start).c_str(), nullptr, 10);
+        if (megabytes) sizes.push_back(static_cast<size_t>(megabytes));
+        start = comma + 1;
+    }
+    return sizes;
+}
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+        "Uso: %s [--sizes 64,256,1024] [--repeat 3] [--workers N] [--backend scalar|sse2|avx2]\n"
+        "          [--path offsets|offsets-enum|store|store-single|page-hash|snapshot|all]\n", program);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes = { 64, 256, 1024 };
+    unsigned repeat = 3;
+    std::string pathFilter = "all";
+    ScanOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--sizes" && hasValue) {
+            sizes = ParseSizes(argv[++i]);
+        }
+        else if (arg == "--repeat" && hasValue) {
+            repeat = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            if (repeat == 0) repeat = 1;
+        }
+        else if (arg == "--workers" && hasValue) {
+            options.workerCount = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--backend" && hasValue) {
+            ScanBackend backend;
+            if (!ParseBackend(argv[++i], backend)) {
+                PrintUsage(argv[0]);
+                return 2;
+            }
+            PatternScanner::SetBackend(backend);
+        }
+        else if (arg == "--path" && hasValue) {
+            pathFilter = argv[++i];
+        }
+        else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<BenchPath> paths;
+    {
+        BenchPath offsets{ "offsets", {}, PathMode::MULTI, 0 };
+        // Las ancladas en cadena no pasan por el escaneo de patrones
+        for (const OffsetSignature& signature : OffsetScanCore::GetSignatures()) {
+            if (!signature.anchorString) offsets.patterns.push_back(signature.pattern);
+        }
+
+        const std::vector<PreparedPattern> store = {
+            kD3D11DeviceSignature.Prepared(), kSwapChainPresentSignature.Prepared(),
+            kXInputSignature.Prepared(), kGameStateSignature.Prepared()
+        };
+
+        paths.push_back(offsets);
+        paths.push_back(BenchPath{ "offsets-enum", offsets.patterns, PathMode::ENUMERATE, 0 });
+        paths.push_back(BenchPath{ "store", store, PathMode::MULTI, 2 });
+        paths.push_back(BenchPath{ "store-single", store, PathMode::SINGLE, 2 });
+    }
+
+    // Un pool compartido, como hace ScanForOffsets; crear hilos no es lo que se mide
+    ScanThreadPool pool(options.workerCount);
+    options.pool = &pool;
+
+    std::printf("Backend: %s  Workers: %u  Repeticiones: %u (mejor tiempo)\n",
+        PatternScanner::BackendToString(PatternScanner::GetBackend()), pool.GetWorkerCount(), repeat);
+    std::printf("%-8s %-7s %-13s %9s %9s %12s %8s %12s %s\n",
+        "imagen", "anclas", "ruta", "ms", "GB/s", "matches/s", "allocs", "alloc bytes", "resultado");
+
+    bool allCorrect = true;
+    for (size_t megabytes : sizes) {
+        std::vector<uint8_t> image(megabytes * 1024 * 1024);
+
+        const AnchorDensity densities[] = { AnchorDensity::SPARSE, AnchorDensity::DENSE };
+        for (AnchorDensity density : densities) {
+            const std::vector<std::vector<size_t>> planted = BuildImage(image, density, paths);
+
+            for (size_t p = 0; p < paths.size(); ++p) {
+                if (pathFilter != "all" && pathFilter != paths[p].name) continue;
+
+                const BenchResult result = RunPath(image, paths[p], planted[p], options, repeat);
+                const double gigabytes = static_cast<double>(image.size()) / (1024.0 * 1024.0 * 1024.0);
+                allCorrect = allCorrect && result.correct;
+
+                std::printf("%5zuMB   %-7s %-13s %9.2f %9.2f %12.1f %8llu %12llu %s\n",
+                    megabytes, DensityToString(density), paths[p].name, result.seconds * 1000.0,
+                    gigabytes / result.seconds, static_cast<double>(result.found) / result.seconds,
+                    static_cast<unsigned long long>(result.allocCount),
+                    static_cast<unsigned long long>(result.allocBytes),
+                    result.correct ? "OK" : "MISMATCH");
+                std::fflush(stdout);
+            }
+        }
+
+        if (pathFilter == "all" || pathFilter == "page-hash") {
+            const BenchResult result = RunPageHash(image, repeat);
+            const double gigabytes = static_cast<double>(image.size()) / (1024.0 * 1024.0 * 1024.0);
+            allCorrect = allCorrect && result.correct;
+
+            std::printf("%5zuMB   %-7s %-13s %9.2f %9.2f %12.1f %8llu %12llu %s (%s)\n",
+                megabytes, "-", "page-hash", result.seconds * 1000.0, gigabytes / result.seconds,
+                static_cast<double>(result.found) / result.seconds,
+                static_cast<unsigned long long>(result.allocCount),
+                static_cast<unsigned long long>(result.allocBytes),
+                result.correct ? "OK" : "MISMATCH", PageHasher::HasHardwareCrc() ? "SSE4.2" : "tablas");
+            std::fflush(stdout);
+        }
+
+        if (pathFilter == "all" || pathFilter == "snapshot") {
+            const BenchResult result = RunSnapshot(image, pool, repeat);
+            const double gigabytes = static_cast<double>(image.size()) / (1024.0 * 1024.0 * 1024.0);
+            allCorrect = allCorrect && result.correct;
+
+            std::printf("%5zuMB   %-7s %-13s %9.2f %9.2f %12.1f %8llu %12llu %s\n",
+                megabytes, "-", "snapshot", result.seconds * 1000.0, gigabytes / result.seconds,
+                static_cast<double>(result.found) / result.seconds,
+                static_cast<unsigned long long>(result.allocCount),
+                static_cast<unsigned long long>(result.allocBytes),
+                result.correct ? "OK" : "MISMATCH");
+            std::fflush(stdout);
+        }
+    }
+
+    return allCorrect ? 0 : 1;
+}
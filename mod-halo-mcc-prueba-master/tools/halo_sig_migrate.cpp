@@ -0,0 +1,345 @@
+// halo_sig_migrate.cpp
+// Migración de offsets entre versiones de MCC. Sobre el binario antiguo se buscan los sitios
+// que tocan cada global conocido, se genera para cada uno la firma única más corta (comodines
+// en disp32, saltos relativos y relocaciones) y esas firmas se buscan en el binario nuevo.
+// Las firmas que llegan a un mismo global votan, como en OffsetScanCore::ScoreMatches, y el
+// resultado se guarda como perfil del binario nuevo (HaloMCC_OffsetCache.bin).
+//
+// Uso: halo_sig_migrate <antiguo.exe|dll> <nuevo.exe|dll> [-o perfil.bin] [--target campo=rva]...
+//                       [--site campo=rva]... [--max-sites 32] [--workers N] [--game h3] [--platform store]
+//
+// Sin --target, los globales del binario antiguo salen de las firmas actuales del mod (que
+// todavía valen para él). Las firmas más cortas de cada campo se imprimen para poder
+// actualizar la tabla de HaloMCC_OffsetProfile.cpp.
+#include "HaloMCC_OffsetProfile.h"
+#include "HaloMCC_SignatureGen.h"
+#include "HaloMCC_ThreadPool.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Mismo orden que GameVersion / GamePlatform en UWP_Detection.h
+const char* const kGameNames[] = { "ce", "h2", "h2a", "h3", "reach", "h4", "unknown" };
+const char* const kPlatformNames[] = { "steam", "store", "unknown" };
+const char* const kFieldNames[] = { "splitscreen", "players", "camera" };
+const uint32_t kFieldCount = 3;
+const uint32_t kUnknownGame = 6;
+const uint32_t kUnknownPlatform = 2;
+// Firmas de cada campo que se imprimen como sugerencia
+const size_t kPrintedSignatures = 3;
+
+bool ParseEnumArg(const char* value, const char* const* names, uint32_t count, uint32_t& result) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (std::strcmp(value, names[i]) == 0) {
+            result = i;
+            return true;
+        }
+    }
+
+    char* end = nullptr;
+    const unsigned long number = std::strtoul(value, &end, 10);
+    if (end == value || *end != '\0' || number >= count) return false;
+    result = static_cast<uint32_t>(number);
+    return true;
+}
+
+// "camera=0x1234ABC": campo (OffsetField) y RVA en hex
+bool ParseFieldRva(const char* text, uint32_t& field, uint32_t& rva) {
+    const char* equals = std::strchr(text, '=');
+    if (!equals) return false;
+
+    const std::string name(text, equals - text);
+    if (!ParseEnumArg(name.c_str(), kFieldNames, kFieldCount, field)) return false;
+    field += OFFSET_SPLIT_SCREEN_ENABLED;
+
+    char* end = nullptr;
+    const unsigned long value = std::strtoul(equals + 1, &end, 16);
+    if (end == equals + 1 || *end != '\0') return false;
+    rva = static_cast<uint32_t>(value);
+    return true;
+}
+
+std::string GetFileName(const std::string& path) {
+    const size_t slash = path.find_last_of("\\/");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+uint32_t GuessPlatform(const std::string& path) {
+    std::string lower = path;
+    for (char& c : lower) c = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    if (lower.find("mccwinstore") != std::string::npos) return 1;
+    if (lower.find("mcc-win64") != std::string::npos) return 0;
+    return kUnknownPlatform;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Binary {
+    MappedFile file;
+    PEImage image;
+};
+
+bool OpenBinary(const std::string& path, Binary& binary) {
+    if (!binary.file.Open(path)) {
+        std::fprintf(stderr, "ERROR: no se pudo mapear %s\n", path.c_str());
+        return false;
+    }
+    if (!binary.image.Parse(binary.file.Data(), binary.file.Size(), PEImage::Layout::FILE)) {
+        std::fprintf(stderr, "ERROR: %s no es un PE válido\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+        "Uso: %s <antiguo.exe|dll> <nuevo.exe|dll> [-o perfil.bin] [--target campo=rva]... [--site campo=rva]...\n"
+        "          [--max-sites 32] [--workers N] [--game h3] [--platform store]\n"
+        "     campo: splitscreen|players|camera\n", program);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string oldPath;
+    std::string newPath;
+    std::string outputPath = "HaloMCC_OffsetCache.bin";
+    std::map<uint32_t, uint32_t> targets;               // campo -> RVA en el antiguo
+    std::vector<std::pair<uint32_t, uint32_t>> extraSites;
+    size_t maxSites = 32;
+    unsigned workers = 0;
+    uint32_t gameVersion = kUnknownGame;
+    uint32_t gamePlatform = kUnknownPlatform;
+    bool gameGiven = false;
+    bool platformGiven = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        uint32_t field = 0, rva = 0;
+
+        if ((arg == "--target" || arg == "--site") && hasValue) {
+            if (!ParseFieldRva(argv[++i], field, rva)) {
+                std::fprintf(stderr, "Valor no válido: %s (campo=rva)\n", argv[i]);
+                return 2;
+            }
+            if (arg == "--target") targets[field] = rva;
+            else extraSites.emplace_back(field, rva);
+        }
+        else if (arg == "--max-sites" && hasValue) {
+            maxSites = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--workers" && hasValue) {
+            workers = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if ((arg == "-o" || arg == "--output") && hasValue) {
+            outputPath = argv[++i];
+        }
+        else if (arg == "--game" && hasValue) {
+            if (!ParseEnumArg(argv[++i], kGameNames, 7, gameVersion)) {
+                std::fprintf(stderr, "Juego no válido: %s\n", argv[i]);
+                return 2;
+            }
+            gameGiven = true;
+        }
+        else if (arg == "--platform" && hasValue) {
+            if (!ParseEnumArg(argv[++i], kPlatformNames, 3, gamePlatform)) {
+                std::fprintf(stderr, "Plataforma no válida: %s\n", argv[i]);
+                return 2;
+            }
+            platformGiven = true;
+        }
+        else if (!arg.empty() && arg[0] != '-' && oldPath.empty()) {
+            oldPath = arg;
+        }
+        else if (!arg.empty() && arg[0] != '-' && newPath.empty()) {
+            newPath = arg;
+        }
+        else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (oldPath.empty() || newPath.empty()) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    Binary oldBinary, newBinary;
+    if (!OpenBinary(oldPath, oldBinary) || !OpenBinary(newPath, newBinary)) return 1;
+
+    const OffsetTitleInfo* titleInfo = OffsetScanCore::FindTitleByModule(GetFileName(oldPath).c_str());
+    const uint32_t title = titleInfo ? titleInfo->title : TITLE_MCC;
+    if (titleInfo && title != TITLE_MCC && !gameGiven) gameVersion = titleInfo->gameVersion;
+    if (!platformGiven) gamePlatform = GuessPlatform(newPath);
+
+    ScanThreadPool pool(workers);
+    std::printf("Antiguo: %s (TimeDateStamp 0x%08X)  Nuevo: %s (TimeDateStamp 0x%08X)  %u workers\n",
+        oldPath.c_str(), oldBinary.image.GetTimeDateStamp(), newPath.c_str(), newBinary.image.GetTimeDateStamp(),
+        pool.GetWorkerCount());
+
+    // Globales del antiguo: los dados o los que sacan las firmas actuales
+    if (targets.empty()) {
+        ScanOptions options;
+        options.pool = &pool;
+        const std::vector<OffsetMatch> matches = OffsetScanCore::ScanImage(oldBinary.image, options, title);
+        for (const OffsetResolution& resolution : OffsetScanCore::ScoreMatches(matches)) {
+            if (resolution.found) targets[resolution.field] = resolution.targetRva;
+        }
+    }
+    if (targets.empty() && extraSites.empty()) {
+        std::fprintf(stderr, "ERROR: ningún global conocido en %s (usa --target)\n", oldPath.c_str());
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    SignatureGenerator generator;
+    if (!generator.Build(oldBinary.image)) {
+        std::fprintf(stderr, "ERROR: %s no tiene secciones de código\n", oldPath.c_str());
+        return 1;
+    }
+
+    std::vector<uint32_t> targetRvas;
+    for (const auto& target : targets) targetRvas.push_back(target.second);
+    std::vector<XrefEntry> xrefs;
+    generator.FindSites(targetRvas, xrefs, &pool);
+
+    // Hasta maxSites sitios por campo, repartidos por todo el código
+    std::vector<GeneratedSignature> signatures;
+    for (const auto& target : targets) {
+        std::vector<uint32_t> fieldSites;
+        for (const XrefEntry& xref : xrefs) {
+            if (xref.targetRva == target.second) fieldSites.push_back(xref.siteRva);
+        }
+
+        const size_t count = std::min(maxSites, fieldSites.size());
+        for (size_t k = 0; k < count; ++k) {
+            GeneratedSignature signature;
+            signature.field = target.first;
+            signature.siteRva = fieldSites[k * fieldSites.size() / count];
+            signature.targetRva = target.second;
+            signatures.push_back(signature);
+        }
+        std::printf("  %-18s RVA 0x%08X: %zu referencias en código, se usan %zu\n",
+            OffsetScanCore::FieldToString(target.first), target.second, fieldSites.size(), count);
+    }
+    for (const auto& site : extraSites) {
+        GeneratedSignature signature;
+        signature.field = site.first;
+        signature.siteRva = site.second;
+        signature.targetRva = targets.count(site.first) ? targets[site.first] : 0;
+        signatures.push_back(signature);
+    }
+
+    generator.Generate(signatures, &pool);
+    size_t uniqueCount = 0;
+    for (const GeneratedSignature& signature : signatures) uniqueCount += signature.unique ? 1 : 0;
+    std::printf("Firmas: %zu únicas de %zu sitios en %.2f s\n", uniqueCount, signatures.size(), SecondsSince(start));
+
+    start = std::chrono::steady_clock::now();
+    std::vector<LocatedSignature> located;
+    SignatureGenerator::Locate(newBinary.image, signatures, located, &pool);
+    std::printf("Búsqueda en el nuevo: %.2f s\n", SecondsSince(start));
+
+    // Votos por campo: destino en el nuevo -> firmas que llegan a él
+    const OffsetCacheKey key = OffsetScanCore::MakeKey(newBinary.image, gameVersion, gamePlatform);
+    OffsetCacheRecord record;
+    record.key = key;
+
+    std::vector<uint32_t> fields;
+    for (const GeneratedSignature& signature : signatures) {
+        if (std::find(fields.begin(), fields.end(), signature.field) == fields.end()) fields.push_back(signature.field);
+    }
+    std::sort(fields.begin(), fields.end());
+
+    size_t migrated = 0;
+    for (uint32_t field : fields) {
+        const char* fieldName = OffsetScanCore::FieldToString(field);
+        std::map<uint32_t, std::vector<size_t>> votes;
+        size_t resolved = 0;
+        for (size_t i = 0; i < signatures.size(); ++i) {
+            if (signatures[i].field != field || !located[i].resolved) continue;
+            votes[located[i].targetRva].push_back(i);
+            resolved++;
+        }
+
+        if (votes.empty()) {
+            std::printf("✗ %-18s ninguna firma se encuentra una sola vez en el nuevo\n", fieldName);
+            continue;
+        }
+
+        // Gana el destino con más firmas; a igualdad, el de la firma más corta
+        auto shortest = [&](const std::vector<size_t>& ids) {
+            size_t best = ids.front();
+            for (size_t id : ids) {
+                if (signatures[id].bytes.size() < signatures[best].bytes.size()) best = id;
+            }
+            return best;
+        };
+        auto winner = votes.begin();
+        for (auto it = votes.begin(); it != votes.end(); ++it) {
+            if (it->second.size() > winner->second.size() ||
+                (it->second.size() == winner->second.size() &&
+                 signatures[shortest(it->second)].bytes.size() < signatures[shortest(winner->second)].bytes.size())) {
+                winner = it;
+            }
+        }
+
+        // Misma regla que OffsetScanCore::ScoreMatches: un empate no se migra
+        const size_t agreeing = winner->second.size();
+        if (resolved - agreeing >= agreeing) {
+            std::printf("✗ %-18s firmas en conflicto (%zu de acuerdo, %zu en conflicto), no se migra\n", fieldName,
+                agreeing, resolved - agreeing);
+            continue;
+        }
+
+        const uint8_t confidence = OffsetScanCore::ComputeConfidence(static_cast<uint32_t>(agreeing),
+                                                                     static_cast<uint32_t>(resolved - agreeing));
+        const size_t best = shortest(winner->second);
+        std::printf("→ %-18s RVA 0x%08X -> 0x%08X  confianza %u%% (%zu de acuerdo, %zu en conflicto)\n", fieldName,
+            signatures[best].targetRva, winner->first, confidence, agreeing, resolved - agreeing);
+
+        OffsetCacheEntry entry = OffsetCache::MakeEntry(field, located[best].siteRva, winner->first, signatures[best].View());
+        entry.confidence = confidence;
+        record.entries.push_back(entry);
+        migrated++;
+
+        // Sugerencias para la tabla de firmas: las más cortas que han votado al ganador
+        std::vector<size_t> ordered = winner->second;
+        std::sort(ordered.begin(), ordered.end(), [&](size_t a, size_t b) {
+            return signatures[a].bytes.size() < signatures[b].bytes.size();
+        });
+        for (size_t k = 0; k < ordered.size() && k < kPrintedSignatures; ++k) {
+            std::printf("    \"%s\"  (sitio nuevo RVA 0x%08X)\n", signatures[ordered[k]].ToString().c_str(),
+                located[ordered[k]].siteRva);
+        }
+    }
+
+    if (record.entries.empty()) {
+        std::fprintf(stderr, "ERROR: ningún offset migrado, no se escribe perfil\n");
+        return 1;
+    }
+
+    OffsetCache cache;
+    cache.Load(outputPath);
+    cache.Store(record);
+    if (!cache.Save(outputPath)) {
+        std::fprintf(stderr, "ERROR: no se pudo escribir %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    std::printf("Perfil: %s (juego %s, plataforma %s, %zu/%zu offsets)\n", outputPath.c_str(),
+        kGameNames[gameVersion], kPlatformNames[gamePlatform], migrated, fields.size());
+    return migrated == fields.size() ? 0 : 3;
+}
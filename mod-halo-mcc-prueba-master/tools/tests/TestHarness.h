@@ -0,0 +1,35 @@
+// TestHarness.h
+// Lo mínimo para los tests del núcleo portable, sin framework: cada .cpp registra sus casos
+// en un grupo y halo_core_tests ejecuta el grupo que se le pase (una entrada de CTest por
+// grupo). Un CHECK que falla se cuenta y el caso sigue, para ver todos los fallos de una vez.
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+struct TestCase {
+    const char* group;
+    const char* name;
+    void (*run)();
+};
+
+std::vector<TestCase>& GetTestCases();
+void ReportTestFailure(const char* file, int line, const char* expression);
+
+struct TestRegistrar {
+    TestRegistrar(const char* group, const char* name, void (*run)()) {
+        GetTestCases().push_back(TestCase{ group, name, run });
+    }
+};
+
+#define HALO_TEST(group, name)                                              \
+    static void name();                                                     \
+    static TestRegistrar name##Registrar(group, #name, &name);              \
+    static void name()
+
+#define CHECK(expression)                                                   \
+    do {                                                                    \
+        if (!(expression)) ReportTestFailure(__FILE__, __LINE__, #expression); \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) CHECK((actual) == (expected))
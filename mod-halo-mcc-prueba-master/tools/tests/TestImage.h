@@ -0,0 +1,90 @@
+// TestImage.h
+// Imágenes PE32+ sintéticas para los tests: cabeceras mínimas válidas + tabla de secciones.
+// Por defecto cada sección va en el fichero en el mismo offset que su RVA, así el mismo
+// buffer vale como layout MAPPED y como FILE.
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+struct TestSection {
+    const char* name;
+    uint32_t virtualAddress;
+    uint32_t virtualSize;
+    uint32_t characteristics;
+    uint32_t rawOffset = 0;         // 0 = igual que virtualAddress
+    uint32_t rawSize = 0;           // 0 = igual que virtualSize
+};
+
+namespace TestImage {
+
+const uint32_t NtOffset = 0x80;
+const uint32_t OptionalHeaderOffset = NtOffset + 4 + 20;
+const uint32_t OptionalHeaderSize = 112 + 16 * 8;
+const uint32_t SectionTableOffset = OptionalHeaderOffset + OptionalHeaderSize;
+const uint32_t HeadersSize = 0x1000;
+
+const uint32_t Code = 0x60000020;           // CNT_CODE | MEM_EXECUTE | MEM_READ
+const uint32_t ReadOnlyData = 0x40000040;   // CNT_INITIALIZED_DATA | MEM_READ
+const uint32_t WritableData = 0xC0000040;   // CNT_INITIALIZED_DATA | MEM_READ | MEM_WRITE
+
+inline void Put16(std::vector<uint8_t>& image, size_t offset, uint16_t value) { memcpy(&image[offset], &value, 2); }
+inline void Put32(std::vector<uint8_t>& image, size_t offset, uint32_t value) { memcpy(&image[offset], &value, 4); }
+inline void Put64(std::vector<uint8_t>& image, size_t offset, uint64_t value) { memcpy(&image[offset], &value, 8); }
+
+inline uint32_t GetSectionTableEnd(size_t sectionCount) {
+    return SectionTableOffset + static_cast<uint32_t>(sectionCount) * 40;
+}
+
+inline std::vector<uint8_t> Build(const std::vector<TestSection>& sections, uint32_t timeDateStamp = 0x5F3A1C00) {
+    uint32_t sizeOfImage = HeadersSize;
+    size_t fileSize = HeadersSize;
+    for (const TestSection& section : sections) {
+        const uint32_t end = (section.virtualAddress + section.virtualSize + 0xFFF) & ~0xFFFu;
+        if (end > sizeOfImage) sizeOfImage = end;
+        const uint32_t rawOffset = section.rawOffset ? section.rawOffset : section.virtualAddress;
+        const uint32_t rawSize = section.rawSize ? section.rawSize : section.virtualSize;
+        if (rawOffset + rawSize > fileSize) fileSize = rawOffset + rawSize;
+    }
+
+    std::vector<uint8_t> image(sizeOfImage > fileSize ? sizeOfImage : fileSize, 0);
+    Put16(image, 0, 0x5A4D);                                    // MZ
+    Put32(image, 0x3C, NtOffset);
+    Put32(image, NtOffset, 0x00004550);                         // PE\0\0
+    Put16(image, NtOffset + 4, 0x8664);                         // AMD64
+    Put16(image, NtOffset + 6, static_cast<uint16_t>(sections.size()));
+    Put32(image, NtOffset + 8, timeDateStamp);
+    Put16(image, NtOffset + 20, static_cast<uint16_t>(OptionalHeaderSize));
+
+    Put16(image, OptionalHeaderOffset, 0x20B);                  // PE32+
+    Put64(image, OptionalHeaderOffset + 24, 0x140000000ull);
+    Put32(image, OptionalHeaderOffset + 32, 0x1000);
+    Put32(image, OptionalHeaderOffset + 36, 0x200);
+    Put32(image, OptionalHeaderOffset + 56, sizeOfImage);
+    Put32(image, OptionalHeaderOffset + 60, HeadersSize);
+    Put32(image, OptionalHeaderOffset + 108, 16);
+
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const TestSection& section = sections[i];
+        const size_t header = SectionTableOffset + i * 40;
+        const size_t nameLength = strlen(section.name) < 8 ? strlen(section.name) : 8;
+        memcpy(&image[header], section.name, nameLength);
+        Put32(image, header + 8, section.virtualSize);
+        Put32(image, header + 12, section.virtualAddress);
+        Put32(image, header + 16, section.rawSize ? section.rawSize : section.virtualSize);
+        Put32(image, header + 20, section.rawOffset ? section.rawOffset : section.virtualAddress);
+        Put32(image, header + 36, section.characteristics);
+    }
+    return image;
+}
+
+// .text / .rdata / .data de una página cada una
+inline std::vector<TestSection> DefaultSections() {
+    return {
+        { ".text", 0x1000, 0x1000, Code },
+        { ".rdata", 0x2000, 0x1000, ReadOnlyData },
+        { ".data", 0x3000, 0x1000, WritableData },
+    };
+}
+
+} // namespace TestImage
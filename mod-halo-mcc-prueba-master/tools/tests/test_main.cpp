@@ -0,0 +1,46 @@
+// test_main.cpp
+// halo_core_tests [grupo]: sin argumento ejecuta todos los grupos
+#include "TestHarness.h"
+#include <cstring>
+
+namespace {
+
+int g_failures = 0;
+
+} // namespace
+
+std::vector<TestCase>& GetTestCases() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+void ReportTestFailure(const char* file, int line, const char* expression) {
+    const char* name = strrchr(file, '/');
+    if (!name) name = strrchr(file, '\\');
+    printf("    ✗ %s:%d: %s\n", name ? name + 1 : file, line, expression);
+    g_failures++;
+}
+
+int main(int argc, char** argv) {
+    const char* group = argc > 1 ? argv[1] : nullptr;
+
+    size_t run = 0;
+    size_t failed = 0;
+    for (const TestCase& test : GetTestCases()) {
+        if (group && strcmp(group, test.group) != 0) continue;
+
+        const int before = g_failures;
+        test.run();
+        run++;
+        if (g_failures != before) failed++;
+        printf("%s %s/%s\n", g_failures == before ? "✓" : "✗", test.group, test.name);
+    }
+
+    if (!run) {
+        printf("✗ No hay tests en el grupo '%s'\n", group ? group : "");
+        return 1;
+    }
+
+    printf("%zu tests, %zu con fallos\n", run, failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,275 @@
+// test_minidump.cpp
+// Minidump::Open sobre volcados sintéticos: Memory64ListStream (completo) con módulos y
+// MemoryInfoListStream, MemoryListStream (mínimo) y ficheros truncados o corruptos
+#include "TestHarness.h"
+#include "HaloMCC_Minidump.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const uint32_t ModuleListStream = 4;
+const uint32_t MemoryListStream = 5;
+const uint32_t Memory64ListStream = 9;
+const uint32_t MemoryInfoListStream = 16;
+
+const uint64_t ImageBase = 0x140000000ull;
+const uint64_t HeapBase = 0x200000;
+const uint64_t StackBase = 0x300000;
+
+// Escritor little-endian; las RVAs son offsets en el fichero
+struct DumpWriter {
+    std::vector<uint8_t> bytes;
+
+    uint32_t Offset() const { return static_cast<uint32_t>(bytes.size()); }
+    void U16(uint16_t value) { Append(&value, 2); }
+    void U32(uint32_t value) { Append(&value, 4); }
+    void U64(uint64_t value) { Append(&value, 8); }
+    void Append(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        bytes.insert(bytes.end(), p, p + size);
+    }
+    void Patch32(uint32_t offset, uint32_t value) { memcpy(&bytes[offset], &value, 4); }
+};
+
+struct Range {
+    uint64_t base;
+    uint32_t size;
+};
+
+uint8_t ByteAt(uint64_t address) {
+    return static_cast<uint8_t>((address * 7) ^ (address >> 12));
+}
+
+// Cabecera + directorio con 'streams' huecos; devuelve el offset de cada entrada
+std::vector<uint32_t> WriteHeader(DumpWriter& out, uint32_t streamCount) {
+    out.U32(Minidump::Signature);
+    out.U32(0xA793);
+    out.U32(streamCount);
+    out.U32(32);
+    out.U32(0);
+    out.U32(0x5F3A1C00);
+    out.U64(0);
+
+    std::vector<uint32_t> entries;
+    for (uint32_t i = 0; i < streamCount; ++i) {
+        entries.push_back(out.Offset());
+        out.U32(0);
+        out.U32(0);
+        out.U32(0);
+    }
+    return entries;
+}
+
+void SetStream(DumpWriter& out, uint32_t entry, uint32_t type, uint32_t offset) {
+    out.Patch32(entry, type);
+    out.Patch32(entry + 4, out.Offset() - offset);
+    out.Patch32(entry + 8, offset);
+}
+
+void WriteModules(DumpWriter& out, uint32_t entry) {
+    const uint32_t start = out.Offset();
+    out.U32(1);
+    const uint32_t moduleEntry = out.Offset();
+    out.U64(ImageBase);
+    out.U32(0x2000);                // SizeOfImage
+    out.U32(0xABCD);                // CheckSum
+    out.U32(0x5F3A1C00);            // TimeDateStamp
+    out.U32(0);                     // ModuleNameRva (se rellena abajo)
+    while (out.Offset() < moduleEntry + 108) out.U32(0);
+    SetStream(out, entry, ModuleListStream, start);
+
+    const uint32_t nameRva = out.Offset();
+    const std::string path = "C:\\Games\\MCC\\MCC-Win64-Shipping.EXE";
+    out.U32(static_cast<uint32_t>(path.size() * 2));
+    for (char c : path) out.U16(static_cast<uint16_t>(c));
+    out.Patch32(moduleEntry + 20, nameRva);
+}
+
+// Imagen en dos trozos (código RX, datos RW) + heap RW; la pila no sale en la lista
+void WriteMemoryInfo(DumpWriter& out, uint32_t entry) {
+    struct Info { uint64_t base; uint64_t size; uint32_t protect; uint32_t type; };
+    const Info infos[] = {
+        { ImageBase, 0x1000, 0x20, 0x1000000 },
+        { ImageBase + 0x1000, 0x1000, 0x04, 0x1000000 },
+        { HeapBase, 0x1000, 0x04, 0x20000 },
+    };
+
+    const uint32_t start = out.Offset();
+    out.U32(16);
+    out.U32(48);
+    out.U64(sizeof(infos) / sizeof(infos[0]));
+    for (const Info& info : infos) {
+        out.U64(info.base);
+        out.U64(info.base);         // AllocationBase
+        out.U32(info.protect);      // AllocationProtect
+        out.U32(0);
+        out.U64(info.size);
+        out.U32(0x1000);            // MEM_COMMIT
+        out.U32(info.protect);
+        out.U32(info.type);
+        out.U32(0);
+    }
+    SetStream(out, entry, MemoryInfoListStream, start);
+}
+
+const std::vector<Range>& GetRanges() {
+    static const std::vector<Range> ranges = {
+        { ImageBase, 0x2000 },
+        { HeapBase, 0x1000 },
+        { StackBase, 0x800 },
+    };
+    return ranges;
+}
+
+std::vector<uint8_t> BuildFullDump() {
+    DumpWriter out;
+    const std::vector<uint32_t> entries = WriteHeader(out, 3);
+    WriteModules(out, entries[0]);
+    WriteMemoryInfo(out, entries[1]);
+
+    const uint32_t start = out.Offset();
+    out.U64(GetRanges().size());
+    const uint32_t baseRvaOffset = out.Offset();
+    out.U64(0);
+    for (const Range& range : GetRanges()) {
+        out.U64(range.base);
+        out.U64(range.size);
+    }
+    SetStream(out, entries[2], Memory64ListStream, start);
+
+    const uint32_t baseRva = out.Offset();
+    out.Patch32(baseRvaOffset, baseRva);
+    for (const Range& range : GetRanges()) {
+        for (uint32_t i = 0; i < range.size; ++i) out.bytes.push_back(ByteAt(range.base + i));
+    }
+    return out.bytes;
+}
+
+std::vector<uint8_t> BuildMinimalDump() {
+    DumpWriter out;
+    const std::vector<uint32_t> entries = WriteHeader(out, 1);
+
+    const uint32_t start = out.Offset();
+    out.U32(2);
+    const uint32_t descriptors = out.Offset();
+    for (int i = 0; i < 2; ++i) {
+        out.U64(0);
+        out.U32(0);
+        out.U32(0);
+    }
+    SetStream(out, entries[0], MemoryListStream, start);
+
+    const Range ranges[] = { { HeapBase, 0x100 }, { StackBase, 0x80 } };
+    for (int i = 0; i < 2; ++i) {
+        const uint32_t rva = out.Offset();
+        for (uint32_t b = 0; b < ranges[i].size; ++b) out.bytes.push_back(ByteAt(ranges[i].base + b));
+        memcpy(&out.bytes[descriptors + i * 16], &ranges[i].base, 8);
+        out.Patch32(descriptors + i * 16 + 8, ranges[i].size);
+        out.Patch32(descriptors + i * 16 + 12, rva);
+    }
+    return out.bytes;
+}
+
+bool ReadsBack(const ProcessMemory& memory, uint64_t address, size_t size) {
+    std::vector<uint8_t> buffer(size);
+    if (!memory.Read(static_cast<uintptr_t>(address), buffer.data(), size)) return false;
+    for (size_t i = 0; i < size; ++i) {
+        if (buffer[i] != ByteAt(address + i)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+HALO_TEST("minidump", OpensFullDumpWithModulesAndProtection) {
+    const std::vector<uint8_t> dump = BuildFullDump();
+    CHECK(Minidump::IsMinidump(dump.data(), dump.size()));
+
+    ProcessMemory memory;
+    CHECK(Minidump::Open(dump.data(), dump.size(), memory));
+
+    // La imagen se parte en código + datos según MemoryInfoListStream
+    CHECK_EQ(memory.GetRegions().size(), 4u);
+    const ProcessRegion* code = memory.FindRegion(static_cast<uintptr_t>(ImageBase + 0x10));
+    const ProcessRegion* data = memory.FindRegion(static_cast<uintptr_t>(ImageBase + 0x1010));
+    const ProcessRegion* heap = memory.FindRegion(static_cast<uintptr_t>(HeapBase));
+    const ProcessRegion* stack = memory.FindRegion(static_cast<uintptr_t>(StackBase + 0x7FF));
+    CHECK(code && code->size == 0x1000 && code->flags == (REGION_EXECUTABLE | REGION_IMAGE));
+    CHECK(data && data->flags == (REGION_WRITABLE | REGION_IMAGE));
+    CHECK(heap && heap->flags == REGION_WRITABLE && heap->protect == 0x04);
+    // Sin protección conocida: escribible (para el mapa de punteros)
+    CHECK(stack && stack->flags == REGION_WRITABLE);
+    CHECK(memory.FindRegion(static_cast<uintptr_t>(StackBase + 0x800)) == nullptr);
+
+    const ProcessModule* module = memory.FindModuleByName("MCC-Win64-Shipping.exe");
+    CHECK(module && module->name == "mcc-win64-shipping.exe");
+    CHECK(module && module->base == ImageBase && module->size == 0x2000);
+    CHECK(module && module->timeDateStamp == 0x5F3A1C00 && module->checkSum == 0xABCD);
+    CHECK(memory.FindModule(static_cast<uintptr_t>(ImageBase + 0x1FFF)) == module);
+
+    // Las regiones apuntan dentro del fichero; leer puede cruzar de una a la siguiente
+    CHECK(ReadsBack(memory, ImageBase, 0x2000));
+    CHECK(ReadsBack(memory, ImageBase + 0xFF0, 0x20));
+    CHECK(ReadsBack(memory, HeapBase + 0x123, 8));
+    CHECK(memory.GetData(static_cast<uintptr_t>(ImageBase + 0xFF0), 0x20) != nullptr);
+    uint8_t byte = 0;
+    CHECK(!memory.Read(static_cast<uintptr_t>(HeapBase + 0x1000), &byte, 1));
+}
+
+HALO_TEST("minidump", OpensMinimalMemoryList) {
+    const std::vector<uint8_t> dump = BuildMinimalDump();
+
+    ProcessMemory memory;
+    CHECK(Minidump::Open(dump.data(), dump.size(), memory));
+    CHECK_EQ(memory.GetRegions().size(), 2u);
+    CHECK(memory.GetModules().empty());
+    CHECK(ReadsBack(memory, HeapBase, 0x100));
+    CHECK(ReadsBack(memory, StackBase + 0x10, 0x70));
+}
+
+HALO_TEST("minidump", TruncatedDumpKeepsWholeRanges) {
+    const std::vector<uint8_t> dump = BuildFullDump();
+
+    // Cortado a mitad del heap: se queda la imagen entera y nada más
+    const size_t cut = dump.size() - 0x800 - 0x800;
+    ProcessMemory memory;
+    CHECK(Minidump::Open(dump.data(), cut, memory));
+    CHECK(ReadsBack(memory, ImageBase, 0x2000));
+    CHECK(memory.FindRegion(static_cast<uintptr_t>(HeapBase)) == nullptr);
+
+    // Ningún corte puede leer fuera del buffer; los que dejan algo tienen que leerse bien
+    std::vector<uint8_t> copy;
+    for (size_t size = 0; size < dump.size(); size += 7) {
+        copy.assign(dump.begin(), dump.begin() + size);
+        ProcessMemory partial;
+        if (Minidump::Open(copy.data(), copy.size(), partial)) {
+            for (const ProcessRegion& region : partial.GetRegions()) {
+                CHECK(region.data >= copy.data() && region.data + region.size <= copy.data() + copy.size());
+            }
+        }
+    }
+}
+
+HALO_TEST("minidump", RejectsCorruptHeaders) {
+    std::vector<uint8_t> dump = BuildFullDump();
+    ProcessMemory memory;
+
+    std::vector<uint8_t> bad = dump;
+    bad[0] = 'X';
+    CHECK(!Minidump::IsMinidump(bad.data(), bad.size()));
+    CHECK(!Minidump::Open(bad.data(), bad.size(), memory));
+    CHECK(memory.GetRegions().empty());
+
+    bad = dump;
+    memcpy(&bad[12], "\xF0\xFF\xFF\xFF", 4);                           // directorio fuera
+    CHECK(!Minidump::Open(bad.data(), bad.size(), memory));
+
+    bad = dump;
+    memcpy(&bad[8], "\xFF\xFF\xFF\x0F", 4);                            // demasiados streams
+    CHECK(!Minidump::Open(bad.data(), bad.size(), memory));
+
+    CHECK(!Minidump::Open(dump.data(), 16, memory));
+    CHECK(!Minidump::Open(nullptr, 0, memory));
+}
@@ -0,0 +1,259 @@
+// test_offset_profile.cpp
+// OffsetScanCore sobre imágenes sintéticas con una tabla de firmas propia: la tabla real
+// tiene una sola firma por campo, así que el voto entre alternativas solo se ejercita aquí
+#include "TestHarness.h"
+#include "TestImage.h"
+#include "HaloMCC_OffsetProfile.h"
+#include "HaloMCC_Signature.h"
+
+namespace {
+
+// mov eax, [rip+disp] ; cmp eax, 1 ; jle rel8
+constexpr auto kLoadCount = MakeSignature("8B 05 ?? ?? ?? ?? 83 F8 01 7E ??");
+// mov [rip+disp], eax ; ret ; int3
+constexpr auto kStoreCount = MakeSignature("89 05 ?? ?? ?? ?? C3 CC");
+// mov rcx, [rip+disp] ; test rcx, rcx
+constexpr auto kLoadPointer = MakeSignature("48 8B 0D ?? ?? ?? ?? 48 85 C9");
+// cmp dword ptr [rip+disp], 0 ; jne rel8
+constexpr auto kCompareCount = MakeSignature("83 3D ?? ?? ?? ?? 00 75 ??");
+
+const uint32_t CountRva = 0x3100;          // .data
+const uint32_t OtherRva = 0x3200;          // .data, otro global
+const uint32_t ConstantRva = 0x2100;       // .rdata
+
+OffsetSignature MakeAlternative(uint32_t rank, const PreparedPattern& pattern, uint32_t targetSections = SECTION_DATA) {
+    OffsetSignature signature;
+    signature.field = OFFSET_PLAYER_COUNT;
+    signature.rank = rank;
+    signature.name = "Player count (test)";
+    signature.pattern = pattern;
+    signature.targetSections = targetSections;
+    return signature;
+}
+
+// Escribe la firma en .text con el disp32 apuntando a targetRva (la instrucción con el
+// operando va al principio; 'length' es su longitud)
+void Plant(std::vector<uint8_t>& image, const PatternView& view, uint32_t siteRva, size_t dispOffset,
+           size_t length, uint32_t targetRva) {
+    for (size_t i = 0; i < view.length; ++i) image[siteRva + i] = view.mask[i] ? view.bytes[i] : 0x10;
+    TestImage::Put32(image, siteRva + dispOffset, targetRva - static_cast<uint32_t>(siteRva + length));
+}
+
+std::vector<OffsetResolution> Score(const std::vector<OffsetSignature>& signatures, const std::vector<uint8_t>& image) {
+    PEImage pe;
+    if (!pe.Parse(image.data(), image.size(), PEImage::Layout::MAPPED)) return {};
+
+    ScanOptions options;
+    options.deterministic = true;
+    return OffsetScanCore::ScoreMatches(signatures, OffsetScanCore::ScanImage(signatures, pe, options, TITLE_MCC));
+}
+
+} // namespace
+
+HALO_TEST("offset-profile", TwoAgreeingAlternativesBeatOneConflicting) {
+    const std::vector<OffsetSignature> signatures = {
+        MakeAlternative(0, kLoadCount.Prepared()),
+        MakeAlternative(1, kStoreCount.Prepared()),
+        MakeAlternative(2, kLoadPointer.Prepared()),
+    };
+
+    std::vector<uint8_t> image = TestImage::Build(TestImage::DefaultSections());
+    Plant(image, kLoadCount.Prepared().view, 0x1100, 2, 6, CountRva);
+    Plant(image, kStoreCount.Prepared().view, 0x1200, 2, 6, CountRva);
+    Plant(image, kLoadPointer.Prepared().view, 0x1300, 3, 7, OtherRva);
+
+    const std::vector<OffsetResolution> resolutions = Score(signatures, image);
+    CHECK_EQ(resolutions.size(), 1u);
+    if (resolutions.empty()) return;
+
+    const OffsetResolution& resolution = resolutions[0];
+    CHECK_EQ(resolution.field, static_cast<uint32_t>(OFFSET_PLAYER_COUNT));
+    CHECK(resolution.found && !resolution.contested);
+    CHECK_EQ(resolution.targetRva, CountRva);
+    CHECK_EQ(resolution.siteRva, 0x1100u);
+    CHECK_EQ(resolution.signatureIndex, 0u);
+    CHECK_EQ(resolution.agreeing, 2u);
+    CHECK_EQ(resolution.conflicting, 1u);
+    CHECK_EQ(resolution.confidence, 33);            // 100 * (2 - 1) / 3
+}
+
+HALO_TEST("offset-profile", MajorityWinsOverPrimarySignature) {
+    // La principal es la que está en conflicto: gana el destino de las alternativas, y de
+    // ellas la de menor rank
+    const std::vector<OffsetSignature> signatures = {
+        MakeAlternative(0, kLoadPointer.Prepared()),
+        MakeAlternative(1, kLoadCount.Prepared()),
+        MakeAlternative(2, kStoreCount.Prepared()),
+    };
+
+    std::vector<uint8_t> image = TestImage::Build(TestImage::DefaultSections());
+    Plant(image, kLoadPointer.Prepared().view, 0x1100, 3, 7, OtherRva);
+    Plant(image, kLoadCount.Prepared().view, 0x1200, 2, 6, CountRva);
+    Plant(image, kStoreCount.Prepared().view, 0x1300, 2, 6, CountRva);
+
+    const std::vector<OffsetResolution> resolutions = Score(signatures, image);
+    CHECK(resolutions.size() == 1 && resolutions[0].found);
+    if (resolutions.empty()) return;
+    CHECK_EQ(resolutions[0].targetRva, CountRva);
+    CHECK_EQ(resolutions[0].signatureIndex, 1u);
+    CHECK_EQ(resolutions[0].siteRva, 0x1200u);
+    CHECK_EQ(resolutions[0].confidence, 33);
+}
+
+HALO_TEST("offset-profile", TieIsContested) {
+    const std::vector<OffsetSignature> signatures = {
+        MakeAlternative(0, kLoadCount.Prepared()),
+        MakeAlternative(1, kLoadPointer.Prepared()),
+    };
+
+    std::vector<uint8_t> image = TestImage::Build(TestImage::DefaultSections());
+    Plant(image, kLoadCount.Prepared().view, 0x1100, 2, 6, CountRva);
+    Plant(image, kLoadPointer.Prepared().view, 0x1300, 3, 7, OtherRva);
+
+    const std::vector<OffsetResolution> resolutions = Score(signatures, image);
+    CHECK(resolutions.size() == 1);
+    if (resolutions.empty()) return;
+    CHECK(!resolutions[0].found && resolutions[0].contested);
+    CHECK_EQ(resolutions[0].agreeing, 1u);
+    CHECK_EQ(resolutions[0].conflicting, 1u);
+    CHECK_EQ(resolutions[0].confidence, 0);
+}
+
+HALO_TEST("offset-profile", ConstraintsKeepBadAlternativesFromVoting) {
+    // La cuarta apunta a .rdata y pide .data: no resuelve, así que no cuenta como conflicto
+    const std::vector<OffsetSignature> signatures = {
+        MakeAlternative(0, kLoadCount.Prepared()),
+        MakeAlternative(1, kStoreCount.Prepared()),
+        MakeAlternative(2, kCompareCount.Prepared()),
+        MakeAlternative(3, kLoadPointer.Prepared()),
+    };
+
+    std::vector<uint8_t> image = TestImage::Build(TestImage::DefaultSections());
+    Plant(image, kLoadCount.Prepared().view, 0x1100, 2, 6, CountRva);
+    Plant(image, kStoreCount.Prepared().view, 0x1200, 2, 6, CountRva);
+    Plant(image, kCompareCount.Prepared().view, 0x1300, 2, 7, CountRva);
+    Plant(image, kLoadPointer.Prepared().view, 0x1400, 3, 7, ConstantRva);
+
+    const std::vector<OffsetResolution> resolutions = Score(signatures, image);
+    CHECK(resolutions.size() == 1 && resolutions[0].found);
+    if (resolutions.empty()) return;
+    CHECK_EQ(resolutions[0].targetRva, CountRva);
+    CHECK_EQ(resolutions[0].agreeing, 3u);
+    CHECK_EQ(resolutions[0].conflicting, 0u);
+    CHECK_EQ(resolutions[0].confidence, 100);
+}
+
+HALO_TEST("offset-profile", ComputeConfidenceScale) {
+    CHECK_EQ(OffsetScanCore::ComputeConfidence(1, 0), 50);
+    CHECK_EQ(OffsetScanCore::ComputeConfidence(2, 0), 100);
+    CHECK_EQ(OffsetScanCore::ComputeConfidence(2, 1), 33);
+    CHECK_EQ(OffsetScanCore::ComputeConfidence(3, 1), 50);
+    CHECK_EQ(OffsetScanCore::ComputeConfidence(1, 1), 0);
+    CHECK_EQ(OffsetScanCore::ComputeConfidence(0, 0), 0);
+}
+
+// ============================================================================
+// Firmas ancladas en cadena
+// ============================================================================
+
+namespace {
+
+// Patrón corto de ventana: sin el ancla, matchearía en cualquier sitio que cargue un int global
+constexpr auto kWindowLoad = MakeSignature("8B 05 ?? ?? ?? ?? 83 F8");
+
+const char* const AnchorText = "PlayerCountChanged: %d";
+const uint32_t AnchorRva = 0x2040;         // .rdata
+const uint32_t LeaRva = 0x1500;
+
+void PutBytes(std::vector<uint8_t>& image, uint32_t rva, std::initializer_list<uint8_t> bytes) {
+    for (uint8_t byte : bytes) image[rva++] = byte;
+}
+
+// lea rcx / mov rcx, [rip + destino] en siteRva
+void PutRcxReference(std::vector<uint8_t>& image, uint32_t siteRva, uint8_t opcode, uint32_t targetRva) {
+    PutBytes(image, siteRva, { 0x48, opcode, 0x0D });
+    TestImage::Put32(image, siteRva + 3, targetRva - (siteRva + 7));
+}
+
+// mov eax, [rip + destino] ; cmp eax, 1
+void PutLoad(std::vector<uint8_t>& image, uint32_t siteRva, uint32_t targetRva) {
+    PutBytes(image, siteRva, { 0x8B, 0x05 });
+    TestImage::Put32(image, siteRva + 2, targetRva - (siteRva + 6));
+    PutBytes(image, siteRva + 6, { 0x83, 0xF8, 0x01 });
+}
+
+OffsetSignature MakeAnchored(const char* anchor) {
+    OffsetSignature signature = MakeAlternative(0, kWindowLoad.Prepared());
+    signature.name = "Player count (cadena)";
+    signature.anchorString = anchor;
+    signature.windowBegin = -0x20;
+    signature.windowEnd = 0x40;
+    return signature;
+}
+
+// .rdata con la cadena; en .text el lea que la carga y, 0x10 después, el acceso al global.
+// Señuelos: el mismo acceso a otro global lejos de cualquier lea, y un mov (no lea) de la
+// cadena con otro acceso al lado
+std::vector<uint8_t> BuildAnchoredImage() {
+    // .text relleno de int3 (1 byte) para que el barrido lineal del XrefIndex no se desalinee
+    std::vector<uint8_t> image = TestImage::Build(TestImage::DefaultSections());
+    memset(&image[0x1000], 0xCC, 0x1000);
+    memcpy(&image[AnchorRva], AnchorText, strlen(AnchorText) + 1);
+
+    PutRcxReference(image, LeaRva, 0x8D, AnchorRva);
+    PutLoad(image, LeaRva + 0x10, CountRva);
+
+    PutLoad(image, 0x1800, OtherRva);
+    PutRcxReference(image, 0x1A00, 0x8B, AnchorRva);
+    PutLoad(image, 0x1A10, OtherRva);
+    return image;
+}
+
+} // namespace
+
+HALO_TEST("offset-profile", StringAnchoredSignatureResolvesGlobal) {
+    const std::vector<uint8_t> image = BuildAnchoredImage();
+    PEImage pe;
+    CHECK(pe.Parse(image.data(), image.size(), PEImage::Layout::MAPPED));
+
+    // Los índices ven la cadena y sus dos referencias (lea y mov)
+    StringIndex strings;
+    XrefIndex xrefs;
+    CHECK(strings.Build(pe) && xrefs.Build(pe));
+    std::vector<uint32_t> stringRvas;
+    strings.Find(AnchorText, stringRvas);
+    CHECK(stringRvas.size() == 1 && stringRvas[0] == AnchorRva);
+    CHECK_EQ(xrefs.FindReferencesTo(AnchorRva).Size(), 2u);
+
+    const std::vector<OffsetSignature> signatures = { MakeAnchored(AnchorText) };
+    CHECK(OffsetScanCore::HasStringAnchors(signatures, TITLE_MCC));
+
+    ScanOptions options;
+    options.deterministic = true;
+    const std::vector<OffsetMatch> matches = OffsetScanCore::ScanImage(signatures, pe, options, TITLE_MCC);
+    CHECK_EQ(matches.size(), 1u);
+    if (matches.empty()) return;
+
+    // Solo la ventana del lea: ni el acceso suelto ni el que va junto al mov
+    CHECK(matches[0].found && !matches[0].ambiguous);
+    CHECK_EQ(matches[0].matchCount, 1u);
+    CHECK_EQ(matches[0].siteRva, LeaRva + 0x10);
+    CHECK_EQ(matches[0].targetRva, CountRva);
+
+    const std::vector<OffsetResolution> resolutions = OffsetScanCore::ScoreMatches(signatures, matches);
+    CHECK(resolutions.size() == 1 && resolutions[0].found && resolutions[0].targetRva == CountRva);
+}
+
+HALO_TEST("offset-profile", StringAnchoredSignatureNeedsItsString) {
+    const std::vector<uint8_t> image = BuildAnchoredImage();
+    PEImage pe;
+    CHECK(pe.Parse(image.data(), image.size(), PEImage::Layout::MAPPED));
+
+    // Cadena que no está en la imagen, o solo un prefijo de la que sí: nada que resolver
+    const std::vector<OffsetSignature> signatures = { MakeAnchored("PlayerCountReset"), MakeAnchored("PlayerCount") };
+    ScanOptions options;
+    options.deterministic = true;
+    const std::vector<OffsetMatch> matches = OffsetScanCore::ScanImage(signatures, pe, options, TITLE_MCC);
+    CHECK_EQ(matches.size(), 2u);
+    for (const OffsetMatch& match : matches) CHECK(!match.found && match.matchCount == 0);
+}
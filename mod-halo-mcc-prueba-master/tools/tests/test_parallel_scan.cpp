@@ -0,0 +1,194 @@
+// test_parallel_scan.cpp
+// ParallelPatternScanner: modo determinista (1 worker, chunks en orden) y paralelo tienen que
+// dar exactamente lo mismo que el escaneo secuencial, también con matches que cruzan el
+// límite entre chunks o empiezan/acaban justo en él. Con cada backend que tenga la CPU
+#include "TestHarness.h"
+#include "HaloMCC_ParallelScan.h"
+#include "HaloMCC_PatternScanner.h"
+#include "HaloMCC_Signature.h"
+#include "HaloMCC_ThreadPool.h"
+
+namespace {
+
+constexpr auto kLoadGlobal = MakeSignature("48 8B 05 ?? ?? ?? ?? 48 85 C0");
+constexpr auto kCallPad = MakeSignature("E8 ?? ?? ?? ?? 90 CC CC");
+constexpr auto kMoveUps = MakeSignature("0F 10 05 ?? ?? ?? ?? 0F 11 01");
+
+const size_t ChunkSize = 4096;
+const size_t ImageSize = 16 * ChunkSize + 123;      // último chunk incompleto
+
+struct Planted {
+    size_t pattern;
+    size_t offset;
+};
+
+void Write(std::vector<uint8_t>& image, const PatternView& view, size_t offset, uint8_t wildcard) {
+    for (size_t i = 0; i < view.length; ++i) {
+        image[offset + i] = view.mask[i] ? view.bytes[i] : wildcard;
+    }
+}
+
+// Relleno con bytes que no aparecen en ninguna firma (0x20-0x3F) + near-misses (la firma
+// menos su último byte) para que los anclas salten por todo el buffer
+std::vector<uint8_t> BuildImage(const MultiPatternScanner& scanner, std::vector<Planted>& planted) {
+    std::vector<uint8_t> image(ImageSize);
+    uint32_t state = 0x9E3779B9;
+    for (uint8_t& byte : image) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = static_cast<uint8_t>(0x20 + (state & 0x1F));
+    }
+
+    for (size_t offset = 300; offset + 16 < ImageSize; offset += 997) {
+        const PatternView& view = scanner.GetPattern(offset % scanner.GetPatternCount()).view;
+        Write(image, view, offset, 0x33);
+        image[offset + view.length - 1] = 0x21;
+    }
+
+    // Por cada límite de chunk: uno que lo cruza, uno que empieza en él y uno que acaba en él
+    for (size_t boundary = ChunkSize; boundary < ImageSize; boundary += ChunkSize) {
+        const size_t id = (boundary / ChunkSize) % scanner.GetPatternCount();
+        const size_t length = scanner.GetPattern(id).view.length;
+        const size_t offsets[] = { boundary - 3, boundary + 40, boundary - length - 60 };
+        for (size_t offset : offsets) {
+            Write(image, scanner.GetPattern(id).view, offset, 0x2A);
+            planted.push_back(Planted{ id, offset });
+        }
+    }
+    Write(image, scanner.GetPattern(0).view, 0, 0x2A);
+    planted.push_back(Planted{ 0, 0 });
+    const size_t lastLength = scanner.GetPattern(1).view.length;
+    Write(image, scanner.GetPattern(1).view, ImageSize - lastLength, 0x2A);
+    planted.push_back(Planted{ 1, ImageSize - lastLength });
+    return image;
+}
+
+void BuildScanner(MultiPatternScanner& scanner) {
+    scanner.AddPattern(kLoadGlobal.Prepared());
+    scanner.AddPattern(kCallPad.Prepared());
+    scanner.AddPattern(kMoveUps.Prepared());
+}
+
+std::vector<ScanBackend> GetBackends() {
+    std::vector<ScanBackend> backends = { ScanBackend::SCALAR };
+    const ScanBackend best = PatternScanner::DetectBestBackend();
+    if (best == ScanBackend::SSE2 || best == ScanBackend::AVX2) backends.push_back(ScanBackend::SSE2);
+    if (best == ScanBackend::AVX2) backends.push_back(ScanBackend::AVX2);
+    return backends;
+}
+
+bool SameMatches(const std::vector<PatternMatches>& a, const std::vector<PatternMatches>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t id = 0; id < a.size(); ++id) {
+        if (a[id].count != b[id].count || a[id].candidates != b[id].candidates) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+HALO_TEST("parallel-scan", FindFirstAllMatchesSequentialAtChunkSeams) {
+    MultiPatternScanner scanner;
+    BuildScanner(scanner);
+    std::vector<Planted> planted;
+    const std::vector<uint8_t> image = BuildImage(scanner, planted);
+
+    std::vector<size_t> expected(scanner.GetPatternCount(), SIZE_MAX);
+    for (const Planted& match : planted) {
+        if (match.offset < expected[match.pattern]) expected[match.pattern] = match.offset;
+    }
+
+    ScanThreadPool pool(4);
+    const ScanBackend original = PatternScanner::GetBackend();
+    for (ScanBackend backend : GetBackends()) {
+        PatternScanner::SetBackend(backend);
+
+        std::vector<const uint8_t*> sequential(scanner.GetPatternCount(), nullptr);
+        CHECK_EQ(scanner.FindFirstAll(image.data(), image.size(), sequential), 0u);
+
+        ScanOptions deterministic;
+        deterministic.chunkSize = ChunkSize;
+        deterministic.deterministic = true;
+        std::vector<const uint8_t*> single;
+        CHECK_EQ(ParallelPatternScanner::FindFirstAll(image.data(), image.size(), scanner, deterministic, single), 0u);
+
+        ScanOptions parallel;
+        parallel.chunkSize = ChunkSize;
+        parallel.pool = &pool;
+        std::vector<const uint8_t*> multi;
+        CHECK_EQ(ParallelPatternScanner::FindFirstAll(image.data(), image.size(), scanner, parallel, multi), 0u);
+
+        CHECK(single == sequential);
+        CHECK(multi == sequential);
+        for (size_t id = 0; id < expected.size(); ++id) {
+            CHECK(multi[id] == image.data() + expected[id]);
+        }
+    }
+    PatternScanner::SetBackend(original);
+}
+
+HALO_TEST("parallel-scan", FindAllCountsSeamMatchesOnce) {
+    MultiPatternScanner scanner;
+    BuildScanner(scanner);
+    std::vector<Planted> planted;
+    const std::vector<uint8_t> image = BuildImage(scanner, planted);
+
+    std::vector<size_t> expectedCounts(scanner.GetPatternCount(), 0);
+    for (const Planted& match : planted) expectedCounts[match.pattern]++;
+
+    const size_t maxCandidates = 64;
+    ScanThreadPool pool(4);
+    const ScanBackend original = PatternScanner::GetBackend();
+    for (ScanBackend backend : GetBackends()) {
+        PatternScanner::SetBackend(backend);
+
+        std::vector<PatternMatches> sequential(scanner.GetPatternCount());
+        scanner.FindAll(image.data(), image.size(), sequential, maxCandidates);
+
+        ScanOptions deterministic;
+        deterministic.chunkSize = ChunkSize;
+        deterministic.deterministic = true;
+        std::vector<PatternMatches> single;
+        ParallelPatternScanner::FindAll(image.data(), image.size(), scanner, deterministic, single, maxCandidates);
+
+        ScanOptions parallel;
+        parallel.chunkSize = ChunkSize;
+        parallel.pool = &pool;
+        std::vector<PatternMatches> multi;
+        ParallelPatternScanner::FindAll(image.data(), image.size(), scanner, parallel, multi, maxCandidates);
+
+        CHECK(SameMatches(single, sequential));
+        CHECK(SameMatches(multi, sequential));
+        for (size_t id = 0; id < expectedCounts.size(); ++id) {
+            CHECK_EQ(multi[id].count, expectedCounts[id]);
+            for (size_t i = 1; i < multi[id].candidates.size(); ++i) {
+                CHECK(multi[id].candidates[i - 1] < multi[id].candidates[i]);
+            }
+        }
+    }
+    PatternScanner::SetBackend(original);
+}
+
+HALO_TEST("parallel-scan", TruncatedCandidateListsAgree) {
+    // Con menos candidatos que matches, todos los modos se quedan con los mismos (los primeros)
+    MultiPatternScanner scanner;
+    BuildScanner(scanner);
+    std::vector<Planted> planted;
+    const std::vector<uint8_t> image = BuildImage(scanner, planted);
+
+    ScanThreadPool pool(3);
+    ScanOptions deterministic;
+    deterministic.chunkSize = ChunkSize;
+    deterministic.deterministic = true;
+    ScanOptions parallel;
+    parallel.chunkSize = ChunkSize;
+    parallel.pool = &pool;
+
+    std::vector<PatternMatches> single;
+    std::vector<PatternMatches> multi;
+    ParallelPatternScanner::FindAll(image.data(), image.size(), scanner, deterministic, single, 4);
+    ParallelPatternScanner::FindAll(image.data(), image.size(), scanner, parallel, multi, 4);
+    CHECK(SameMatches(single, multi));
+    CHECK(multi[0].candidates.size() == 4 && multi[0].candidates[0] == image.data());
+}
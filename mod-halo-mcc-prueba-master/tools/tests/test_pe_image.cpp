@@ -0,0 +1,147 @@
+// test_pe_image.cpp
+// PEImage sobre buffers hechos a mano: cabeceras válidas, truncadas y corruptas
+#include "TestHarness.h"
+#include "TestImage.h"
+#include "HaloMCC_PEImage.h"
+
+namespace {
+
+bool ParseMapped(const std::vector<uint8_t>& image, size_t size) {
+    PEImage pe;
+    return pe.Parse(image.data(), size, PEImage::Layout::MAPPED);
+}
+
+} // namespace
+
+HALO_TEST("pe-image", ParsesSectionsAndHeaders) {
+    const std::vector<uint8_t> image = TestImage::Build(TestImage::DefaultSections(), 0x12345678);
+
+    PEImage pe;
+    CHECK(pe.Parse(image.data(), image.size(), PEImage::Layout::MAPPED));
+    CHECK(pe.IsValid());
+    CHECK(pe.Is64Bit());
+    CHECK_EQ(pe.GetTimeDateStamp(), 0x12345678u);
+    CHECK_EQ(pe.GetSizeOfImage(), 0x4000u);
+    CHECK_EQ(pe.GetSizeOfHeaders(), TestImage::HeadersSize);
+    CHECK_EQ(pe.GetImageBase(), 0x140000000ull);
+    CHECK_EQ(pe.GetSections().size(), 3u);
+
+    const PESection* text = pe.FindSection(".text");
+    const PESection* rdata = pe.FindSection(".rdata");
+    const PESection* data = pe.FindSection(".data");
+    CHECK(text && text->kind == SECTION_CODE && text->virtualAddress == 0x1000);
+    CHECK(rdata && rdata->kind == SECTION_RDATA);
+    CHECK(data && data->kind == SECTION_DATA);
+    CHECK(pe.FindSection(".reloc") == nullptr);
+
+    CHECK(pe.FindSectionByRva(0x2FFF) == rdata);
+    CHECK(pe.FindSectionByRva(0x4000) == nullptr);
+
+    size_t offset = 0;
+    CHECK(pe.RvaToOffset(0x3010, offset) && offset == 0x3010);
+    CHECK(!pe.RvaToOffset(0x4000, offset));
+
+    size_t size = 0;
+    CHECK(pe.GetSectionData(*text, size) == image.data() + 0x1000 && size == 0x1000);
+}
+
+HALO_TEST("pe-image", FileLayoutUsesRawOffsets) {
+    // Secciones empaquetadas en el fichero: .text en 0x400, .rdata en 0x600 (raw más corto)
+    std::vector<TestSection> sections = {
+        { ".text", 0x1000, 0x800, TestImage::Code, 0x400, 0x200 },
+        { ".rdata", 0x2000, 0x100, TestImage::ReadOnlyData, 0x600, 0x200 },
+    };
+    const std::vector<uint8_t> image = TestImage::Build(sections);
+
+    PEImage pe;
+    CHECK(pe.Parse(image.data(), image.size(), PEImage::Layout::FILE));
+
+    size_t offset = 0;
+    CHECK(pe.RvaToOffset(0x1010, offset) && offset == 0x410);
+    CHECK(!pe.RvaToOffset(0x1300, offset));            // más allá de los datos crudos
+    CHECK(pe.RvaToOffset(0x2020, offset) && offset == 0x620);
+
+    uint32_t rva = 0;
+    CHECK(pe.OffsetToRva(0x610, rva) && rva == 0x2010);
+
+    const PESection* text = pe.FindSection(".text");
+    CHECK(text && pe.GetSectionSize(*text) == 0x200);
+}
+
+HALO_TEST("pe-image", ZeroVirtualSizeFallsBackToRaw) {
+    std::vector<TestSection> sections = { { ".text", 0x1000, 0, TestImage::Code, 0x1000, 0x300 } };
+    const std::vector<uint8_t> image = TestImage::Build(sections);
+
+    PEImage pe;
+    CHECK(pe.Parse(image.data(), image.size(), PEImage::Layout::MAPPED));
+    CHECK(!pe.GetSections().empty() && pe.GetSections()[0].virtualSize == 0x300);
+}
+
+HALO_TEST("pe-image", RejectsEveryTruncationOfTheHeaders) {
+    const std::vector<TestSection> sections = TestImage::DefaultSections();
+    const std::vector<uint8_t> image = TestImage::Build(sections);
+    const uint32_t tableEnd = TestImage::GetSectionTableEnd(sections.size());
+
+    // Cualquier corte antes del final de la tabla de secciones tiene que fallar sin leer fuera
+    size_t accepted = 0;
+    for (size_t size = 0; size < tableEnd; ++size) {
+        if (ParseMapped(image, size)) accepted++;
+    }
+    CHECK_EQ(accepted, 0u);
+    CHECK(ParseMapped(image, tableEnd));
+}
+
+HALO_TEST("pe-image", RejectsMalformedHeaders) {
+    const std::vector<uint8_t> valid = TestImage::Build(TestImage::DefaultSections());
+    CHECK(ParseMapped(valid, valid.size()));
+
+    PEImage pe;
+    CHECK(!pe.Parse(nullptr, 0x1000, PEImage::Layout::MAPPED));
+
+    std::vector<uint8_t> image = valid;
+    image[0] = 'X';                                                     // sin MZ
+    CHECK(!ParseMapped(image, image.size()));
+
+    image = valid;
+    TestImage::Put32(image, 0x3C, 0xFFFFFFF0);                          // e_lfanew fuera del buffer
+    CHECK(!ParseMapped(image, image.size()));
+
+    image = valid;
+    TestImage::Put32(image, TestImage::NtOffset, 0x00004551);           // firma NT rota
+    CHECK(!ParseMapped(image, image.size()));
+
+    image = valid;
+    TestImage::Put16(image, TestImage::NtOffset + 6, 0);                // sin secciones
+    CHECK(!ParseMapped(image, image.size()));
+
+    image = valid;
+    TestImage::Put16(image, TestImage::NtOffset + 6, 97);               // más de las que acepta
+    CHECK(!ParseMapped(image, image.size()));
+
+    image = valid;
+    TestImage::Put16(image, TestImage::NtOffset + 6, 96);               // el máximo, pero la tabla no cabe
+    image.resize(TestImage::HeadersSize);
+    CHECK(!ParseMapped(image, image.size()));
+
+    image = valid;
+    TestImage::Put16(image, TestImage::OptionalHeaderOffset, 0x30B);    // magic desconocido
+    CHECK(!ParseMapped(image, image.size()));
+
+    image = valid;
+    TestImage::Put16(image, TestImage::NtOffset + 20, 0xFFFF);          // SizeOfOptionalHeader enorme
+    CHECK(!ParseMapped(image, image.size()));
+}
+
+HALO_TEST("pe-image", ClampsDirectoryCount) {
+    std::vector<uint8_t> image = TestImage::Build(TestImage::DefaultSections());
+    TestImage::Put32(image, TestImage::OptionalHeaderOffset + 108, 0x7FFFFFFF);
+    // Directorio de relocs: 6ª entrada
+    TestImage::Put32(image, TestImage::OptionalHeaderOffset + 112 + PEImage::DirectoryBaseRelocation * 8, 0x3000);
+    TestImage::Put32(image, TestImage::OptionalHeaderOffset + 116 + PEImage::DirectoryBaseRelocation * 8, 0x40);
+
+    PEImage pe;
+    CHECK(pe.Parse(image.data(), image.size(), PEImage::Layout::MAPPED));
+    uint32_t rva = 0, size = 0;
+    CHECK(pe.GetDataDirectory(PEImage::DirectoryBaseRelocation, rva, size) && rva == 0x3000 && size == 0x40);
+    CHECK(!pe.GetDataDirectory(PEImage::MaxDirectories, rva, size));
+}
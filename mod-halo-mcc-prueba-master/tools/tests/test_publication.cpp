@@ -0,0 +1,167 @@
+// test_publication.cpp
+// SeqLock y TripleBuffer: ida y vuelta en un hilo y, con un escritor sin parar, que el lector
+// nunca vea un valor mezclado de dos publicaciones ni vaya hacia atrás
+#include "TestHarness.h"
+#include "HaloMCC_SeqLock.h"
+#include "HaloMCC_TripleBuffer.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Más grande que una palabra y con tamaño que no es múltiplo de 8, para que la copia se parta
+struct Sample {
+    uint64_t words[5];
+    uint32_t tail;
+};
+
+Sample MakeSample(uint64_t value) {
+    Sample sample;
+    for (uint64_t& word : sample.words) word = value;
+    sample.tail = static_cast<uint32_t>(value);
+    return sample;
+}
+
+bool IsWhole(const Sample& sample) {
+    for (uint64_t word : sample.words) {
+        if (word != sample.words[0]) return false;
+    }
+    return sample.tail == static_cast<uint32_t>(sample.words[0]);
+}
+
+const uint64_t WriteCount = 200000;
+
+} // namespace
+
+HALO_TEST("publication", SeqLockRoundTrip) {
+    SeqLock<Sample> lock;
+    Sample value = MakeSample(99);
+
+    // Sin publicar: versión 0 y valor por defecto
+    CHECK_EQ(lock.GetVersion(), 0u);
+    CHECK_EQ(lock.Load(value), 0u);
+    CHECK(IsWhole(value) && value.words[0] == 0);
+
+    lock.Store(MakeSample(7));
+    CHECK_EQ(lock.GetVersion(), 1u);
+    CHECK_EQ(lock.Load(value), 1u);
+    CHECK(IsWhole(value) && value.words[0] == 7);
+
+    CHECK(lock.TryStore(MakeSample(8)));
+    CHECK_EQ(lock.Load(value), 2u);
+    CHECK(value.words[0] == 8 && value.tail == 8);
+    CHECK(lock.Load().words[4] == 8);
+}
+
+HALO_TEST("publication", SeqLockReadersNeverSeeTornValues) {
+    SeqLock<Sample> lock;
+    std::atomic<bool> done{ false };
+    std::atomic<uint64_t> torn{ 0 }, backwards{ 0 }, reads{ 0 };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&]() {
+            uint64_t lastVersion = 0, lastValue = 0;
+            Sample value;
+            while (!done.load(std::memory_order_acquire)) {
+                const uint64_t version = lock.Load(value);
+                if (!IsWhole(value)) torn++;
+                // Una sola store por versión: el valor publicado es siempre el número de versión
+                if (version < lastVersion || value.words[0] < lastValue || value.words[0] != version) backwards++;
+                lastVersion = version;
+                lastValue = value.words[0];
+                reads++;
+            }
+        });
+    }
+
+    for (uint64_t i = 1; i <= WriteCount; ++i) lock.Store(MakeSample(i));
+    done.store(true, std::memory_order_release);
+    for (std::thread& reader : readers) reader.join();
+
+    CHECK_EQ(torn.load(), 0u);
+    CHECK_EQ(backwards.load(), 0u);
+    CHECK(reads.load() > 0);
+    CHECK_EQ(lock.Load().words[0], WriteCount);
+}
+
+HALO_TEST("publication", SeqLockTryStoreFromSeveralWriters) {
+    // Varios escritores con TryStore: los que pierden descartan su valor, pero cada versión
+    // sigue siendo una publicación entera y se cuentan todas
+    SeqLock<Sample> lock;
+    std::atomic<uint64_t> stored{ 0 }, torn{ 0 };
+
+    std::vector<std::thread> writers;
+    for (uint64_t w = 1; w <= 4; ++w) {
+        writers.emplace_back([&, w]() {
+            for (uint64_t i = 0; i < WriteCount / 4; ++i) {
+                if (lock.TryStore(MakeSample(w << 32 | i))) stored++;
+                if (!IsWhole(lock.Load())) torn++;
+            }
+        });
+    }
+    for (std::thread& writer : writers) writer.join();
+
+    CHECK_EQ(torn.load(), 0u);
+    CHECK(stored.load() > 0);
+    CHECK_EQ(lock.GetVersion(), stored.load());
+}
+
+HALO_TEST("publication", TripleBufferRoundTrip) {
+    TripleBuffer<Sample> buffer;
+
+    // Nada publicado: el lector ve el valor por defecto y Update no cambia nada
+    CHECK(!buffer.Update());
+    CHECK(IsWhole(buffer.Read()) && buffer.Read().words[0] == 0);
+
+    buffer.Write(MakeSample(1));
+    CHECK(buffer.Update());
+    CHECK(!buffer.Update());
+    CHECK_EQ(buffer.Read().words[0], 1u);
+
+    // Varias publicaciones seguidas: el lector solo ve la última
+    buffer.Write(MakeSample(2));
+    buffer.Write(MakeSample(3));
+    Sample& slot = buffer.GetWriteBuffer();
+    slot = MakeSample(4);
+    buffer.Publish();
+    CHECK(IsWhole(buffer.Read()) && buffer.Read().words[0] == 4);
+
+    // El buffer del escritor nunca es el que está leyendo el lector
+    const Sample& front = buffer.Read();
+    buffer.GetWriteBuffer() = MakeSample(5);
+    CHECK_EQ(front.words[0], 4u);
+    buffer.Publish();
+    CHECK_EQ(front.words[0], 4u);
+    CHECK_EQ(buffer.Read().words[0], 5u);
+}
+
+HALO_TEST("publication", TripleBufferReaderSeesWholeIncreasingValues) {
+    TripleBuffer<Sample> buffer;
+    std::atomic<bool> done{ false };
+    uint64_t torn = 0, backwards = 0, updates = 0;
+
+    std::thread reader([&]() {
+        uint64_t last = 0;
+        for (;;) {
+            const bool finished = done.load(std::memory_order_acquire);
+            if (buffer.Update()) updates++;
+            const Sample& value = buffer.Read();
+            if (!IsWhole(value)) torn++;
+            if (value.words[0] < last) backwards++;
+            last = value.words[0];
+            if (finished) break;
+        }
+    });
+
+    for (uint64_t i = 1; i <= WriteCount; ++i) buffer.Write(MakeSample(i));
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    CHECK_EQ(torn, 0u);
+    CHECK_EQ(backwards, 0u);
+    CHECK(updates > 0);
+    // Tras acabar el escritor, la última lectura es la última publicación
+    CHECK_EQ(buffer.Read().words[0], WriteCount);
+}
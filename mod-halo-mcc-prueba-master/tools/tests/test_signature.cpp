@@ -0,0 +1,69 @@
+// test_signature.cpp
+// MakeSignature: el parseo en compilación (static_assert) y, con la misma clase en tiempo de
+// ejecución, que las firmas mal escritas se rechazan
+#include "TestHarness.h"
+#include "HaloMCC_Signature.h"
+#include <string>
+
+namespace {
+
+constexpr auto kSplitScreen = MakeSignature("83 3D ?? ?? ?? ?? 01 0F 84");
+constexpr auto kMixed = MakeSignature("e8 ? ?? AB  cd");
+
+static_assert(kSplitScreen.Length() == 9, "9 bytes");
+static_assert(kSplitScreen.ByteAt(0) == 0x83 && kSplitScreen.ByteAt(8) == 0x84, "bytes fijos");
+static_assert(kSplitScreen.IsWildcard(2) && kSplitScreen.IsWildcard(5) && !kSplitScreen.IsWildcard(6), "wildcards");
+static_assert(kMixed.Length() == 5 && kMixed.ByteAt(0) == 0xE8 && kMixed.ByteAt(4) == 0xCD, "minúsculas y '?' suelto");
+static_assert(kMixed.IsWildcard(1) && kMixed.IsWildcard(2) && !kMixed.IsWildcard(3), "wildcards de uno y dos caracteres");
+
+// Las anclas que se guardan en compilación son las mismas que elegiría Prepare
+constexpr PreparedPattern kPrepared = kSplitScreen.Prepared();
+constexpr PreparedPattern kReference = PatternScanner::Prepare(kSplitScreen.View());
+static_assert(kPrepared.hasAnchor, "ancla");
+static_assert(kPrepared.anchorIndex == kReference.anchorIndex && kPrepared.anchor2Index == kReference.anchor2Index,
+              "anclas de compilación = anclas de Prepare");
+static_assert(kPrepared.anchorIndex != kPrepared.anchor2Index, "dos anclas distintas");
+static_assert(!kSplitScreen.IsWildcard(kPrepared.anchorIndex) && !kSplitScreen.IsWildcard(kPrepared.anchor2Index),
+              "las anclas son bytes fijos");
+
+// Fuera de constexpr el mismo constructor lanza el mensaje que en compilación es un error
+const char* ParseError(const char* text) {
+    try {
+        Signature<32> signature(text);
+        (void)signature;
+        return nullptr;
+    }
+    catch (const char* message) {
+        return message;
+    }
+}
+
+} // namespace
+
+HALO_TEST("signature", PreparedMatchesRuntimeScan) {
+    const uint8_t code[] = { 0x90, 0x90, 0x83, 0x3D, 0x11, 0x22, 0x33, 0x44, 0x01, 0x0F, 0x84, 0xCC };
+    const PreparedPattern prepared = kSplitScreen.Prepared();
+
+    CHECK(prepared.anchorByte == kSplitScreen.ByteAt(prepared.anchorIndex));
+    CHECK(prepared.anchor2Byte == kSplitScreen.ByteAt(prepared.anchor2Index));
+    CHECK(prepared.view.length == kSplitScreen.Length());
+    CHECK(PatternScanner::FindFirst(code, sizeof(code), prepared) == code + 2);
+    CHECK(PatternScanner::MatchAt(code + 2, kSplitScreen.View()));
+    CHECK(!PatternScanner::MatchAt(code + 1, kSplitScreen.View()));
+}
+
+HALO_TEST("signature", RejectsMalformedText) {
+    CHECK(ParseError("48 8B 05") == nullptr);
+    CHECK(ParseError("") != nullptr);                   // vacía
+    CHECK(ParseError("   ") != nullptr);
+    CHECK(ParseError("?? ?? ??") != nullptr);           // sin bytes fijos
+    CHECK(ParseError("48 8G") != nullptr);              // hex no válido
+    CHECK(ParseError("48 8") != nullptr);               // medio byte
+    CHECK(ParseError("488B") != nullptr);               // sin separador
+    CHECK(ParseError("48 ??05") != nullptr);
+
+    // Más bytes que la capacidad
+    std::string longText;
+    for (int i = 0; i < 33; ++i) longText += "90 ";
+    CHECK(ParseError(longText.c_str()) != nullptr);
+}
@@ -0,0 +1,149 @@
+// test_x86_decoder.cpp
+// Longitudes de X86Decoder (prefijos, REX, VEX, mapas 0F38/0F3A, SIB, inmediatos) y
+// ResolveRipOperand sobre secuencias de instrucciones conocidas
+#include "TestHarness.h"
+#include "HaloMCC_X86Decoder.h"
+#include <initializer_list>
+#include <vector>
+
+namespace {
+
+struct Expected {
+    std::vector<uint8_t> code;
+    uint8_t length;
+    uint8_t opcodeMap;
+    bool ripRelative;
+};
+
+bool DecodeAll(const std::vector<uint8_t>& code, X86Instruction& instruction) {
+    return X86Decoder::Decode(code.data(), code.size(), instruction);
+}
+
+void CheckTable(std::initializer_list<Expected> table) {
+    for (const Expected& expected : table) {
+        X86Instruction instruction;
+        const bool decoded = DecodeAll(expected.code, instruction);
+        CHECK(decoded);
+        if (!decoded) continue;
+        CHECK_EQ(instruction.length, expected.length);
+        CHECK_EQ(instruction.opcodeMap, expected.opcodeMap);
+        CHECK_EQ(instruction.ripRelative, expected.ripRelative);
+        if (instruction.length != expected.length) {
+            printf("      opcode %02X: longitud %u, esperada %u\n", expected.code.back(), instruction.length, expected.length);
+        }
+    }
+}
+
+} // namespace
+
+HALO_TEST("x86-decoder", LegacyPrefixesAndRex) {
+    CheckTable({
+        { { 0x90 }, 1, 0, false },                                              // nop
+        { { 0x66, 0x90 }, 2, 0, false },                                        // xchg ax,ax
+        { { 0xF3, 0x48, 0xAB }, 3, 0, false },                                  // rep stosq
+        { { 0x48, 0x8B, 0x05, 0x44, 0x33, 0x22, 0x11 }, 7, 0, true },           // mov rax,[rip+d]
+        { { 0x4C, 0x8D, 0x0D, 0, 0, 0, 0 }, 7, 0, true },                       // lea r9,[rip+d]
+        { { 0x83, 0x3D, 0, 0, 0, 0, 0x01 }, 7, 0, true },                       // cmp dword [rip+d],1
+        { { 0x66, 0x81, 0x3D, 0, 0, 0, 0, 0x34, 0x12 }, 9, 0, true },           // cmp word [rip+d],imm16
+        { { 0x48, 0xC7, 0x05, 0, 0, 0, 0, 1, 0, 0, 0 }, 11, 0, true },          // mov qword [rip+d],imm32
+        { { 0x48, 0xB8, 1, 2, 3, 4, 5, 6, 7, 8 }, 10, 0, false },              // mov rax,imm64
+        { { 0x41, 0xB8, 1, 2, 3, 4 }, 6, 0, false },                            // mov r8d,imm32
+        { { 0x8B, 0x04, 0x24 }, 3, 0, false },                                  // mov eax,[rsp]
+        { { 0x8B, 0x44, 0x24, 0x08 }, 4, 0, false },                            // mov eax,[rsp+8]
+        { { 0x8B, 0x84, 0x24, 0, 1, 0, 0 }, 7, 0, false },                      // mov eax,[rsp+disp32]
+        { { 0x8B, 0x04, 0x25, 0, 0x10, 0, 0 }, 7, 0, false },                   // mov eax,[disp32] (SIB, no RIP)
+        { { 0xF6, 0x05, 0, 0, 0, 0, 0x01 }, 7, 0, true },                       // test byte [rip+d],1 (grupo 3)
+        { { 0xE8, 0, 0, 0, 0 }, 5, 0, false },                                  // call rel32
+        { { 0xEB, 0x10 }, 2, 0, false },                                        // jmp rel8
+    });
+
+    X86Instruction store;
+    CHECK(DecodeAll({ 0x48, 0xC7, 0x05, 0x10, 0, 0, 0, 1, 0, 0, 0 }, store));
+    CHECK_EQ(store.displacementOffset, 3u);
+    CHECK_EQ(store.displacement, 0x10);
+    CHECK_EQ(store.immediateOffset, 7u);
+    CHECK_EQ(store.immediateSize, 4u);
+    // El destino es relativo al final de la instrucción, inmediato incluido
+    CHECK_EQ(X86Decoder::GetRipTarget(0x1000, store), 0x1000u + 11 + 0x10);
+
+    X86Instruction call;
+    CHECK(DecodeAll({ 0xE8, 0xFB, 0xFF, 0xFF, 0xFF }, call));
+    CHECK(call.relativeBranch);
+    CHECK_EQ(X86Decoder::GetBranchTarget(0x2000, call), 0x2000u);
+}
+
+HALO_TEST("x86-decoder", TwoAndThreeByteMaps) {
+    CheckTable({
+        { { 0x0F, 0x84, 0, 0, 0, 0 }, 6, 1, false },                            // je rel32
+        { { 0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00 }, 6, 1, false },                // nop word [rax+rax]
+        { { 0x0F, 0x1F, 0x84, 0, 0, 0, 0, 0 }, 8, 1, false },                   // nop dword [rax+rax+0]
+        { { 0xF3, 0x0F, 0x10, 0x05, 0, 0, 0, 0 }, 8, 1, true },                 // movss xmm0,[rip+d]
+        { { 0x0F, 0x10, 0x05, 0, 0, 0, 0 }, 7, 1, true },                       // movups xmm0,[rip+d]
+        { { 0x66, 0x0F, 0x38, 0x00, 0xC1 }, 5, 2, false },                      // pshufb xmm0,xmm1
+        { { 0x66, 0x0F, 0x38, 0x00, 0x05, 0, 0, 0, 0 }, 9, 2, true },           // pshufb xmm0,[rip+d]
+        { { 0x66, 0x0F, 0x3A, 0x0F, 0xC1, 0x08 }, 6, 3, false },                // palignr xmm0,xmm1,8
+        { { 0x66, 0x0F, 0x3A, 0x0F, 0x05, 0, 0, 0, 0, 0x08 }, 10, 3, true },    // palignr xmm0,[rip+d],8
+        { { 0x66, 0x48, 0x0F, 0x3A, 0x16, 0xC0, 0x01 }, 7, 3, false },          // pextrq rax,xmm0,1
+    });
+
+    // 0F3A con RIP: el imm8 va detrás del disp y cuenta para el destino
+    X86Instruction palignr;
+    CHECK(DecodeAll({ 0x66, 0x0F, 0x3A, 0x0F, 0x05, 0x20, 0, 0, 0, 0x08 }, palignr));
+    CHECK_EQ(palignr.immediateSize, 1u);
+    CHECK_EQ(X86Decoder::GetRipTarget(0x5000, palignr), 0x5000u + 10 + 0x20);
+}
+
+HALO_TEST("x86-decoder", VexEncodings) {
+    CheckTable({
+        { { 0xC5, 0xFC, 0x77 }, 3, 1, false },                                  // vzeroall
+        { { 0xC5, 0xF8, 0x10, 0x05, 0, 0, 0, 0 }, 8, 1, true },                 // vmovups xmm0,[rip+d]
+        { { 0xC5, 0xFD, 0x6F, 0xC1 }, 4, 1, false },                            // vmovdqa ymm0,ymm1
+        { { 0xC4, 0xE2, 0x79, 0x18, 0x05, 0, 0, 0, 0 }, 9, 2, true },           // vbroadcastss xmm0,[rip+d]
+        { { 0xC4, 0xE2, 0x7D, 0x00, 0xC1 }, 5, 2, false },                      // vpshufb ymm0,ymm0,ymm1
+        { { 0xC4, 0xE3, 0x79, 0x0F, 0xC1, 0x08 }, 6, 3, false },                // vpalignr xmm0,xmm0,xmm1,8
+        { { 0xC4, 0xE3, 0x7D, 0x18, 0x05, 0, 0, 0, 0, 0x01 }, 10, 3, true },    // vinsertf128 ymm0,ymm0,[rip+d],1
+    });
+}
+
+HALO_TEST("x86-decoder", RejectsInvalidOrTruncated) {
+    X86Instruction instruction;
+    CHECK(!DecodeAll({ 0x06 }, instruction));                                  // push es: no existe en 64 bits
+    CHECK(!DecodeAll({ 0x48, 0x8B, 0x05, 0x44 }, instruction));                // disp a medias
+    CHECK(!DecodeAll({ 0x0F }, instruction));
+    CHECK(!DecodeAll({ 0x66, 0x0F, 0x3A, 0x0F, 0xC1 }, instruction));          // falta el imm8
+    CHECK(!DecodeAll({ 0xC4, 0xE2 }, instruction));                            // VEX cortado
+    CHECK(!DecodeAll({ 0x48 }, instruction));                                  // solo REX
+    CHECK(!X86Decoder::Decode(nullptr, 0, instruction));
+
+    // Más de 15 bytes de prefijos: no es una instrucción
+    std::vector<uint8_t> prefixes(15, 0x66);
+    prefixes.push_back(0x90);
+    CHECK(!DecodeAll(prefixes, instruction));
+}
+
+HALO_TEST("x86-decoder", ResolveRipOperandWalksInstructions) {
+    // mov rax,[rip+0x100] ; test rax,rax ; lea rcx,[rip-0x20] ; call rel32
+    const std::vector<uint8_t> code = {
+        0x48, 0x8B, 0x05, 0x00, 0x01, 0x00, 0x00,
+        0x48, 0x85, 0xC0,
+        0x48, 0x8D, 0x0D, 0xE0, 0xFF, 0xFF, 0xFF,
+        0xE8, 0x00, 0x00, 0x00, 0x00,
+    };
+    const uint64_t address = 0x140001000ull;
+
+    uint64_t target = 0;
+    CHECK(X86Decoder::ResolveRipOperand(code.data(), code.size(), code.size(), address, 0, target));
+    CHECK_EQ(target, address + 7 + 0x100);
+    CHECK(X86Decoder::ResolveRipOperand(code.data(), code.size(), code.size(), address, 1, target));
+    CHECK_EQ(target, address + 17 - 0x20);
+    CHECK(!X86Decoder::ResolveRipOperand(code.data(), code.size(), code.size(), address, 2, target));
+
+    // El lea empieza en el byte 10: con span 10 ya no entra, con span 11 sí (se decodifica entera)
+    CHECK(!X86Decoder::ResolveRipOperand(code.data(), code.size(), 10, address, 1, target));
+    CHECK(X86Decoder::ResolveRipOperand(code.data(), code.size(), 11, address, 1, target));
+    CHECK_EQ(target, address + 17 - 0x20);
+
+    // Una instrucción que no se puede decodificar corta el recorrido
+    const std::vector<uint8_t> broken = { 0x06, 0x48, 0x8B, 0x05, 0, 0, 0, 0 };
+    CHECK(!X86Decoder::ResolveRipOperand(broken.data(), broken.size(), broken.size(), address, 0, target));
+}